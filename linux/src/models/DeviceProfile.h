@@ -0,0 +1,52 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef DEVICEPROFILE_H
+#define DEVICEPROFILE_H
+
+#include "models/SerialPort.h"
+#include "protocol/ESP32Chip.h"
+
+#include <QString>
+#include <QDateTime>
+
+/**
+ * What worked the last time a device was flashed
+ * Keyed by USB serial number so that repeat boards on a fixture
+ * can take the fast path straight away.
+ */
+struct DeviceProfile {
+    QString serialNumber;
+
+    /// Chip family identified after sync
+    ESP32ChipFamily chip = ESP32ChipFamily::Unknown;
+
+    /// Reset sequence that got the chip into download mode
+    ResetStrategy resetStrategy = ResetStrategy::Classic;
+
+    /// True if sync only succeeded after closing and reopening the port
+    bool needsReopen = false;
+
+    /// Highest baud rate that completed a flash without errors
+    BaudRate bestBaudRate = BaudRate::Baud115200;
+
+    /// True if a faster rate failed, making bestBaudRate a ceiling
+    bool baudLimited = false;
+
+    /// Factor applied to the reset sequence's waits
+    double resetTimingScale = 1.0;
+
+    /// Time from the end of the reset sequence to the first SYNC response
+    int readyMs = 0;
+
+    /// Number of SYNC attempts the last successful connection needed
+    int syncAttempts = 1;
+
+    /// Calibrated flash erase rate in ms per 4 KB sector (0 = not measured)
+    double eraseMsPerSector = 0.0;
+
+    QDateTime lastSeen;
+};
+
+#endif // DEVICEPROFILE_H
@@ -113,6 +113,17 @@ FirmwareFile FirmwareFile::loadFromFile(const QString& filePath)
     return FirmwareFile(filePath, data);
 }
 
+FirmwareFile FirmwareFile::withBootloaderOffset(uint32_t bootloaderOffset) const
+{
+    std::vector<FirmwareImage> images = m_images;
+    for (auto& image : images) {
+        if (image.offset == 0x0000 && image.fileName() == "bootloader.bin") {
+            image.offset = bootloaderOffset;
+        }
+    }
+    return FirmwareFile(images);
+}
+
 int FirmwareFile::totalSize() const
 {
     int total = 0;
@@ -141,6 +152,38 @@ QString FirmwareFile::fileName() const
     return m_images.empty() ? "No firmware" : m_images[0].fileName();
 }
 
+QString FirmwareFile::elfPath() const
+{
+    if (m_images.empty()) {
+        return QString();
+    }
+
+    QString appPath = m_images[0].filePath;
+    for (const auto& image : m_images) {
+        if (image.offset == 0x10000) {
+            appPath = image.filePath;
+        }
+    }
+
+    // ESP-IDF: build/<project>.bin beside build/<project>.elf
+    // PlatformIO: firmware.bin (or firmware-merged.bin) beside firmware.elf
+    QFileInfo app(appPath);
+    QDir dir = app.dir();
+    const QString candidates[] = {
+        app.completeBaseName() + ".elf",
+        "firmware.elf"
+    };
+    for (const QString& name : candidates) {
+        if (QFile::exists(dir.filePath(name))) {
+            return dir.filePath(name);
+        }
+    }
+
+    // Otherwise only an unambiguous one
+    const QStringList elfs = dir.entryList(QStringList{"*.elf"}, QDir::Files);
+    return elfs.size() == 1 ? dir.filePath(elfs.first()) : QString();
+}
+
 QString FirmwareFile::sizeDescription() const
 {
     qint64 bytes = totalSize();
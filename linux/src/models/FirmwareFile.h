@@ -107,6 +107,13 @@ public:
     QString fileName() const;
     QString sizeDescription() const;
 
+    /**
+     * ELF the app image was built from, for symbolizing crashes
+     * Looks next to the app .bin the way PlatformIO and ESP-IDF lay out
+     * their build directories; empty if there isn't one.
+     */
+    QString elfPath() const;
+
     /**
      * Check if the firmware package is valid
      * All images must be valid
@@ -125,6 +132,12 @@ public:
 
     bool isEmpty() const { return m_images.empty(); }
 
+    /**
+     * Copy with a separate bootloader.bin moved to the chip's bootloader offset
+     * (0x1000 on ESP32/ESP32-S2, 0x0 elsewhere). Merged images are left alone.
+     */
+    FirmwareFile withBootloaderOffset(uint32_t bootloaderOffset) const;
+
 private:
     std::vector<FirmwareImage> m_images;
 };
@@ -0,0 +1,142 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef FLASHREPORT_H
+#define FLASHREPORT_H
+
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <map>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Outcome of one flash run, including how hard the link had to work
+ * A run that succeeded only after many retries points at a marginal
+ * cable, fixture or USB hub even though the board flashed fine.
+ */
+struct FlashReport {
+    QString serialNumber;
+    QString chipName;
+    int baudRate = 115200;
+
+    bool success = false;
+    QString errorMessage;
+
+    QDateTime startedAt;
+    qint64 durationMs = 0;
+
+    /// Data blocks in the firmware, and FLASH_DATA commands actually sent
+    int blocksTotal = 0;
+    int blocksSent = 0;
+
+    /// Blocks resent after the ROM rejected them (bad checksum etc.)
+    int retransmissions = 0;
+
+    /// Times the session was resynced and resumed with a new FLASH_BEGIN
+    int resyncs = 0;
+
+    /// Bytes skipped because an interrupted earlier flash had written and
+    /// verified them already
+    uint32_t resumedBytes = 0;
+
+    /// Retries per block, keyed by the block's flash address
+    std::map<uint32_t, int> blockRetries;
+
+    /// UART errors the driver counted on our side of the link during the
+    /// run (TIOCGICOUNT); lineErrorsCounted is false if it keeps no counts
+    bool lineErrorsCounted = false;
+    uint64_t frameErrors = 0;
+    uint64_t overruns = 0;          // UART FIFO
+    uint64_t parityErrors = 0;
+    uint64_t bufferOverruns = 0;    // Kernel tty buffer
+
+    /// Rates the run stepped down to after errors, in order; baudRate is
+    /// the last one
+    std::vector<int> baudDowngrades;
+
+    /**
+     * Time spent in one flash plan op
+     */
+    struct OpTiming {
+        QString op;
+        qint64 ms = 0;
+        int attempts = 1;
+    };
+
+    /// Per-op timings, in execution order
+    std::vector<OpTiming> opTimings;
+
+    int totalRetries() const {
+        int total = 0;
+        for (const auto& entry : blockRetries) {
+            total += entry.second;
+        }
+        return total;
+    }
+
+    int maxRetriesPerBlock() const {
+        int most = 0;
+        for (const auto& entry : blockRetries) {
+            most = qMax(most, entry.second);
+        }
+        return most;
+    }
+
+    uint64_t lineErrors() const {
+        return frameErrors + overruns + parityErrors + bufferOverruns;
+    }
+
+    /**
+     * One-line summary, e.g. "3 retries (1 resync), worst block 0x00012000 x2;
+     * 14 line errors (12 framing, 2 overrun); stepped down to 460800"
+     */
+    QString summary() const {
+        QString text = retrySummary();
+        if (lineErrors() > 0) {
+            QStringList kinds;
+            const std::pair<uint64_t, const char*> counts[] = {
+                {frameErrors, "framing"}, {overruns, "overrun"},
+                {parityErrors, "parity"}, {bufferOverruns, "buffer overrun"},
+            };
+            for (const auto& count : counts) {
+                if (count.first > 0) {
+                    kinds.append(QString("%1 %2").arg(count.first).arg(count.second));
+                }
+            }
+            text += QString("; %1 line errors (%2)").arg(lineErrors()).arg(kinds.join(", "));
+        }
+        if (!baudDowngrades.empty()) {
+            text += QString("; stepped down to %1").arg(baudDowngrades.back());
+        }
+        return text;
+    }
+
+    /**
+     * e.g. "3 retries (1 resync), worst block 0x00012000 x2"
+     */
+    QString retrySummary() const {
+        if (blockRetries.empty()) {
+            return "No retries";
+        }
+
+        uint32_t worstAddress = 0;
+        int worst = 0;
+        for (const auto& entry : blockRetries) {
+            if (entry.second > worst) {
+                worst = entry.second;
+                worstAddress = entry.first;
+            }
+        }
+
+        return QString("%1 retries (%2 resyncs), worst block 0x%3 x%4")
+            .arg(totalRetries())
+            .arg(resyncs)
+            .arg(worstAddress, 8, 16, QChar('0'))
+            .arg(worst);
+    }
+};
+
+#endif // FLASHREPORT_H
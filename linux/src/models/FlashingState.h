@@ -7,6 +7,7 @@
 
 #include <QString>
 #include <cstdint>
+#include <stdexcept>
 
 /**
  * Represents the current state of the flashing process
@@ -149,6 +150,9 @@ struct FlashingState {
         case FlashingErrorType::ConnectionFailed:
             return QString("Connection failed: %1").arg(errorMessage);
         case FlashingErrorType::SyncFailed:
+            if (!errorMessage.isEmpty()) {
+                return QString("Failed to sync after %1 attempts: %2").arg(errorData).arg(errorMessage);
+            }
             return QString("Failed to sync after %1 attempts").arg(errorData);
         case FlashingErrorType::BaudChangeTimeout:
             return "Timeout changing baud rate";
@@ -173,4 +177,30 @@ struct FlashingState {
     }
 };
 
+/**
+ * Typed failure of a flashing step
+ * Carries everything needed to build the error state, so callers never
+ * have to classify errors by their message text.
+ */
+class FlashError : public std::runtime_error {
+public:
+    FlashError(FlashingErrorType type, const QString& message = "", int data = 0)
+        : std::runtime_error(message.toStdString())
+        , m_type(type)
+        , m_message(message)
+        , m_data(data)
+    {}
+
+    FlashingErrorType type() const { return m_type; }
+    QString message() const { return m_message; }
+    int data() const { return m_data; }
+
+    FlashingState state() const { return FlashingState::error(m_type, m_message, m_data); }
+
+private:
+    FlashingErrorType m_type;
+    QString m_message;
+    int m_data;
+};
+
 #endif // FLASHINGSTATE_H
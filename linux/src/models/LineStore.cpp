@@ -0,0 +1,103 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "LineStore.h"
+
+#include <algorithm>
+
+LineStore::LineStore(int maxLines)
+    : m_maxLines(std::max(maxLines, CHUNK_LINES))
+{
+}
+
+int LineStore::append(const QString& input)
+{
+    QString text = input;
+    if (text.contains('\r')) {
+        text.remove(QChar('\r'));
+    }
+
+    int start = 0;
+    const int length = text.size();
+
+    while (start < length) {
+        int newline = text.indexOf('\n', start);
+        int end = newline < 0 ? length : newline;
+
+        // Text up to the newline extends the open line
+        if (end > start) {
+            if (!m_lastOpen) {
+                newLine();
+            }
+
+            QString* last = &m_chunks.back().back();
+            while (start < end) {
+                if (last->size() >= MAX_LINE_LENGTH) {
+                    completeLine();
+                    newLine();
+                    last = &m_chunks.back().back();
+                }
+                int take = std::min(MAX_LINE_LENGTH - static_cast<int>(last->size()), end - start);
+                last->append(text.mid(start, take));
+                start += take;
+                m_longestLine = std::max(m_longestLine, static_cast<int>(last->size()));
+            }
+        }
+
+        if (newline < 0) {
+            break;
+        }
+
+        // An empty line still needs an entry of its own
+        if (!m_lastOpen) {
+            newLine();
+        }
+        completeLine();
+        start = newline + 1;
+    }
+
+    return trimHead();
+}
+
+void LineStore::clear()
+{
+    m_chunks.clear();
+    m_firstLineNumber += m_lineCount;
+    m_lineCount = 0;
+    m_longestLine = 0;
+    m_lastOpen = false;
+}
+
+void LineStore::newLine()
+{
+    if (m_chunks.empty() || static_cast<int>(m_chunks.back().size()) == CHUNK_LINES) {
+        m_chunks.emplace_back();
+        m_chunks.back().reserve(CHUNK_LINES);
+    }
+    m_chunks.back().emplace_back();
+    ++m_lineCount;
+    m_lastOpen = true;
+}
+
+void LineStore::completeLine()
+{
+    m_lastOpen = false;
+    if (m_onLineComplete) {
+        m_onLineComplete(m_firstLineNumber + m_lineCount - 1, m_chunks.back().back());
+    }
+}
+
+int LineStore::trimHead()
+{
+    // Only whole chunks go, so every chunk but the last stays full and
+    // line() stays a division
+    int dropped = 0;
+    while (m_chunks.size() > 1 && m_lineCount - CHUNK_LINES >= m_maxLines) {
+        m_chunks.pop_front();
+        m_lineCount -= CHUNK_LINES;
+        dropped += CHUNK_LINES;
+    }
+    m_firstLineNumber += dropped;
+    return dropped;
+}
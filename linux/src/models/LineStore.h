@@ -0,0 +1,84 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef LINESTORE_H
+#define LINESTORE_H
+
+#include <QString>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Append-only store of text lines, kept in fixed-size chunks
+ *
+ * Appending touches only the last line; trimming drops whole chunks from
+ * the head, so neither depends on how much text is stored. Lines keep an
+ * absolute number (firstLineNumber() + index) that stays valid across
+ * trims, which lets views keep their scroll position and selection.
+ */
+class LineStore {
+public:
+    static constexpr int CHUNK_LINES = 1024;
+    static constexpr int DEFAULT_MAX_LINES = 100000;
+
+    /// Longer lines are broken so one runaway line can't stall layout
+    static constexpr int MAX_LINE_LENGTH = 4096;
+
+    /// Called with each line as it is completed (by a newline or a wrap)
+    using LineHandler = std::function<void(int64_t lineNumber, const QString& line)>;
+
+    explicit LineStore(int maxLines = DEFAULT_MAX_LINES);
+
+    void setLineCompleteHandler(LineHandler handler) { m_onLineComplete = std::move(handler); }
+
+    /**
+     * Append text; a trailing partial line stays open for the next append
+     * Carriage returns are dropped (CRLF and LF both end a line).
+     * @return Number of lines dropped from the head to stay within maxLines
+     */
+    int append(const QString& text);
+
+    void clear();
+
+    /**
+     * Number of lines, including an open partial line
+     */
+    int lineCount() const { return m_lineCount; }
+
+    const QString& line(int index) const {
+        return m_chunks[index / CHUNK_LINES][index % CHUNK_LINES];
+    }
+
+    /**
+     * Absolute number of line(0); grows as the head is trimmed
+     */
+    int64_t firstLineNumber() const { return m_firstLineNumber; }
+
+    /**
+     * Length of the longest line seen since the last clear()
+     */
+    int longestLine() const { return m_longestLine; }
+
+    int maxLines() const { return m_maxLines; }
+
+private:
+    void newLine();
+    void completeLine();
+    int trimHead();
+
+    std::deque<std::vector<QString>> m_chunks;
+    int m_lineCount = 0;
+    int64_t m_firstLineNumber = 0;
+    int m_longestLine = 0;
+    int m_maxLines;
+
+    // The last line has no newline yet
+    bool m_lastOpen = false;
+
+    LineHandler m_onLineComplete;
+};
+
+#endif // LINESTORE_H
@@ -0,0 +1,59 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef LOGLEVEL_H
+#define LOGLEVEL_H
+
+#include <QString>
+#include <cstdint>
+
+/**
+ * Severity of an ESP-IDF log line ("E (1234) tag: ...")
+ * None covers everything else: ROM output, printf, boot banners.
+ */
+enum class LogLevel : uint8_t {
+    None,
+    Error,
+    Warning,
+    Info,
+    Debug,
+    Verbose
+};
+
+/**
+ * Bit for a level in a level mask
+ */
+inline uint8_t logLevelBit(LogLevel level)
+{
+    return static_cast<uint8_t>(1u << static_cast<int>(level));
+}
+
+constexpr uint8_t ALL_LOG_LEVELS = 0x3F;
+
+inline LogLevel logLevelFromLetter(QChar letter)
+{
+    switch (letter.unicode()) {
+    case 'E': return LogLevel::Error;
+    case 'W': return LogLevel::Warning;
+    case 'I': return LogLevel::Info;
+    case 'D': return LogLevel::Debug;
+    case 'V': return LogLevel::Verbose;
+    default: return LogLevel::None;
+    }
+}
+
+inline QString logLevelName(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::Error: return "Error";
+    case LogLevel::Warning: return "Warning";
+    case LogLevel::Info: return "Info";
+    case LogLevel::Debug: return "Debug";
+    case LogLevel::Verbose: return "Verbose";
+    case LogLevel::None: break;
+    }
+    return "None";
+}
+
+#endif // LOGLEVEL_H
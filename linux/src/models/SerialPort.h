@@ -7,6 +7,7 @@
 
 #include <QString>
 #include <termios.h>
+#include <optional>
 
 /**
  * Represents an available serial port
@@ -17,6 +18,7 @@ struct SerialPort {
     QString path;
     int vendorId = -1;
     int productId = -1;
+    QString serialNumber;
 
     QString displayName() const {
         return name.isEmpty() ? path : name;
@@ -30,6 +32,26 @@ struct SerialPort {
         return vendorId == 0x303A && productId == 0x1001;
     }
 
+    /**
+     * Check if this is an Espressif USB-JTAG-Serial device
+     * The same VID/PID is shared by ESP32-C3, S3, C6 and H2; the actual
+     * chip is identified after sync.
+     */
+    bool isUSBJTAGSerial() const {
+        return isESP32C3();
+    }
+
+    /**
+     * Same physical device; a USB device that re-enumerates may come back
+     * on another node, but its serial number goes with it
+     */
+    bool isSameDevice(const SerialPort& other) const {
+        if (serialNumber.isEmpty() || other.serialNumber.isEmpty()) {
+            return path == other.path;
+        }
+        return serialNumber == other.serialNumber;
+    }
+
     bool operator==(const SerialPort& other) const {
         return path == other.path;
     }
@@ -54,6 +76,17 @@ inline int baudRateValue(BaudRate rate)
     return static_cast<int>(rate);
 }
 
+inline std::optional<BaudRate> baudRateFromValue(int value)
+{
+    switch (value) {
+    case 115200: return BaudRate::Baud115200;
+    case 230400: return BaudRate::Baud230400;
+    case 460800: return BaudRate::Baud460800;
+    case 921600: return BaudRate::Baud921600;
+    }
+    return std::nullopt;
+}
+
 inline QString baudRateDisplayName(BaudRate rate)
 {
     switch (rate) {
@@ -76,6 +109,34 @@ inline speed_t baudRateConstant(BaudRate rate)
     return B115200;
 }
 
+/**
+ * Next slower flashing baud rate, or the same rate if already the slowest
+ */
+inline BaudRate lowerBaudRate(BaudRate rate)
+{
+    switch (rate) {
+    case BaudRate::Baud921600: return BaudRate::Baud460800;
+    case BaudRate::Baud460800: return BaudRate::Baud230400;
+    case BaudRate::Baud230400: return BaudRate::Baud115200;
+    case BaudRate::Baud115200: return BaudRate::Baud115200;
+    }
+    return BaudRate::Baud115200;
+}
+
+/**
+ * Next faster flashing baud rate, or the same rate if already the fastest
+ */
+inline BaudRate higherBaudRate(BaudRate rate)
+{
+    switch (rate) {
+    case BaudRate::Baud115200: return BaudRate::Baud230400;
+    case BaudRate::Baud230400: return BaudRate::Baud460800;
+    case BaudRate::Baud460800: return BaudRate::Baud921600;
+    case BaudRate::Baud921600: return BaudRate::Baud921600;
+    }
+    return BaudRate::Baud921600;
+}
+
 constexpr BaudRate ALL_BAUD_RATES[] = {
     BaudRate::Baud115200,
     BaudRate::Baud230400,
@@ -83,4 +144,66 @@ constexpr BaudRate ALL_BAUD_RATES[] = {
     BaudRate::Baud921600
 };
 
+/**
+ * DTR/RTS sequence used to put the chip into download mode
+ */
+enum class ResetStrategy {
+    USBJTAGSerial,  // ESP32-C3/S3 native USB-JTAG-Serial peripheral
+    Classic,        // USB-UART bridge (CP2102, CH340, etc.)
+    UnixTight,      // USB-UART bridge, DTR and RTS always set together
+    External        // Fixture resets the chip itself (e.g. GPIO expander)
+};
+
+inline QString resetStrategyName(ResetStrategy strategy)
+{
+    switch (strategy) {
+    case ResetStrategy::USBJTAGSerial: return "usb-jtag-serial";
+    case ResetStrategy::Classic: return "classic";
+    case ResetStrategy::UnixTight: return "unix-tight";
+    case ResetStrategy::External: return "external";
+    }
+    return "classic";
+}
+
+inline std::optional<ResetStrategy> resetStrategyFromName(const QString& name)
+{
+    if (name == "usb-jtag-serial") return ResetStrategy::USBJTAGSerial;
+    if (name == "classic") return ResetStrategy::Classic;
+    if (name == "unix-tight") return ResetStrategy::UnixTight;
+    if (name == "external") return ResetStrategy::External;
+    return std::nullopt;
+}
+
+/**
+ * Default reset strategy for a port, based on its USB identity
+ */
+inline ResetStrategy defaultResetStrategy(const SerialPort& port)
+{
+    return port.isESP32C3() ? ResetStrategy::USBJTAGSerial : ResetStrategy::Classic;
+}
+
+/**
+ * Flow control on the serial line
+ */
+enum class FlowControl {
+    None,
+    RtsCts      // Hardware handshake; the driver owns RTS
+};
+
+inline QString flowControlName(FlowControl mode)
+{
+    switch (mode) {
+    case FlowControl::None: return "none";
+    case FlowControl::RtsCts: return "rts-cts";
+    }
+    return "none";
+}
+
+inline std::optional<FlowControl> flowControlFromName(const QString& name)
+{
+    if (name == "none") return FlowControl::None;
+    if (name == "rts-cts") return FlowControl::RtsCts;
+    return std::nullopt;
+}
+
 #endif // SERIALPORT_H
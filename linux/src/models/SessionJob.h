@@ -0,0 +1,102 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef SESSIONJOB_H
+#define SESSIONJOB_H
+
+#include "models/FirmwareFile.h"
+
+#include <QByteArray>
+#include <QString>
+#include <cstdint>
+
+/**
+ * One operation queued on an open loader session
+ * See FlashingService::beginSession().
+ */
+struct SessionJob {
+    enum Type {
+        Flash,          // Write a firmware package
+        Verify,         // MD5-check a firmware package against flash
+        WriteData,      // Write per-device data (serial, calibration, keys...)
+        ReadBack,       // MD5 of a flash region
+        ReadMac,        // Factory MAC address from eFuse
+        ReadEfuses      // Raw eFuse words
+    };
+
+    Type type = ReadMac;
+    int id = 0;
+
+    /// Flash and Verify
+    FirmwareFile firmware;
+
+    /// WriteData, ReadBack: flash address; ReadEfuses: offset from the eFuse base
+    uint32_t address = 0;
+
+    /// ReadBack: bytes to hash; ReadEfuses: number of 32-bit words
+    uint32_t size = 0;
+
+    /// WriteData
+    QByteArray data;
+
+    static SessionJob flash(const FirmwareFile& firmware) {
+        SessionJob job;
+        job.type = Flash;
+        job.firmware = firmware;
+        return job;
+    }
+
+    static SessionJob verify(const FirmwareFile& firmware) {
+        SessionJob job;
+        job.type = Verify;
+        job.firmware = firmware;
+        return job;
+    }
+
+    static SessionJob writeData(uint32_t address, const QByteArray& data) {
+        SessionJob job;
+        job.type = WriteData;
+        job.address = address;
+        job.data = data;
+        return job;
+    }
+
+    static SessionJob readBack(uint32_t address, uint32_t size) {
+        SessionJob job;
+        job.type = ReadBack;
+        job.address = address;
+        job.size = size;
+        return job;
+    }
+
+    static SessionJob readMac() {
+        SessionJob job;
+        job.type = ReadMac;
+        return job;
+    }
+
+    static SessionJob readEfuses(uint32_t offset, uint32_t wordCount) {
+        SessionJob job;
+        job.type = ReadEfuses;
+        job.address = offset;
+        job.size = wordCount;
+        return job;
+    }
+};
+
+/**
+ * Outcome of a session job
+ */
+struct SessionResult {
+    int jobId = 0;
+    SessionJob::Type type = SessionJob::ReadMac;
+    bool success = false;
+
+    /// ReadMac: 6 bytes; ReadEfuses: words little-endian; ReadBack: 16-byte MD5
+    QByteArray data;
+
+    QString errorMessage;
+};
+
+#endif // SESSIONJOB_H
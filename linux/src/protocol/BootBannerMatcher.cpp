@@ -0,0 +1,109 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "BootBannerMatcher.h"
+
+namespace {
+
+// ROM is waiting in the serial loader
+const char* const kDownloadPatterns[] = {
+    "waiting for download",
+    "(DOWNLOAD",            // boot:0x7 (DOWNLOAD(USB/UART0/1)), boot:0x3 (DOWNLOAD_BOOT(UART0/UART1/SDIO_REI_REO_V2))
+};
+
+// Chip went on to boot from flash - the strapping pin was not held
+const char* const kNormalBootPatterns[] = {
+    "SPI_FAST_FLASH_BOOT",
+    "(SPI_FLASH_BOOT",
+    "entry 0x",             // Second-stage bootloader jumping to the app
+};
+
+// First lines the ROM prints after any reset; the original ESP32 starts
+// with "ets Jun  8 2016 00:22:57" instead of "ESP-ROM:"
+const char* const kRomBannerPatterns[] = {
+    "ESP-ROM:",
+    "rst:0x",
+};
+const char* const kRomBannerPrefix = "ets ";
+
+} // anonymous namespace
+
+bool BootBannerMatcher::isRomBannerLine(const QByteArray& line)
+{
+    for (const char* pattern : kRomBannerPatterns) {
+        if (line.contains(pattern)) {
+            return true;
+        }
+    }
+    return line.startsWith(kRomBannerPrefix);
+}
+
+bool BootBannerMatcher::isRomBannerLine(const QString& line)
+{
+    // Banner lines are ASCII
+    return isRomBannerLine(line.toLatin1());
+}
+
+BootBannerMatcher::Result BootBannerMatcher::feed(const QByteArray& data)
+{
+    for (int i = 0; i < data.size(); ++i) {
+        char c = data[i];
+
+        if (c == '\n' || c == '\r') {
+            Result result = scanLine();
+            if (result != None) {
+                m_matchedLine = m_line;
+                m_line.clear();
+                return result;
+            }
+            m_line.clear();
+            continue;
+        }
+
+        if (m_line.size() < MAX_LINE_LENGTH) {
+            m_line.append(c);
+        }
+    }
+
+    // "waiting for download" is the last thing the ROM prints; don't wait
+    // for the line ending to arrive in a later read
+    Result result = scanLine();
+    if (result != None) {
+        m_matchedLine = m_line;
+        m_line.clear();
+    }
+    return result;
+}
+
+BootBannerMatcher::Result BootBannerMatcher::scanLine()
+{
+    if (m_line.isEmpty()) {
+        return None;
+    }
+
+    if (isRomBannerLine(m_line)) {
+        m_sawRomBanner = true;
+    }
+
+    for (const char* pattern : kDownloadPatterns) {
+        if (m_line.contains(pattern)) {
+            return DownloadMode;
+        }
+    }
+
+    for (const char* pattern : kNormalBootPatterns) {
+        if (m_line.contains(pattern)) {
+            return NormalBoot;
+        }
+    }
+
+    return None;
+}
+
+void BootBannerMatcher::reset()
+{
+    m_line.clear();
+    m_matchedLine.clear();
+    m_sawRomBanner = false;
+}
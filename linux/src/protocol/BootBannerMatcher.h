@@ -0,0 +1,77 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef BOOTBANNERMATCHER_H
+#define BOOTBANNERMATCHER_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * Streaming matcher for the ESP32 ROM boot banner
+ *
+ * After reset the ROM prints something like:
+ *   ESP-ROM:esp32c3-api1-20210207
+ *   rst:0x15 (USB_UART_CHIP_RESET),boot:0x7 (DOWNLOAD(USB/UART0/1))
+ *   waiting for download
+ * or, if the boot strapping did not take, a normal flash boot:
+ *   rst:0x1 (POWERON),boot:0xc (SPI_FAST_FLASH_BOOT)
+ *
+ * Bytes are fed in as they arrive from SerialConnection::read(); matches
+ * that straddle two reads are still found.
+ */
+class BootBannerMatcher {
+public:
+    enum Result {
+        None,           // Nothing conclusive yet
+        DownloadMode,   // ROM is in the serial loader and ready for SYNC
+        NormalBoot      // Chip booted from flash - bootloader entry failed
+    };
+
+    BootBannerMatcher() = default;
+
+    /**
+     * Scan newly received bytes
+     * @param data Bytes read from the port
+     * @return First conclusive result, or None
+     */
+    Result feed(const QByteArray& data);
+
+    /**
+     * The banner line that produced the last conclusive result
+     * e.g. "rst:0x1 (POWERON),boot:0xc (SPI_FAST_FLASH_BOOT)"
+     */
+    QString matchedLine() const { return QString::fromLatin1(m_matchedLine).trimmed(); }
+
+    /**
+     * True once any ROM banner line has been seen ("ESP-ROM:", "rst:0x..",
+     * "ets ...")
+     * Proof that the chip went through a reset, whatever it booted into.
+     */
+    bool sawRomBanner() const { return m_sawRomBanner; }
+
+    /**
+     * One of the first lines the ROM prints after any reset
+     * Shared with the boot profiler, so both agree on what a reset is.
+     */
+    static bool isRomBannerLine(const QByteArray& line);
+    static bool isRomBannerLine(const QString& line);
+
+    /**
+     * Clear all state
+     */
+    void reset();
+
+private:
+    Result scanLine();
+
+    QByteArray m_line;
+    QByteArray m_matchedLine;
+    bool m_sawRomBanner = false;
+
+    // Longest banner line worth keeping; anything beyond is not a banner
+    static constexpr int MAX_LINE_LENGTH = 256;
+};
+
+#endif // BOOTBANNERMATCHER_H
@@ -0,0 +1,123 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "ESP32Chip.h"
+#include "ESP32Protocol.h"
+
+namespace {
+
+constexpr uint32_t kWdtKey = 0x50D83AA1;
+constexpr uint32_t kSwdKey = 0x8F1D312A;
+
+// ESP32-C6/H2 moved the watchdogs into the low-power WDT block
+constexpr uint32_t kLpWdtBase = 0x600B1C00;
+
+const ESP32ChipDescriptor kChips[] = {
+    {
+        ESP32ChipFamily::ESP32, "ESP32", 0,
+        {0x00F01D83, 0, 0, 0},
+        0x3FF4808C, 0x3FF48090, 0x3FF480A4, kWdtKey,
+        0, 0, 0, 0,
+        false, 0x1000,
+        0x3FF5A000, 0x3FF5A004
+    },
+    {
+        ESP32ChipFamily::ESP32S2, "ESP32-S2", 2,
+        {0x000007C6, 0, 0, 0},
+        0x3F408094, 0x3F408098, 0x3F4080AC, kWdtKey,
+        0, 0, 0, 0,
+        false, 0x1000,
+        0x3F41A000, 0x3F41A044
+    },
+    {
+        ESP32ChipFamily::ESP32S3, "ESP32-S3", 9,
+        {0x00000009, 0, 0, 0},
+        0x60008098, 0x6000809C, 0x600080B0, kWdtKey,
+        0x600080B4, 0x600080B8, kSwdKey, 1u << 31,
+        true, 0x0,
+        0x60007000, 0x60007044
+    },
+    {
+        ESP32ChipFamily::ESP32C3, "ESP32-C3", 5,
+        {0x6921506F, 0x1B31506F, 0x4881606F, 0x4361606F},
+        ESP32C3Registers::RTC_WDT_CONFIG0, ESP32C3Registers::RTC_WDT_CONFIG1,
+        ESP32C3Registers::RTC_WDT_WPROTECT, ESP32C3Registers::RTC_WDT_WKEY,
+        ESP32C3Registers::SWD_CONF, ESP32C3Registers::SWD_WPROTECT,
+        ESP32C3Registers::SWD_WKEY, ESP32C3Registers::SWD_AUTO_FEED_EN_BIT,
+        true, 0x0,
+        0x60008800, 0x60008844
+    },
+    {
+        ESP32ChipFamily::ESP32C6, "ESP32-C6", 13,
+        {0x2CE0806F, 0, 0, 0},
+        kLpWdtBase + 0x0000, kLpWdtBase + 0x0004, kLpWdtBase + 0x0018, kWdtKey,
+        kLpWdtBase + 0x001C, kLpWdtBase + 0x0020, kWdtKey, 1u << 18,
+        true, 0x0,
+        0x600B0800, 0x600B0844
+    },
+    {
+        ESP32ChipFamily::ESP32H2, "ESP32-H2", 16,
+        {0xD7B73E80, 0, 0, 0},
+        kLpWdtBase + 0x0000, kLpWdtBase + 0x0004, kLpWdtBase + 0x0018, kWdtKey,
+        kLpWdtBase + 0x001C, kLpWdtBase + 0x0020, kWdtKey, 1u << 18,
+        true, 0x0,
+        0x600B0800, 0x600B0844
+    },
+};
+
+} // anonymous namespace
+
+namespace ESP32Chips {
+
+const ESP32ChipDescriptor& descriptor(ESP32ChipFamily family)
+{
+    for (const ESP32ChipDescriptor& chip : kChips) {
+        if (chip.family == family) {
+            return chip;
+        }
+    }
+    return descriptor(ESP32ChipFamily::ESP32C3);
+}
+
+const ESP32ChipDescriptor* fromMagicValue(uint32_t magic)
+{
+    for (const ESP32ChipDescriptor& chip : kChips) {
+        for (uint32_t value : chip.magicValues) {
+            if (value != 0 && value == magic) {
+                return &chip;
+            }
+        }
+    }
+    return nullptr;
+}
+
+const ESP32ChipDescriptor* fromChipId(uint32_t chipId)
+{
+    for (const ESP32ChipDescriptor& chip : kChips) {
+        if (chip.chipId != 0 && chip.chipId == chipId) {
+            return &chip;
+        }
+    }
+    return nullptr;
+}
+
+ESP32ChipFamily familyFromName(const QString& name)
+{
+    for (const ESP32ChipDescriptor& chip : kChips) {
+        if (name == chip.name) {
+            return chip.family;
+        }
+    }
+    return ESP32ChipFamily::Unknown;
+}
+
+QString familyName(ESP32ChipFamily family)
+{
+    if (family == ESP32ChipFamily::Unknown) {
+        return "Unknown";
+    }
+    return QString::fromLatin1(descriptor(family).name);
+}
+
+} // namespace ESP32Chips
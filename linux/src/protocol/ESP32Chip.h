@@ -0,0 +1,100 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef ESP32CHIP_H
+#define ESP32CHIP_H
+
+#include <QString>
+#include <cstdint>
+
+/**
+ * Supported ESP32 chip families
+ */
+enum class ESP32ChipFamily {
+    Unknown,
+    ESP32,
+    ESP32S2,
+    ESP32S3,
+    ESP32C3,
+    ESP32C6,
+    ESP32H2
+};
+
+/**
+ * Per-chip register map and flash defaults
+ * Register addresses are 0 when the chip does not have that block.
+ * Values from the esptool target definitions.
+ */
+struct ESP32ChipDescriptor {
+    ESP32ChipFamily family;
+    const char* name;
+
+    /// Chip ID reported by GET_SECURITY_INFO (0 = not reported)
+    uint32_t chipId;
+
+    /// Values read from CHIP_DETECT_MAGIC_REG (unused slots are 0)
+    uint32_t magicValues[4];
+
+    // RTC watchdog
+    uint32_t rtcWdtConfig0;
+    uint32_t rtcWdtConfig1;
+    uint32_t rtcWdtWprotect;
+    uint32_t rtcWdtWkey;
+
+    // Super watchdog
+    uint32_t swdConf;
+    uint32_t swdWprotect;
+    uint32_t swdWkey;
+    uint32_t swdAutoFeedBit;
+
+    /// Has the native USB-JTAG-Serial peripheral (0x303A:0x1001)
+    bool hasUSBJTAGSerial;
+
+    /// Where the second-stage bootloader lives in flash
+    uint32_t bootloaderOffset;
+
+    /// eFuse controller base, and the first of the two factory MAC words
+    uint32_t efuseBase;
+    uint32_t efuseMacWord0;
+
+    bool hasRtcWatchdog() const { return rtcWdtConfig0 != 0; }
+    bool hasSuperWatchdog() const { return swdConf != 0; }
+};
+
+namespace ESP32Chips {
+
+/// ROM register holding a per-chip magic value
+constexpr uint32_t CHIP_DETECT_MAGIC_REG = 0x40001000;
+
+/**
+ * Descriptor for a chip family (Unknown returns the ESP32-C3 entry,
+ * which matches the behaviour before chip detection existed)
+ */
+const ESP32ChipDescriptor& descriptor(ESP32ChipFamily family);
+
+/**
+ * Identify a chip from its CHIP_DETECT_MAGIC_REG value
+ * @return Descriptor, or nullptr if the value is not recognised
+ */
+const ESP32ChipDescriptor* fromMagicValue(uint32_t magic);
+
+/**
+ * Identify a chip from the GET_SECURITY_INFO chip ID
+ * @return Descriptor, or nullptr if the ID is not recognised
+ */
+const ESP32ChipDescriptor* fromChipId(uint32_t chipId);
+
+/**
+ * Look up a family by its display name (as stored in device profiles)
+ */
+ESP32ChipFamily familyFromName(const QString& name);
+
+/**
+ * Display name, e.g. "ESP32-C3"
+ */
+QString familyName(ESP32ChipFamily family);
+
+} // namespace ESP32Chips
+
+#endif // ESP32CHIP_H
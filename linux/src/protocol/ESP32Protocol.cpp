@@ -215,4 +215,58 @@ QByteArray buildWriteRegCommand(uint32_t address, uint32_t value, uint32_t mask,
     return buildPacket(ESP32Command::WriteReg, payload);
 }
 
+QByteArray buildSpiFlashMd5Command(uint32_t address, uint32_t size)
+{
+    QByteArray payload;
+    appendLE32(payload, address);
+    appendLE32(payload, size);
+    appendLE32(payload, 0);
+    appendLE32(payload, 0);
+
+    return buildPacket(ESP32Command::SpiFlashMd5, payload);
+}
+
+std::optional<QByteArray> parseFlashMd5(const ESP32Response& response)
+{
+    // Like GET_SECURITY_INFO, the status follows the digest
+    constexpr int hexDigestSize = 32;
+
+    if (response.data.size() < hexDigestSize + 2) {
+        return std::nullopt;
+    }
+    if (response.data[hexDigestSize] != 0) {
+        return std::nullopt;
+    }
+
+    QByteArray digest = QByteArray::fromHex(response.data.left(hexDigestSize));
+    if (digest.size() != 16) {
+        return std::nullopt;
+    }
+    return digest;
+}
+
+QByteArray buildGetSecurityInfoCommand()
+{
+    return buildPacket(ESP32Command::GetSecurityInfo, QByteArray());
+}
+
+std::optional<uint32_t> parseSecurityInfoChipId(const ESP32Response& response)
+{
+    // 20 bytes of security info plus 2 status bytes, which for this
+    // multi-byte response sit at the END of the data section
+    constexpr int infoSize = 20;
+    constexpr int chipIdOffset = 12;
+
+    if (response.data.size() < infoSize + 2) {
+        return std::nullopt;
+    }
+
+    int statusOffset = response.data.size() - 2;
+    if (response.data[statusOffset] != 0) {
+        return std::nullopt;
+    }
+
+    return readLE32(response.data, chipIdOffset);
+}
+
 } // namespace ESP32Protocol
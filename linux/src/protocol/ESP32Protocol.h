@@ -20,7 +20,9 @@ enum class ESP32Command : uint8_t {
     ChangeBaudRate = 0x0F,
     ReadReg = 0x0A,
     WriteReg = 0x09,
-    SpiAttach = 0x0D
+    SpiAttach = 0x0D,
+    SpiFlashMd5 = 0x13,
+    GetSecurityInfo = 0x14
 };
 
 /**
@@ -31,6 +33,7 @@ namespace ESP32C3Registers {
 
     // RTC Watchdog Config
     constexpr uint32_t RTC_WDT_CONFIG0 = RTC_CNTL_BASE + 0x0090;
+    constexpr uint32_t RTC_WDT_CONFIG1 = RTC_CNTL_BASE + 0x0094;
     constexpr uint32_t RTC_WDT_WPROTECT = RTC_CNTL_BASE + 0x00A8;
     constexpr uint32_t RTC_WDT_WKEY = 0x50D83AA1;
 
@@ -43,6 +46,13 @@ namespace ESP32C3Registers {
     constexpr uint32_t WDT_EN_BIT = 1 << 31;
     constexpr uint32_t SWD_AUTO_FEED_EN_BIT = 1 << 31;
     constexpr uint32_t SWD_DISABLE_BIT = 1 << 30;
+
+    // RTC watchdog system reset (esptool watchdog_reset)
+    // CONFIG0: enable, stage 0 action = reset system, flash boot mode
+    // write-protect off, stage 0 hold = 2. CONFIG1 is the stage 0 timeout
+    // in RTC slow clock cycles (~15 ms).
+    constexpr uint32_t WDT_SYSTEM_RESET_CONFIG = WDT_EN_BIT | (5u << 28) | (1u << 8) | 2u;
+    constexpr uint32_t WDT_SYSTEM_RESET_TIMEOUT = 2000;
 }
 
 /**
@@ -78,6 +88,9 @@ constexpr uint8_t CHECKSUM_SEED = 0xEF;
 /// Default block size for flash data
 constexpr int FLASH_BLOCK_SIZE = 1024;
 
+/// Flash erase granularity
+constexpr int FLASH_SECTOR_SIZE = 4096;
+
 /**
  * Calculate XOR checksum for data
  * @param data Data to checksum
@@ -161,6 +174,38 @@ QByteArray buildWriteRegCommand(
     uint32_t delayUs = 0
 );
 
+/**
+ * Build SPI_FLASH_MD5 command packet
+ * @param address Flash address to start hashing at
+ * @param size Number of bytes to hash
+ * @return Command packet
+ */
+QByteArray buildSpiFlashMd5Command(uint32_t address, uint32_t size);
+
+/**
+ * Extract the digest from an SPI_FLASH_MD5 response
+ * The ROM answers with 32 hex characters followed by the status bytes.
+ * @param response Parsed response
+ * @return 16-byte MD5 digest, or nullopt if the command failed
+ */
+std::optional<QByteArray> parseFlashMd5(const ESP32Response& response);
+
+/**
+ * Build GET_SECURITY_INFO command packet
+ * Supported by the ROM of ESP32-S2 and later chips
+ * @return Command packet
+ */
+QByteArray buildGetSecurityInfoCommand();
+
+/**
+ * Extract the chip ID from a GET_SECURITY_INFO response
+ * Layout: flags(4) flash_crypt_cnt(1) key_purposes(7) chip_id(4) eco_version(4)
+ * followed by the status bytes. ESP32-S2 omits chip_id and eco_version.
+ * @param response Parsed response
+ * @return Chip ID, or nullopt if the command failed or the ROM doesn't report one
+ */
+std::optional<uint32_t> parseSecurityInfoChipId(const ESP32Response& response);
+
 } // namespace ESP32Protocol
 
 #endif // ESP32PROTOCOL_H
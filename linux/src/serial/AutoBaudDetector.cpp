@@ -0,0 +1,257 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "AutoBaudDetector.h"
+
+#include <QSettings>
+#include <QStringList>
+#include <QVariant>
+#include <algorithm>
+
+namespace {
+
+// ROM and default console rate first, then what projects usually raise it to
+const int kDefaultCandidates[] = {115200, 921600, 460800, 230400, 2000000, 1500000, 57600};
+
+} // anonymous namespace
+
+double AutoBaudDetector::Sample::score() const
+{
+    if (bytes == 0) {
+        return 0.0;
+    }
+
+    double result = static_cast<double>(printable) / static_cast<double>(bytes);
+    if (countersAvailable) {
+        result -= 2.0 * std::min(1.0, static_cast<double>(frameErrors) / static_cast<double>(bytes));
+    }
+    return result;
+}
+
+AutoBaudDetector::AutoBaudDetector(std::vector<int> candidates)
+    : m_candidates(std::move(candidates))
+{
+    if (m_candidates.empty()) {
+        m_candidates.push_back(115200);
+    }
+    m_rate = m_candidates.front();
+}
+
+std::vector<int> AutoBaudDetector::configuredCandidates()
+{
+    const std::vector<int> supported = SerialConnection::supportedBaudRates();
+    std::vector<int> candidates;
+
+    QSettings settings;
+    const QStringList entries = settings.value("SerialMonitor/autoBaudRates").toStringList();
+    for (const QString& entry : entries) {
+        bool ok = false;
+        int rate = entry.trimmed().toInt(&ok);
+        if (ok && std::find(supported.begin(), supported.end(), rate) != supported.end() &&
+            std::find(candidates.begin(), candidates.end(), rate) == candidates.end()) {
+            candidates.push_back(rate);
+        }
+    }
+
+    if (candidates.empty()) {
+        candidates.assign(std::begin(kDefaultCandidates), std::end(kDefaultCandidates));
+    }
+    return candidates;
+}
+
+void AutoBaudDetector::start()
+{
+    // The rate that worked last time is the likeliest, unless it is the
+    // one that just turned to noise
+    const bool restart = !m_detecting && m_lockedRate != 0 && m_noisyChecks > 0;
+
+    m_order = m_candidates;
+    auto locked = std::find(m_order.begin(), m_order.end(), m_lockedRate);
+    if (locked != m_order.end()) {
+        m_order.erase(locked);
+        if (restart) {
+            m_order.push_back(m_lockedRate);
+        } else {
+            m_order.insert(m_order.begin(), m_lockedRate);
+        }
+    }
+
+    m_detecting = true;
+    m_next = 0;
+    m_samples.clear();
+    m_windowBytes.clear();
+    m_windowOpen = false;
+    m_noisyChecks = 0;
+    m_rate = m_order.front();
+}
+
+void AutoBaudDetector::beginWindow(int64_t nowNs, const std::optional<SerialErrorCounters>& counters)
+{
+    m_windowStartNs = nowNs;
+    m_frameBase = counters ? counters->frame : 0;
+
+    m_window = Sample();
+    m_window.rate = m_rate;
+    m_window.countersAvailable = counters.has_value();
+    m_bytes.clear();
+    m_windowOpen = m_detecting;
+
+    m_check = Sample();
+    m_check.rate = m_rate;
+    m_check.countersAvailable = counters.has_value();
+}
+
+bool AutoBaudDetector::feed(int64_t timestampNs, const QByteArray& data)
+{
+    // Read before the switch: received at the old rate
+    if (timestampNs < m_windowStartNs) {
+        return false;
+    }
+
+    if (m_detecting) {
+        if (m_windowOpen) {
+            count(m_window, data);
+            m_bytes.append(data);
+        }
+        return false;
+    }
+
+    count(m_check, data);
+    return true;
+}
+
+bool AutoBaudDetector::poll(int64_t nowNs, const std::optional<SerialErrorCounters>& counters)
+{
+    if (!m_detecting) {
+        if (m_check.bytes < CHECK_BYTES) {
+            return false;
+        }
+
+        const uint64_t frame = counters ? counters->frame : 0;
+        m_check.frameErrors = frame - std::min(frame, m_frameBase);
+        m_frameBase = frame;
+
+        const bool noisy = m_check.score() < NOISE_SCORE;
+        m_noisyChecks = noisy ? m_noisyChecks + 1 : 0;
+        m_check = Sample();
+        m_check.rate = m_rate;
+        m_check.countersAvailable = counters.has_value();
+
+        // Two in a row, so one burst of binary doesn't set it off
+        if (m_noisyChecks < 2) {
+            return false;
+        }
+        start();
+        return true;
+    }
+
+    if (!m_windowOpen) {
+        return false;
+    }
+
+    const int64_t elapsed = nowNs - m_windowStartNs;
+    const bool enough = elapsed >= WINDOW_NS && m_window.bytes >= MIN_BYTES;
+    if (!enough && elapsed < IDLE_WINDOW_NS) {
+        return false;
+    }
+
+    finishWindow(counters);
+    const int current = m_rate;
+    const Sample& sample = m_samples.back();
+
+    if (sample.bytes >= MIN_BYTES && sample.score() >= LOCK_SCORE) {
+        lock(m_samples.size() - 1);
+    } else if (++m_next < m_order.size()) {
+        m_rate = m_order[m_next];
+        return true;
+    } else {
+        // Best of what spoke; a device that said nothing keeps the
+        // preferred rate until the lock check hears otherwise
+        size_t best = 0;
+        for (size_t i = 1; i < m_samples.size(); ++i) {
+            const bool usable = m_samples[i].bytes >= MIN_BYTES;
+            const bool bestUsable = m_samples[best].bytes >= MIN_BYTES;
+            if (usable && (!bestUsable || m_samples[i].score() > m_samples[best].score())) {
+                best = i;
+            }
+        }
+        lock(best);
+    }
+
+    if (m_rate == current) {
+        m_frameBase = counters ? counters->frame : 0;
+        return false;
+    }
+    return true;
+}
+
+QByteArray AutoBaudDetector::takeWinningBytes()
+{
+    QByteArray bytes;
+    bytes.swap(m_winningBytes);
+    return bytes;
+}
+
+QString AutoBaudDetector::describeLastDetection() const
+{
+    QStringList parts;
+    for (const Sample& sample : m_lastSamples) {
+        if (sample.bytes < MIN_BYTES) {
+            parts.append(QString("%1 (no data)").arg(sample.rate));
+            continue;
+        }
+        QString part = QString("%1 (%2").arg(sample.rate).arg(sample.score(), 0, 'f', 2);
+        if (sample.frameErrors > 0) {
+            part += QString(", %1 framing errors").arg(sample.frameErrors);
+        }
+        parts.append(part + ")");
+    }
+    return parts.join(", ");
+}
+
+void AutoBaudDetector::finishWindow(const std::optional<SerialErrorCounters>& counters)
+{
+    if (counters) {
+        m_window.frameErrors = counters->frame - std::min(counters->frame, m_frameBase);
+    }
+    m_samples.push_back(m_window);
+    m_windowBytes.push_back(m_bytes);
+    m_bytes.clear();
+    m_windowOpen = false;
+}
+
+void AutoBaudDetector::lock(size_t best)
+{
+    m_detecting = false;
+    m_rate = m_samples[best].rate;
+    m_lockedRate = m_rate;
+    m_winningBytes = m_windowBytes[best];
+    m_windowBytes.clear();
+
+    m_lastSamples = m_samples;
+    std::stable_sort(m_lastSamples.begin(), m_lastSamples.end(), [](const Sample& a, const Sample& b) {
+        const bool aUsable = a.bytes >= MIN_BYTES;
+        const bool bUsable = b.bytes >= MIN_BYTES;
+        return aUsable != bUsable ? aUsable : a.score() > b.score();
+    });
+
+    m_check = Sample();
+    m_check.rate = m_rate;
+    m_check.countersAvailable = m_window.countersAvailable;
+    m_noisyChecks = 0;
+}
+
+void AutoBaudDetector::count(Sample& sample, const QByteArray& data)
+{
+    size_t printable = 0;
+    for (char c : data) {
+        const auto byte = static_cast<unsigned char>(c);
+        if ((byte >= 0x20 && byte < 0x7f) || byte == '\n' || byte == '\r' ||
+            byte == '\t' || byte == 0x1b) {
+            ++printable;
+        }
+    }
+    sample.bytes += static_cast<size_t>(data.size());
+    sample.printable += printable;
+}
@@ -0,0 +1,147 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef AUTOBAUDDETECTOR_H
+#define AUTOBAUDDETECTOR_H
+
+#include "serial/SerialConnection.h"
+
+#include <QByteArray>
+#include <QString>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * Finds the rate a device is printing at by listening at each candidate
+ *
+ * Text received at the right rate is nearly all printable ASCII and the
+ * UART reports no framing errors; at a wrong rate the bytes are noise and
+ * the stop bits land in the wrong place. The detector keeps the port at
+ * one candidate per window, scores what arrives, and locks onto the best.
+ * Once locked it keeps scoring: when the text turns to noise (the device
+ * rebooted into the ROM at 115200, or out of it into the app) it starts
+ * over. It never touches the port itself; PortMonitor applies rate().
+ */
+class AutoBaudDetector {
+public:
+    /**
+     * What one window at one rate looked like
+     */
+    struct Sample {
+        int rate = 0;
+        size_t bytes = 0;
+        size_t printable = 0;
+        uint64_t frameErrors = 0;
+        bool countersAvailable = false;
+
+        /// 1.0 is clean text; garbage scores around 0.4 or below
+        double score() const;
+    };
+
+    /// Listening time per candidate once enough bytes have arrived
+    static constexpr int64_t WINDOW_NS = 60LL * 1000 * 1000;
+
+    /// Longest wait at one candidate for a quiet device
+    static constexpr int64_t IDLE_WINDOW_NS = 400LL * 1000 * 1000;
+
+    /// Fewer bytes than this can't be scored
+    static constexpr size_t MIN_BYTES = 24;
+
+    /// A candidate this clean is taken without trying the rest
+    static constexpr double LOCK_SCORE = 0.97;
+
+    /// Below this a locked stream counts as noise
+    static constexpr double NOISE_SCORE = 0.6;
+
+    /// Bytes per check while locked
+    static constexpr size_t CHECK_BYTES = 512;
+
+    /**
+     * @param candidates Rates to try, in order of preference
+     */
+    explicit AutoBaudDetector(std::vector<int> candidates = configuredCandidates());
+
+    /**
+     * Candidates from QSettings "SerialMonitor/autoBaudRates" (a list of
+     * rates), or the rates ESP-IDF projects commonly log at
+     */
+    static std::vector<int> configuredCandidates();
+
+    /**
+     * Start detecting; the last locked rate is tried first
+     */
+    void start();
+
+    bool isDetecting() const { return m_detecting; }
+
+    /**
+     * Rate the port should be at now
+     */
+    int rate() const { return m_rate; }
+
+    /**
+     * The port was switched to rate() at nowNs; counters as of then
+     */
+    void beginWindow(int64_t nowNs, const std::optional<SerialErrorCounters>& counters);
+
+    /**
+     * Bytes read at timestampNs
+     * @return Whether they are text to show (false while detecting, and
+     *         for bytes from before the last switch)
+     */
+    bool feed(int64_t timestampNs, const QByteArray& data);
+
+    /**
+     * Once per frame, with the driver's counters
+     * @return true if the port must be switched to rate() and
+     *         beginWindow() called
+     */
+    bool poll(int64_t nowNs, const std::optional<SerialErrorCounters>& counters);
+
+    /**
+     * Bytes of the window that won, to show once detection locks
+     */
+    QByteArray takeWinningBytes();
+
+    /**
+     * The samples of the last finished detection, best first
+     */
+    const std::vector<Sample>& lastSamples() const { return m_lastSamples; }
+
+    /**
+     * e.g. "921600 (score 0.99), 115200 (0.41, 37 framing errors)"
+     */
+    QString describeLastDetection() const;
+
+private:
+    void finishWindow(const std::optional<SerialErrorCounters>& counters);
+    void lock(size_t best);
+    static void count(Sample& sample, const QByteArray& data);
+
+    std::vector<int> m_candidates;
+    int m_rate = 0;
+    int m_lockedRate = 0;
+    bool m_detecting = false;
+
+    // Current detection
+    std::vector<int> m_order;
+    size_t m_next = 0;
+    std::vector<Sample> m_samples;
+    std::vector<QByteArray> m_windowBytes;
+    Sample m_window;
+    QByteArray m_bytes;
+    int64_t m_windowStartNs = 0;
+    bool m_windowOpen = false;
+    uint64_t m_frameBase = 0;
+
+    QByteArray m_winningBytes;
+    std::vector<Sample> m_lastSamples;
+
+    // Watching a locked stream
+    Sample m_check;
+    int m_noisyChecks = 0;
+};
+
+#endif // AUTOBAUDDETECTOR_H
@@ -0,0 +1,126 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef BYTERING_H
+#define BYTERING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+
+/**
+ * Lock-free single-producer/single-consumer byte ring
+ *
+ * One thread writes, one thread reads; neither ever blocks the other.
+ * Capacity is rounded up to a power of two so positions wrap with a mask.
+ * Head and tail only grow; their difference is the fill level.
+ */
+class ByteRing {
+public:
+    explicit ByteRing(size_t capacity)
+        : m_capacity(roundUp(capacity))
+        , m_mask(m_capacity - 1)
+        , m_buffer(new char[m_capacity])
+    {}
+
+    ByteRing(const ByteRing&) = delete;
+    ByteRing& operator=(const ByteRing&) = delete;
+
+    size_t capacity() const { return m_capacity; }
+
+    /**
+     * Producer: copy in as much of data as fits
+     * @return Bytes written (less than size when the ring is full)
+     */
+    size_t write(const char* data, size_t size) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t count = std::min(size, m_capacity - (head - tail));
+
+        copyIn(head, data, count);
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Producer: copy in a header and its payload as one unit, so the
+     * consumer never sees one without the other
+     * @return false (and writes nothing) if both don't fit
+     */
+    bool writeRecord(const void* header, size_t headerSize, const char* data, size_t size) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        if (headerSize + size > m_capacity - (head - tail)) {
+            return false;
+        }
+
+        copyIn(head, static_cast<const char*>(header), headerSize);
+        copyIn(head + headerSize, data, size);
+        m_head.store(head + headerSize + size, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer: copy out up to maxSize bytes
+     * @return Bytes read
+     */
+    size_t read(char* data, size_t maxSize) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        const size_t count = std::min(maxSize, head - tail);
+
+        copyOut(tail, data, count);
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Bytes waiting for the consumer (exact on the consumer thread)
+     */
+    size_t available() const {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Consumer: drop everything buffered
+     */
+    void clear() {
+        m_tail.store(m_head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    static size_t roundUp(size_t value) {
+        size_t capacity = 1;
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    void copyIn(size_t position, const char* data, size_t count) {
+        const size_t offset = position & m_mask;
+        const size_t first = std::min(count, m_capacity - offset);
+        std::memcpy(m_buffer.get() + offset, data, first);
+        std::memcpy(m_buffer.get(), data + first, count - first);
+    }
+
+    void copyOut(size_t position, char* data, size_t count) const {
+        const size_t offset = position & m_mask;
+        const size_t first = std::min(count, m_capacity - offset);
+        std::memcpy(data, m_buffer.get() + offset, first);
+        std::memcpy(data + first, m_buffer.get(), count - first);
+    }
+
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<char[]> m_buffer;
+
+    // Separate cache lines so producer and consumer don't false-share
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+#endif // BYTERING_H
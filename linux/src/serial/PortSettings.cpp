@@ -0,0 +1,38 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "PortSettings.h"
+
+#include "serial/ResetSequence.h"
+
+#include <QSettings>
+
+FlowControl PortSettings::effectiveFlowControl() const
+{
+    if (flowControl == FlowControl::RtsCts &&
+        (!resetStrategy || ResetSequence::forStrategy(*resetStrategy).usesRts())) {
+        return FlowControl::None;
+    }
+    return flowControl;
+}
+
+PortSettings PortSettings::forPort(const SerialPort& port)
+{
+    QSettings settings;
+    settings.beginGroup(groupFor(port));
+
+    PortSettings result;
+    if (auto mode = flowControlFromName(settings.value("flowControl").toString())) {
+        result.flowControl = *mode;
+    }
+    result.resetStrategy = resetStrategyFromName(settings.value("resetStrategy").toString());
+    return result;
+}
+
+QString PortSettings::groupFor(const SerialPort& port)
+{
+    // Serial numbers and paths may contain characters QSettings treats specially
+    const QString key = port.serialNumber.isEmpty() ? port.path : port.serialNumber;
+    return QString("PortSettings/%1").arg(QString::fromLatin1(key.toUtf8().toHex()));
+}
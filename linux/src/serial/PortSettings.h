@@ -0,0 +1,40 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef PORTSETTINGS_H
+#define PORTSETTINGS_H
+
+#include "models/SerialPort.h"
+
+#include <QString>
+#include <optional>
+
+/**
+ * How a fixture is wired to one port, as set up by the user
+ *
+ * Read from QSettings "PortSettings/<serial number>", hex-encoded like
+ * DeviceProfiles, or by port path for ports without a serial number:
+ *   flowControl    "none" (default) or "rts-cts"
+ *   resetStrategy  reset strategy name, tried on its own instead of
+ *                  escalating through the defaults for the port
+ * RTS/CTS is only used with a reset strategy whose sequence leaves RTS
+ * alone: "external", or one overridden in ResetSequences/ with DTR
+ * changes and waits only. The default sequences reset the chip via RTS.
+ */
+struct PortSettings {
+    FlowControl flowControl = FlowControl::None;
+    std::optional<ResetStrategy> resetStrategy;
+
+    /**
+     * flowControl, unless the reset needs RTS
+     */
+    FlowControl effectiveFlowControl() const;
+
+    static PortSettings forPort(const SerialPort& port);
+
+private:
+    static QString groupFor(const SerialPort& port);
+};
+
+#endif // PORTSETTINGS_H
@@ -0,0 +1,227 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "ResetSequence.h"
+#include "SerialConnection.h"
+
+#include <QSettings>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <chrono>
+
+namespace {
+
+std::optional<bool> parseLineState(const QString& text)
+{
+    if (text == "0") return false;
+    if (text == "1") return true;
+    return std::nullopt;
+}
+
+} // anonymous namespace
+
+std::optional<ResetSequence> ResetSequence::parse(const QString& spec)
+{
+    ResetSequence sequence;
+
+    const QStringList commands = spec.split('|', Qt::SkipEmptyParts);
+    for (const QString& rawCommand : commands) {
+        QString command = rawCommand.trimmed();
+        if (command.isEmpty()) {
+            continue;
+        }
+
+        QChar op = command.at(0).toUpper();
+        QString argument = command.mid(1);
+        ResetStep step;
+
+        if (op == 'D' || op == 'R') {
+            auto state = parseLineState(argument);
+            if (!state) {
+                return std::nullopt;
+            }
+            step.kind = (op == 'D') ? ResetStep::SetDTR : ResetStep::SetRTS;
+            step.dtr = *state;
+            step.rts = *state;
+        } else if (op == 'U') {
+            QStringList states = argument.split(',');
+            if (states.size() != 2) {
+                return std::nullopt;
+            }
+            auto dtr = parseLineState(states[0].trimmed());
+            auto rts = parseLineState(states[1].trimmed());
+            if (!dtr || !rts) {
+                return std::nullopt;
+            }
+            step.kind = ResetStep::SetDTRRTS;
+            step.dtr = *dtr;
+            step.rts = *rts;
+        } else if (op == 'W') {
+            bool ok = false;
+            double seconds = argument.toDouble(&ok);
+            if (!ok || seconds < 0) {
+                return std::nullopt;
+            }
+            step.kind = ResetStep::Wait;
+            step.waitMs = static_cast<int>(std::lround(seconds * 1000.0));
+        } else {
+            return std::nullopt;
+        }
+
+        sequence.m_steps.push_back(step);
+    }
+
+    if (sequence.isEmpty()) {
+        return std::nullopt;
+    }
+    return sequence;
+}
+
+ResetSequence ResetSequence::forStrategy(ResetStrategy strategy)
+{
+    QSettings settings;
+    QString key = QString("ResetSequences/%1").arg(resetStrategyName(strategy));
+    QString custom = settings.value(key).toString();
+
+    if (!custom.isEmpty()) {
+        if (auto sequence = parse(custom)) {
+            return *sequence;
+        }
+    }
+
+    switch (strategy) {
+    case ResetStrategy::USBJTAGSerial: return usbJtagSerial();
+    case ResetStrategy::Classic: return classic();
+    case ResetStrategy::UnixTight: return unixTight();
+    case ResetStrategy::External: return external();
+    }
+    return classic();
+}
+
+ResetSequence ResetSequence::usbJtagSerial()
+{
+    // USBJTAGSerialReset sequence - exact match of esptool implementation
+    // For ESP32-C3/S3 with native USB-JTAG-Serial peripheral
+    // Source: esptool/reset.py USBJTAGSerialReset class
+    //
+    // The USB-JTAG-Serial peripheral on ESP32-C3 monitors DTR/RTS signals
+    // in a specific way that's different from classic USB-UART bridges.
+    //
+    //   R0|D0|W0.1   Idle - both lines deasserted
+    //   D1|R0|W0.1   Set IO0 (GPIO9 low for boot mode)
+    //   R1|D0|R1     Assert reset, release IO0 (RTS set twice: Windows
+    //   W0.1         driver only propagates DTR on RTS setting)
+    //   D0|R0        Chip out of reset
+    //   W0.05        USB-JTAG-Serial peripheral reinitializes
+    return *parse("R0|D0|W0.1|D1|R0|W0.1|R1|D0|R1|W0.1|D0|R0|W0.05");
+}
+
+ResetSequence ResetSequence::classic()
+{
+    // Classic reset sequence from esptool (ClassicReset)
+    // For ESP32 with USB-UART bridge (CP2102, CH340, etc.)
+    // The bridge circuit typically has:
+    // - DTR -> GPIO0 (inverted)
+    // - RTS -> EN (inverted)
+    //
+    //   U0,1|W0.1    EN=LOW (chip in reset), GPIO0=HIGH
+    //   U1,0|W0.05   GPIO0=LOW, EN=HIGH - chip boots into bootloader
+    //   D0|W0.05     Release boot pin
+    return *parse("U0,1|W0.1|U1,0|W0.05|D0|W0.05");
+}
+
+ResetSequence ResetSequence::external()
+{
+    // The fixture drives EN and the boot pin itself (e.g. through a GPIO
+    // expander), so the lines are left alone and RTS is free for flow
+    // control; the wait gives the fixture's reset time to finish before
+    // the SYNC probes start
+    return *parse("W0.05");
+}
+
+bool ResetSequence::usesRts() const
+{
+    return std::any_of(m_steps.begin(), m_steps.end(), [](const ResetStep& step) {
+        return step.kind == ResetStep::SetRTS || step.kind == ResetStep::SetDTRRTS;
+    });
+}
+
+ResetSequence ResetSequence::unixTight()
+{
+    // UnixTightReset from esptool - sets DTR and RTS in a single ioctl
+    // pair so the chip never sees the intermediate state. Works with
+    // bridges whose drivers glitch EN when the lines change separately.
+    //
+    //   U0,0|U1,1    Idle, then both asserted
+    //   U0,1|W0.1    IO0=HIGH, EN=LOW (chip in reset)
+    //   U1,0|W0.05   IO0=LOW, EN=HIGH (chip out of reset)
+    //   U0,0|D0      IO0=HIGH, done
+    return *parse("U0,0|U1,1|U0,1|W0.1|U1,0|W0.05|U0,0|D0");
+}
+
+ResetSequence ResetSequence::scaled(double factor) const
+{
+    ResetSequence result = *this;
+    for (ResetStep& step : result.m_steps) {
+        if (step.kind == ResetStep::Wait) {
+            step.waitMs = static_cast<int>(std::lround(step.waitMs * factor));
+        }
+    }
+    return result;
+}
+
+void ResetSequence::run(SerialConnection& connection) const
+{
+    for (const ResetStep& step : m_steps) {
+        switch (step.kind) {
+        case ResetStep::SetDTR:
+            connection.setDTR(step.dtr);
+            break;
+        case ResetStep::SetRTS:
+            connection.setRTS(step.rts);
+            break;
+        case ResetStep::SetDTRRTS:
+            connection.setDTRRTS(step.dtr, step.rts);
+            break;
+        case ResetStep::Wait:
+            std::this_thread::sleep_for(std::chrono::milliseconds(step.waitMs));
+            break;
+        }
+    }
+}
+
+QString ResetSequence::toString() const
+{
+    QStringList commands;
+    for (const ResetStep& step : m_steps) {
+        switch (step.kind) {
+        case ResetStep::SetDTR:
+            commands.append(QString("D%1").arg(step.dtr ? 1 : 0));
+            break;
+        case ResetStep::SetRTS:
+            commands.append(QString("R%1").arg(step.rts ? 1 : 0));
+            break;
+        case ResetStep::SetDTRRTS:
+            commands.append(QString("U%1,%2").arg(step.dtr ? 1 : 0).arg(step.rts ? 1 : 0));
+            break;
+        case ResetStep::Wait:
+            commands.append(QString("W%1").arg(step.waitMs / 1000.0));
+            break;
+        }
+    }
+    return commands.join('|');
+}
+
+int ResetSequence::totalWaitMs() const
+{
+    int total = 0;
+    for (const ResetStep& step : m_steps) {
+        if (step.kind == ResetStep::Wait) {
+            total += step.waitMs;
+        }
+    }
+    return total;
+}
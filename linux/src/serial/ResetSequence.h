@@ -0,0 +1,104 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef RESETSEQUENCE_H
+#define RESETSEQUENCE_H
+
+#include "models/SerialPort.h"
+
+#include <QString>
+#include <optional>
+#include <vector>
+
+class SerialConnection;
+
+/**
+ * A single DTR/RTS line change or wait
+ */
+struct ResetStep {
+    enum Kind {
+        SetDTR,
+        SetRTS,
+        SetDTRRTS,
+        Wait
+    };
+
+    Kind kind = Wait;
+    bool dtr = false;
+    bool rts = false;
+    int waitMs = 0;
+};
+
+/**
+ * Configurable DTR/RTS reset sequence
+ * Uses esptool's custom reset sequence syntax so sequences can be copied
+ * between tools: commands separated by '|', where
+ *   D0/D1     set DTR
+ *   R0/R1     set RTS
+ *   U0,1      set DTR and RTS together
+ *   W0.1      wait 0.1 seconds
+ * Example (classic reset): "U0,1|W0.1|U1,0|W0.05|D0|W0.05"
+ */
+class ResetSequence {
+public:
+    ResetSequence() = default;
+
+    /**
+     * Parse a sequence in esptool syntax
+     * @param spec Sequence string
+     * @return Parsed sequence, or nullopt if the string is malformed
+     */
+    static std::optional<ResetSequence> parse(const QString& spec);
+
+    /**
+     * Default sequence for a strategy, honouring any override stored in
+     * QSettings under "ResetSequences/<strategy name>"
+     */
+    static ResetSequence forStrategy(ResetStrategy strategy);
+
+    /**
+     * Built-in sequences matching esptool's reset.py
+     */
+    static ResetSequence usbJtagSerial();
+    static ResetSequence classic();
+    static ResetSequence unixTight();
+
+    /**
+     * For fixtures that reset the chip without DTR/RTS: only a short wait
+     */
+    static ResetSequence external();
+
+    /**
+     * Copy of this sequence with every wait multiplied by factor
+     */
+    ResetSequence scaled(double factor) const;
+
+    /**
+     * Run the sequence on an open connection
+     */
+    void run(SerialConnection& connection) const;
+
+    /**
+     * Serialize back to esptool syntax
+     */
+    QString toString() const;
+
+    /**
+     * Sum of all waits in the sequence
+     */
+    int totalWaitMs() const;
+
+    /**
+     * Whether any step drives RTS (which hardware flow control owns)
+     */
+    bool usesRts() const;
+
+    const std::vector<ResetStep>& steps() const { return m_steps; }
+    bool isEmpty() const { return m_steps.empty(); }
+
+private:
+    std::vector<ResetStep> m_steps;
+};
+
+#endif // RESETSEQUENCE_H
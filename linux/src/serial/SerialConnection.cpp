@@ -4,21 +4,42 @@
 
 #include "SerialConnection.h"
 
+#include <QStringList>
+
 #include <fcntl.h>
 #include <unistd.h>
 #include <termios.h>
 #include <sys/ioctl.h>
 #include <sys/file.h>
 #include <sys/select.h>
+#include <poll.h>
 #include <cerrno>
 #include <cstring>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <iterator>
 
 #ifdef Q_OS_LINUX
 #include <linux/serial.h>
 #endif
 
+namespace {
+
+struct StandardRate {
+    int rate;
+    speed_t constant;
+};
+
+const StandardRate kStandardRates[] = {
+    {9600, B9600}, {19200, B19200}, {38400, B38400}, {57600, B57600},
+    {115200, B115200}, {230400, B230400}, {460800, B460800},
+    {500000, B500000}, {576000, B576000}, {921600, B921600},
+    {1000000, B1000000}, {1500000, B1500000}, {2000000, B2000000},
+};
+
+} // anonymous namespace
+
 QString SerialError::errorDescription(Type type, int errorCode)
 {
     switch (type) {
@@ -88,8 +109,12 @@ void SerialConnection::open(const QString& path)
     // This is important for USB-JTAG-Serial devices
     options.c_cflag &= ~HUPCL;
 
-    // Disable hardware flow control (CRTSCTS)
-    options.c_cflag &= ~CRTSCTS;
+    // Hardware flow control only where the reset doesn't need RTS
+    if (m_flowControl == FlowControl::RtsCts) {
+        options.c_cflag |= CRTSCTS;
+    } else {
+        options.c_cflag &= ~CRTSCTS;
+    }
 
     // Disable software flow control
     options.c_iflag &= ~(IXON | IXOFF | IXANY);
@@ -109,6 +134,18 @@ void SerialConnection::open(const QString& path)
     tcflush(m_fd, TCIOFLUSH);
 }
 
+bool SerialConnection::isHungUp() const
+{
+    if (m_fd < 0) {
+        return true;
+    }
+
+    // Hang-up and error conditions are reported even with no events requested
+    pollfd descriptor{m_fd, 0, 0};
+    return ::poll(&descriptor, 1, 0) > 0 &&
+           (descriptor.revents & (POLLHUP | POLLERR | POLLNVAL));
+}
+
 void SerialConnection::close()
 {
     if (m_fd >= 0) {
@@ -142,6 +179,93 @@ void SerialConnection::setBaudRate(BaudRate rate)
     tcflush(m_fd, TCIOFLUSH);
 }
 
+void SerialConnection::setBaudRate(int rate)
+{
+    if (std::optional<BaudRate> flashRate = baudRateFromValue(rate)) {
+        setBaudRate(*flashRate);
+        return;
+    }
+
+    if (m_fd < 0) {
+        throw SerialError(SerialError::NotConnected);
+    }
+
+    auto standard = std::find_if(std::begin(kStandardRates), std::end(kStandardRates),
+                                 [rate](const StandardRate& s) { return s.rate == rate; });
+    if (standard == std::end(kStandardRates)) {
+        throw SerialError(SerialError::InvalidConfiguration);
+    }
+
+    struct termios options;
+    tcgetattr(m_fd, &options);
+    cfsetispeed(&options, standard->constant);
+    cfsetospeed(&options, standard->constant);
+    if (tcsetattr(m_fd, TCSANOW, &options) != 0) {
+        throw SerialError(SerialError::InvalidConfiguration);
+    }
+    tcflush(m_fd, TCIOFLUSH);
+}
+
+std::vector<int> SerialConnection::supportedBaudRates()
+{
+    std::vector<int> rates;
+    for (const StandardRate& standard : kStandardRates) {
+        rates.push_back(standard.rate);
+    }
+    return rates;
+}
+
+SerialErrorCounters SerialErrorCounters::since(const SerialErrorCounters& earlier) const
+{
+    auto delta = [](uint64_t now, uint64_t then) { return now >= then ? now - then : now; };
+
+    SerialErrorCounters counters;
+    counters.received = delta(received, earlier.received);
+    counters.frame = delta(frame, earlier.frame);
+    counters.overrun = delta(overrun, earlier.overrun);
+    counters.parity = delta(parity, earlier.parity);
+    counters.breaks = delta(breaks, earlier.breaks);
+    counters.bufferOverrun = delta(bufferOverrun, earlier.bufferOverrun);
+    return counters;
+}
+
+QString SerialErrorCounters::describe() const
+{
+    QStringList parts;
+    if (frame > 0) {
+        parts.append(QString("%1 framing").arg(frame));
+    }
+    if (overrun > 0) {
+        parts.append(QString("%1 overrun").arg(overrun));
+    }
+    if (parity > 0) {
+        parts.append(QString("%1 parity").arg(parity));
+    }
+    if (bufferOverrun > 0) {
+        parts.append(QString("%1 buffer overrun").arg(bufferOverrun));
+    }
+    return parts.join(", ");
+}
+
+std::optional<SerialErrorCounters> SerialConnection::errorCounters() const
+{
+#ifdef Q_OS_LINUX
+    struct serial_icounter_struct counts;
+    std::memset(&counts, 0, sizeof(counts));
+    if (m_fd >= 0 && ioctl(m_fd, TIOCGICOUNT, &counts) == 0) {
+        SerialErrorCounters counters;
+        counters.received = static_cast<uint32_t>(counts.rx);
+        counters.frame = static_cast<uint32_t>(counts.frame);
+        counters.overrun = static_cast<uint32_t>(counts.overrun);
+        counters.parity = static_cast<uint32_t>(counts.parity);
+        counters.breaks = static_cast<uint32_t>(counts.brk);
+        counters.bufferOverrun = static_cast<uint32_t>(counts.buf_overrun);
+        return counters;
+    }
+#endif
+    return std::nullopt;
+}
+
 void SerialConnection::write(const QByteArray& data)
 {
     if (m_fd < 0) {
@@ -150,6 +274,7 @@ void SerialConnection::write(const QByteArray& data)
 
     int totalWritten = 0;
     int count = data.size();
+    int stalledMs = 0;
 
     while (totalWritten < count) {
         ssize_t result = ::write(
@@ -161,6 +286,9 @@ void SerialConnection::write(const QByteArray& data)
         if (result < 0) {
             // With O_NONBLOCK, EAGAIN means buffer is full, retry
             if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (++stalledMs > WRITE_STALL_MS) {
+                    throw SerialError(SerialError::Timeout);
+                }
                 // Brief delay then retry
                 usleep(1000); // 1ms
                 continue;
@@ -169,6 +297,7 @@ void SerialConnection::write(const QByteArray& data)
         }
 
         totalWritten += result;
+        stalledMs = 0;
     }
 
     // Note: We don't call tcdrain() here anymore as it can cause issues
@@ -213,6 +342,12 @@ QByteArray SerialConnection::read(double timeout)
         throw SerialError(SerialError::ReadFailed, errno);
     }
 
+    if (bytesRead == 0) {
+        // Readable but no data is a hang-up: the device went away
+        // (e.g. USB-JTAG-Serial re-enumerating after a chip reset)
+        throw SerialError(SerialError::ReadFailed, EIO);
+    }
+
     return QByteArray(buffer, bytesRead);
 }
 
@@ -246,6 +381,10 @@ void SerialConnection::setRTS(bool value)
         throw SerialError(SerialError::NotConnected);
     }
 
+    if (m_flowControl == FlowControl::RtsCts) {
+        throw SerialError(SerialError::InvalidConfiguration);
+    }
+
     int bits = TIOCM_RTS;
 
     if (value) {
@@ -263,6 +402,10 @@ void SerialConnection::setDTRRTS(bool dtr, bool rts)
         throw SerialError(SerialError::NotConnected);
     }
 
+    if (m_flowControl == FlowControl::RtsCts) {
+        throw SerialError(SerialError::InvalidConfiguration);
+    }
+
     // Set DTR
     int dtrBits = TIOCM_DTR;
     if (dtr) {
@@ -280,88 +423,40 @@ void SerialConnection::setDTRRTS(bool dtr, bool rts)
     }
 }
 
-void SerialConnection::enterBootloaderMode(bool isUSBJTAGSerial)
+void SerialConnection::setFlowControl(FlowControl mode)
 {
-    if (isUSBJTAGSerial) {
-        // USB-JTAG-Serial reset (for ESP32-C3/S3 with native USB)
-        // esptool uses ONLY this strategy for USB-JTAG-Serial devices
-        usbJtagSerialReset();
-    } else {
-        // Classic reset for USB-UART bridges (CP2102, CH340, etc.)
-        classicReset();
+    m_flowControl = mode;
+    if (m_fd < 0) {
+        return;
     }
 
-    flush();
+    struct termios options;
+    tcgetattr(m_fd, &options);
+    if (mode == FlowControl::RtsCts) {
+        options.c_cflag |= CRTSCTS;
+    } else {
+        options.c_cflag &= ~CRTSCTS;
+    }
+    if (tcsetattr(m_fd, TCSANOW, &options) != 0) {
+        throw SerialError(SerialError::InvalidConfiguration, errno);
+    }
 }
 
-void SerialConnection::usbJtagSerialReset()
+void SerialConnection::enterBootloaderMode(ResetStrategy strategy)
 {
-    // USBJTAGSerialReset sequence - exact match of esptool implementation
-    // For ESP32-C3/S3 with native USB-JTAG-Serial peripheral
-    // Source: esptool/reset.py USBJTAGSerialReset class
-    //
-    // The USB-JTAG-Serial peripheral on ESP32-C3 monitors DTR/RTS signals
-    // in a specific way that's different from classic USB-UART bridges.
-    //
-    // Exact esptool sequence from reset.py:
-    // self._setRTS(False)
-    // self._setDTR(False)  # Idle
-    // time.sleep(0.1)
-    // self._setDTR(True)   # Set IO0
-    // self._setRTS(False)
-    // time.sleep(0.1)
-    // self._setRTS(True)   # Reset
-    // self._setDTR(False)
-    // self._setRTS(True)   # RTS set as Windows only propagates DTR on RTS setting
-    // time.sleep(0.1)
-    // self._setDTR(False)
-    // self._setRTS(False)  # Chip out of reset
-
-    // Step 1: Idle state - both lines deasserted
-    setRTS(false);
-    setDTR(false);
-    sleepMs(100);
-
-    // Step 2: Set IO0 (GPIO9 low for boot mode)
-    setDTR(true);
-    setRTS(false);
-    sleepMs(100);
-
-    // Step 3: Reset sequence
-    setRTS(true);   // Assert reset
-    setDTR(false);  // Release IO0
-    setRTS(true);   // Set RTS again (Windows driver quirk)
-    sleepMs(100);
-
-    // Step 4: Chip out of reset - both lines deasserted
-    setDTR(false);
-    setRTS(false);
-
-    // Give the chip time to start the bootloader
-    // The USB-JTAG-Serial peripheral needs time to reinitialize
-    sleepMs(50);
+    // esptool uses only one reset strategy per device type:
+    // USB-JTAG-Serial reset for ESP32-C3/S3 with native USB,
+    // classic reset for USB-UART bridges (CP2102, CH340, etc.)
+    enterBootloaderMode(ResetSequence::forStrategy(strategy));
 }
 
-void SerialConnection::classicReset()
+void SerialConnection::enterBootloaderMode(const ResetSequence& sequence)
 {
-    // Classic reset sequence from esptool (ClassicReset)
-    // For ESP32 with USB-UART bridge (CP2102, CH340, etc.)
-    // The bridge circuit typically has:
-    // - DTR -> GPIO0 (inverted)
-    // - RTS -> EN (inverted)
-
-    // Step 1: Assert RTS (EN=LOW, chip in reset), deassert DTR (GPIO0=HIGH)
-    setDTRRTS(false, true);
-    sleepMs(100);
-
-    // Step 2: Assert DTR (GPIO0=LOW for boot mode), deassert RTS (EN=HIGH, run)
-    // Chip comes out of reset with GPIO0 low -> bootloader mode
-    setDTRRTS(true, false);
-    sleepMs(50);
-
-    // Step 3: Deassert DTR (GPIO0=HIGH, release boot pin)
-    setDTR(false);
-    sleepMs(50);
+    // Drop stale application output before the reset, not after it:
+    // the ROM boot banner arrives during the sequence's final wait and
+    // tells the caller whether download mode was entered
+    flush();
+    sequence.run(*this);
 }
 
 void SerialConnection::hardReset()
@@ -6,9 +6,13 @@
 #define SERIALCONNECTION_H
 
 #include "models/SerialPort.h"
+#include "serial/ResetSequence.h"
 #include <QString>
 #include <QByteArray>
+#include <cstdint>
+#include <optional>
 #include <stdexcept>
+#include <vector>
 
 /**
  * Errors that can occur during serial communication
@@ -40,6 +44,35 @@ private:
     int m_errorCode;
 };
 
+/**
+ * Line error counts the UART driver keeps (TIOCGICOUNT), since the port
+ * was opened. Only differences between two readings mean anything.
+ */
+struct SerialErrorCounters {
+    uint64_t received = 0;
+    uint64_t frame = 0;         // Bad stop bit: usually the wrong baud rate
+    uint64_t overrun = 0;       // UART FIFO overflowed before it was read
+    uint64_t parity = 0;
+    uint64_t breaks = 0;
+    uint64_t bufferOverrun = 0; // Kernel tty buffer overflowed
+
+    /**
+     * Errors that cost data: everything but breaks
+     */
+    uint64_t lineErrors() const { return frame + overrun + parity + bufferOverrun; }
+
+    /**
+     * Counts since an earlier reading; a counter that went backwards was
+     * reset (the port was reopened) and counts from zero
+     */
+    SerialErrorCounters since(const SerialErrorCounters& earlier) const;
+
+    /**
+     * e.g. "3 framing, 1 overrun"; empty if there are no line errors
+     */
+    QString describe() const;
+};
+
 /**
  * POSIX-based serial port connection
  * Matches macOS SerialConnection.swift implementation exactly
@@ -55,6 +88,18 @@ public:
 
     bool isConnected() const { return m_fd >= 0; }
 
+    /**
+     * Underlying file descriptor (-1 when closed), for readers that wait on
+     * the port themselves (see SerialReader)
+     */
+    int fileDescriptor() const { return m_fd; }
+
+    /**
+     * The device behind the open fd has gone away (e.g. USB re-enumeration
+     * after a reset); the fd will never deliver data again
+     */
+    bool isHungUp() const;
+
     /**
      * Open a serial port
      * @param path Path to the serial port (e.g., /dev/ttyUSB0)
@@ -72,6 +117,23 @@ public:
      */
     void setBaudRate(BaudRate rate);
 
+    /**
+     * Set any standard rate from 9600 up (the monitor isn't limited to
+     * the flashing rates); throws SerialError if there is no such rate
+     */
+    void setBaudRate(int rate);
+
+    /**
+     * Standard rates setBaudRate(int) accepts, slowest first
+     */
+    static std::vector<int> supportedBaudRates();
+
+    /**
+     * Driver's line error counters, if it keeps them (USB-UART bridges
+     * do; native USB serial has no line to have errors on)
+     */
+    std::optional<SerialErrorCounters> errorCounters() const;
+
     /**
      * Write data to the serial port
      * @param data Data to write
@@ -100,44 +162,48 @@ public:
     /**
      * Set RTS (Request To Send) line state
      * Uses TIOCMBIS/TIOCMBIC like pyserial for better compatibility
+     * Throws SerialError while RTS/CTS flow control owns the line.
      * @param value true to assert, false to deassert
      */
     void setRTS(bool value);
 
     /**
      * Set both DTR and RTS simultaneously
+     * Throws SerialError while RTS/CTS flow control owns RTS.
      * @param dtr DTR state
      * @param rts RTS state
      */
     void setDTRRTS(bool dtr, bool rts);
 
     /**
-     * Enter bootloader mode using DTR/RTS reset sequence
-     * @param isUSBJTAGSerial If true, uses USB-JTAG-Serial reset (ESP32-C3/S3 native USB).
-     *                        If false, uses classic reset (USB-UART bridges).
+     * Hardware flow control; off unless set
+     * RTS/CTS hands RTS to the driver, so reset sequences that drive RTS
+     * can't run. Applies now if the port is open, else from open().
      */
-    void enterBootloaderMode(bool isUSBJTAGSerial = true);
+    void setFlowControl(FlowControl mode);
+    FlowControl flowControl() const { return m_flowControl; }
 
     /**
-     * Perform a hard reset to run the newly flashed firmware
-     * For USB-JTAG-Serial devices, this triggers a proper chip reset
-     * that will start the application (not bootloader mode)
+     * Enter bootloader mode using DTR/RTS reset sequence
+     * @param strategy USBJTAGSerial for ESP32-C3/S3 native USB,
+     *                 Classic for USB-UART bridges
      */
-    void hardReset();
+    void enterBootloaderMode(ResetStrategy strategy = ResetStrategy::USBJTAGSerial);
 
-private:
     /**
-     * USBJTAGSerialReset sequence - exact match of esptool implementation
-     * For ESP32-C3/S3 with native USB-JTAG-Serial peripheral
+     * Enter bootloader mode using an explicit reset sequence
+     * @param sequence DTR/RTS sequence to run (see ResetSequence)
      */
-    void usbJtagSerialReset();
+    void enterBootloaderMode(const ResetSequence& sequence);
 
     /**
-     * Classic reset sequence from esptool (ClassicReset)
-     * For ESP32 with USB-UART bridge (CP2102, CH340, etc.)
+     * Perform a hard reset to run the newly flashed firmware
+     * For USB-JTAG-Serial devices, this triggers a proper chip reset
+     * that will start the application (not bootloader mode)
      */
-    void classicReset();
+    void hardReset();
 
+private:
     /**
      * Sleep for milliseconds
      */
@@ -145,6 +211,11 @@ private:
 
     int m_fd = -1;
     BaudRate m_currentBaudRate = BaudRate::Baud115200;
+    FlowControl m_flowControl = FlowControl::None;
+
+    // A write that can't get a byte out for this long has stalled, e.g.
+    // on a peer holding CTS off
+    static constexpr int WRITE_STALL_MS = 2000;
 };
 
 #endif // SERIALCONNECTION_H
@@ -42,12 +42,34 @@ SerialPortManager::~SerialPortManager()
     }
 }
 
-void SerialPortManager::refreshPorts()
+void SerialPortManager::refreshPorts(const QStringList& cycledPaths)
 {
     m_isScanning = true;
+    std::vector<SerialPort> previous = std::move(m_availablePorts);
     m_availablePorts = enumeratePorts();
     m_isScanning = false;
     emit portsChanged();
+
+    // A node handed to a different device, or removed and added again
+    // between two refreshes, is a new port
+    auto contains = [&cycledPaths](const std::vector<SerialPort>& ports, const SerialPort& port) {
+        if (cycledPaths.contains(port.path)) {
+            return false;
+        }
+        return std::any_of(ports.begin(), ports.end(), [&port](const SerialPort& other) {
+            return other.path == port.path && other.serialNumber == port.serialNumber;
+        });
+    };
+    for (const SerialPort& port : previous) {
+        if (!contains(m_availablePorts, port)) {
+            emit portRemoved(port.path);
+        }
+    }
+    for (const SerialPort& port : m_availablePorts) {
+        if (!contains(previous, port)) {
+            emit portAdded(port);
+        }
+    }
 }
 
 std::vector<SerialPort> SerialPortManager::enumeratePorts()
@@ -95,6 +117,7 @@ std::vector<SerialPort> SerialPortManager::enumeratePorts()
 
         int vendorId = -1;
         int productId = -1;
+        QString serialNumber;
         QString deviceName;
 
         if (usbDevice) {
@@ -102,6 +125,7 @@ std::vector<SerialPort> SerialPortManager::enumeratePorts()
             const char* pidStr = udev_device_get_sysattr_value(usbDevice, "idProduct");
             const char* product = udev_device_get_sysattr_value(usbDevice, "product");
             const char* manufacturer = udev_device_get_sysattr_value(usbDevice, "manufacturer");
+            const char* serial = udev_device_get_sysattr_value(usbDevice, "serial");
 
             if (vidStr) {
                 vendorId = QString::fromUtf8(vidStr).toInt(nullptr, 16);
@@ -109,6 +133,9 @@ std::vector<SerialPort> SerialPortManager::enumeratePorts()
             if (pidStr) {
                 productId = QString::fromUtf8(pidStr).toInt(nullptr, 16);
             }
+            if (serial) {
+                serialNumber = QString::fromUtf8(serial).trimmed();
+            }
 
             // Build device name
             if (manufacturer && product) {
@@ -131,6 +158,7 @@ std::vector<SerialPort> SerialPortManager::enumeratePorts()
         port.path = devicePath;
         port.vendorId = vendorId;
         port.productId = productId;
+        port.serialNumber = serialNumber;
 
         ports.push_back(port);
 
@@ -206,6 +234,18 @@ void SerialPortManager::startObserving()
         }
     }
 
+    // React to udev events as they arrive, so a device coming back after
+    // a reset can be reopened right away
+    if (m_monitorFd >= 0) {
+        if (!m_monitorNotifier) {
+            m_monitorNotifier = new QSocketNotifier(m_monitorFd, QSocketNotifier::Read, this);
+            connect(m_monitorNotifier, &QSocketNotifier::activated,
+                    this, &SerialPortManager::checkForDeviceChanges);
+        }
+        m_monitorNotifier->setEnabled(true);
+        return;
+    }
+
     // Start polling timer (500ms interval)
     if (!m_pollTimer->isActive()) {
         m_pollTimer->start(500);
@@ -214,6 +254,9 @@ void SerialPortManager::startObserving()
 
 void SerialPortManager::stopObserving()
 {
+    if (m_monitorNotifier) {
+        m_monitorNotifier->setEnabled(false);
+    }
     if (m_pollTimer && m_pollTimer->isActive()) {
         m_pollTimer->stop();
     }
@@ -236,7 +279,9 @@ void SerialPortManager::checkForDeviceChanges()
     int result = select(m_monitorFd + 1, &readSet, nullptr, nullptr, &tv);
 
     if (result > 0 && FD_ISSET(m_monitorFd, &readSet)) {
-        // Process all pending events
+        // Process all pending events, then rescan once
+        bool changed = false;
+        QStringList removed;
         while (true) {
             struct udev_device* device = udev_monitor_receive_device(m_monitor);
             if (!device) {
@@ -248,14 +293,20 @@ void SerialPortManager::checkForDeviceChanges()
                 QString actionStr = QString::fromUtf8(action);
                 if (actionStr == "add" || actionStr == "remove") {
                     // Device added or removed, refresh ports
-                    udev_device_unref(device);
-                    refreshPorts();
-                    return;
+                    changed = true;
+                }
+                const char* devNode = udev_device_get_devnode(device);
+                if (actionStr == "remove" && devNode) {
+                    removed.append(QString::fromUtf8(devNode));
                 }
             }
 
             udev_device_unref(device);
         }
+
+        if (changed) {
+            refreshPorts(removed);
+        }
     }
 }
 
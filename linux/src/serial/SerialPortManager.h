@@ -7,6 +7,8 @@
 
 #include "models/SerialPort.h"
 #include <QObject>
+#include <QStringList>
+#include <QSocketNotifier>
 #include <QTimer>
 #include <vector>
 
@@ -29,8 +31,10 @@ public:
 
     /**
      * Refresh the list of available serial ports
+     * @param cycledPaths Nodes udev removed since the last refresh; one
+     *                    that is back already is reported as re-added
      */
-    void refreshPorts();
+    void refreshPorts(const QStringList& cycledPaths = {});
 
     /**
      * Start observing for port connect/disconnect events
@@ -52,6 +56,13 @@ public:
 signals:
     void portsChanged();
 
+    /**
+     * A port appeared (including one coming back after a reset)
+     * Emitted as soon as udev announces it, with its permissions applied.
+     */
+    void portAdded(const SerialPort& port);
+    void portRemoved(const QString& path);
+
 private slots:
     void checkForDeviceChanges();
 
@@ -74,7 +85,9 @@ private:
     udev_monitor* m_monitor = nullptr;
     int m_monitorFd = -1;
 
-    // Polling timer for device changes
+    // Wakes us on udev events; the timer polls only when udev monitoring
+    // isn't available
+    QSocketNotifier* m_monitorNotifier = nullptr;
     QTimer* m_pollTimer = nullptr;
 };
 
@@ -0,0 +1,300 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "SerialReader.h"
+#include "SerialConnection.h"
+
+#include <QMutexLocker>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// Port IDs start at 1, so 0 can mark the wake-up eventfd
+constexpr uint32_t WAKE_TAG = 0;
+
+// One read() per kernel wakeup is usually enough at this size
+constexpr size_t READ_CHUNK = 64 * 1024;
+
+constexpr int MAX_EVENTS = 32;
+
+struct ChunkHeader {
+    int64_t timestampNs;
+    uint32_t size;
+};
+
+} // anonymous namespace
+
+SerialReader::~SerialReader()
+{
+    stop();
+}
+
+int64_t SerialReader::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int SerialReader::addPort(int fd)
+{
+    if (!m_thread.joinable()) {
+        startThread();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    int portId = m_nextPortId++;
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u32 = static_cast<uint32_t>(portId);
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        throw SerialError(SerialError::ReadFailed, errno);
+    }
+
+    m_ports[portId] = std::make_shared<Port>(fd);
+    return portId;
+}
+
+void SerialReader::removePort(int portId)
+{
+    std::shared_ptr<Port> port;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_ports.find(portId);
+        if (it == m_ports.end()) {
+            return;
+        }
+        port = std::move(it->second);
+        m_ports.erase(it);
+    }
+
+    // Waits for a drain of this port that is under way
+    QMutexLocker drain(&port->drainMutex);
+
+    // A failed port was already taken out of the wait set
+    if (!port->failed) {
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, port->fd, nullptr);
+    }
+    port->removed = true;
+}
+
+void SerialReader::stop()
+{
+    if (m_thread.joinable()) {
+        uint64_t one = 1;
+        ssize_t ignored = ::write(m_wakeFd, &one, sizeof(one));
+        (void)ignored;
+        m_thread.join();
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_ports.clear();
+    }
+
+    if (m_wakeFd >= 0) {
+        ::close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+    if (m_epollFd >= 0) {
+        ::close(m_epollFd);
+        m_epollFd = -1;
+    }
+}
+
+std::vector<SerialReader::Chunk> SerialReader::take(int portId)
+{
+    std::vector<Chunk> chunks;
+
+    // Only the GUI thread adds and removes ports, and it is the one
+    // calling take(), so the port can't go away while it is read here;
+    // the ring is single-producer single-consumer, so no lock either
+    Port* port = find(portId);
+    if (!port) {
+        return chunks;
+    }
+
+    ChunkHeader header;
+    while (port->ring.available() >= sizeof(header)) {
+        port->ring.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+        Chunk chunk;
+        chunk.timestampNs = header.timestampNs;
+        chunk.data.resize(static_cast<int>(header.size));
+        port->ring.read(chunk.data.data(), header.size);
+        chunks.push_back(std::move(chunk));
+    }
+    return chunks;
+}
+
+bool SerialReader::hasFailed(int portId) const
+{
+    Port* port = find(portId);
+    return port && port->failed;
+}
+
+int SerialReader::errorCode(int portId) const
+{
+    Port* port = find(portId);
+    return port ? port->errorCode.load() : 0;
+}
+
+uint64_t SerialReader::droppedBytes(int portId) const
+{
+    Port* port = find(portId);
+    return port ? port->droppedBytes.load() : 0;
+}
+
+void SerialReader::addSink(int portId, ByteSink* sink)
+{
+    if (Port* port = find(portId)) {
+        QMutexLocker drain(&port->drainMutex);
+        if (std::find(port->sinks.begin(), port->sinks.end(), sink) == port->sinks.end()) {
+            port->sinks.push_back(sink);
+        }
+    }
+}
+
+void SerialReader::removeSink(int portId, ByteSink* sink)
+{
+    // The worker holds the port's drain lock while it calls sinks, so it
+    // can't be mid-call once this has the lock
+    if (Port* port = find(portId)) {
+        QMutexLocker drain(&port->drainMutex);
+        port->sinks.erase(std::remove(port->sinks.begin(), port->sinks.end(), sink),
+                          port->sinks.end());
+    }
+}
+
+SerialReader::Port* SerialReader::find(int portId) const
+{
+    // GUI thread only: it is the only writer of m_ports
+    auto it = m_ports.find(portId);
+    return it == m_ports.end() ? nullptr : it->second.get();
+}
+
+void SerialReader::startThread()
+{
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    epoll_event wakeEvent{};
+    wakeEvent.events = EPOLLIN;
+    wakeEvent.data.u32 = WAKE_TAG;
+
+    if (m_epollFd < 0 || m_wakeFd < 0 ||
+        epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &wakeEvent) != 0) {
+        int error = errno;
+        stop();
+        throw SerialError(SerialError::ReadFailed, error);
+    }
+
+    m_thread = std::thread([this]() {
+        run();
+    });
+}
+
+void SerialReader::run()
+{
+    epoll_event events[MAX_EVENTS];
+
+    for (;;) {
+        int count = epoll_wait(m_epollFd, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // The wait set itself is broken; every port is lost
+            const int error = errno;
+            QMutexLocker locker(&m_mutex);
+            for (auto& entry : m_ports) {
+                QMutexLocker drain(&entry.second->drainMutex);
+                if (!entry.second->removed) {
+                    fail(*entry.second, error);
+                }
+            }
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.u32 == WAKE_TAG) {
+                return;
+            }
+
+            // The map lock covers only the lookup; the reads and sinks
+            // below run without it, so the GUI is never held up by them
+            std::shared_ptr<Port> port;
+            {
+                QMutexLocker locker(&m_mutex);
+                auto it = m_ports.find(static_cast<int>(events[i].data.u32));
+                if (it != m_ports.end()) {
+                    port = it->second;
+                }
+            }
+
+            // The port may have been removed since epoll_wait() returned
+            if (!port) {
+                continue;
+            }
+            QMutexLocker drain(&port->drainMutex);
+            if (port->removed || port->failed || !drainPort(*port)) {
+                continue;
+            }
+
+            // Hung up with nothing left to read; don't spin on the event
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                fail(*port, EIO);
+            }
+        }
+    }
+}
+
+bool SerialReader::drainPort(Port& port)
+{
+    char buffer[READ_CHUNK];
+
+    // Empty the kernel buffer completely before sleeping again
+    for (;;) {
+        ssize_t bytesRead = ::read(port.fd, buffer, sizeof(buffer));
+
+        if (bytesRead < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            fail(port, errno);
+            return false;
+        }
+
+        if (bytesRead == 0) {
+            // Readable but no data is a hang-up: the device went away
+            fail(port, EIO);
+            return false;
+        }
+
+        for (ByteSink* sink : port.sinks) {
+            sink->consume(buffer, static_cast<size_t>(bytesRead));
+        }
+
+        ChunkHeader header{now(), static_cast<uint32_t>(bytesRead)};
+        if (!port.ring.writeRecord(&header, sizeof(header), buffer, static_cast<size_t>(bytesRead))) {
+            port.droppedBytes += static_cast<uint64_t>(bytesRead);
+        }
+    }
+}
+
+void SerialReader::fail(Port& port, int errorCode)
+{
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, port.fd, nullptr);
+    port.errorCode = errorCode;
+    port.failed = true;
+}
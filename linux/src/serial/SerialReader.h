@@ -0,0 +1,147 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef SERIALREADER_H
+#define SERIALREADER_H
+
+#include "serial/ByteRing.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Receives a copy of everything a SerialReader reads, on the reader thread
+ * Implementations must not block (see LogCapture).
+ */
+class ByteSink {
+public:
+    virtual ~ByteSink() = default;
+    virtual void consume(const char* data, size_t size) = 0;
+};
+
+/**
+ * Background reader for any number of open serial ports
+ *
+ * One worker thread sleeps in epoll_wait() on every registered port and
+ * drains whatever the kernel has buffered into that port's lock-free ring
+ * as soon as it arrives, so a busy GUI thread can't make a tty buffer
+ * overflow. Each read is stamped with the monotonic clock, which lets
+ * output from several boards be merged in arrival order. The consumer
+ * takes chunks out at its own pace (the monitor does it once per frame).
+ *
+ * A port's fd must stay open until removePort() returns. Every call but
+ * now() is for the GUI thread (the one consumer); take() and the status
+ * calls never wait for the worker.
+ */
+class SerialReader {
+public:
+    /// Per port: about 20 s of output at 2 Mbaud
+    static constexpr size_t RING_CAPACITY = 4 * 1024 * 1024;
+
+    /**
+     * Bytes from one read(), with when they arrived
+     */
+    struct Chunk {
+        int64_t timestampNs;    // steady_clock
+        QByteArray data;
+    };
+
+    SerialReader() = default;
+    ~SerialReader();
+
+    SerialReader(const SerialReader&) = delete;
+    SerialReader& operator=(const SerialReader&) = delete;
+
+    /**
+     * Start reading fd; the worker thread starts with the first port
+     * Throws SerialError if the port can't be added to the wait set.
+     * @return Port ID for the other calls
+     */
+    int addPort(int fd);
+
+    /**
+     * Stop reading a port; once this returns the worker no longer touches
+     * its fd. Unread data is discarded.
+     */
+    void removePort(int portId);
+
+    /**
+     * Remove every port and join the worker thread
+     */
+    void stop();
+
+    /**
+     * Consumer: take everything buffered for a port
+     */
+    std::vector<Chunk> take(int portId);
+
+    /**
+     * The port reported an error or hang-up and is no longer read
+     */
+    bool hasFailed(int portId) const;
+    int errorCode(int portId) const;
+
+    /**
+     * Bytes lost because the consumer fell behind by more than the ring
+     */
+    uint64_t droppedBytes(int portId) const;
+
+    /**
+     * Tee a port's raw bytes to sink as they are read
+     * The sink must outlive the port or be removed first.
+     */
+    void addSink(int portId, ByteSink* sink);
+
+    /**
+     * Stop teeing to sink; once this returns it is no longer called
+     */
+    void removeSink(int portId, ByteSink* sink);
+
+    /**
+     * Current steady_clock time in the units of Chunk::timestampNs
+     */
+    static int64_t now();
+
+private:
+    struct Port {
+        explicit Port(int fd) : fd(fd), ring(RING_CAPACITY) {}
+
+        int fd;
+        ByteRing ring;
+        std::atomic<bool> failed{false};
+        std::atomic<int> errorCode{0};
+        std::atomic<uint64_t> droppedBytes{0};
+
+        // Held by the worker while it drains this port, so removePort()
+        // and removeSink() wait out a read in progress on this port only
+        QMutex drainMutex;
+        std::vector<ByteSink*> sinks;   // Guarded by drainMutex
+        bool removed = false;           // Guarded by drainMutex
+    };
+
+    void startThread();
+    void run();
+    bool drainPort(Port& port);
+    void fail(Port& port, int errorCode);
+    Port* find(int portId) const;
+
+    // Guards m_ports against the worker's lookups, which hold it only long
+    // enough to take a reference. Only the GUI thread changes the map, so
+    // its own lookups need no lock.
+    QMutex m_mutex;
+    std::map<int, std::shared_ptr<Port>> m_ports;
+    int m_nextPortId = 1;
+
+    std::thread m_thread;
+    int m_epollFd = -1;
+    int m_wakeFd = -1;
+};
+
+#endif // SERIALREADER_H
@@ -0,0 +1,207 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "Utf8StreamDecoder.h"
+
+#include <QLatin1String>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+/**
+ * Sequence length announced by a lead byte, or 0 if it can't start one
+ * (continuation bytes, overlong C0/C1, and F5-FF beyond U+10FFFF)
+ */
+int sequenceLength(uint8_t lead)
+{
+    if (lead < 0x80) return 1;
+    if (lead < 0xC2) return 0;
+    if (lead < 0xE0) return 2;
+    if (lead < 0xF0) return 3;
+    if (lead < 0xF5) return 4;
+    return 0;
+}
+
+/**
+ * How many of the available bytes form a valid start of the sequence
+ * The second byte range rules out overlongs, surrogates and > U+10FFFF.
+ */
+int validPrefix(const uint8_t* bytes, int available, int length)
+{
+    int count = 1;
+    for (; count < length && count < available; ++count) {
+        uint8_t byte = bytes[count];
+        uint8_t low = 0x80;
+        uint8_t high = 0xBF;
+
+        if (count == 1) {
+            switch (bytes[0]) {
+            case 0xE0: low = 0xA0; break;
+            case 0xED: high = 0x9F; break;
+            case 0xF0: low = 0x90; break;
+            case 0xF4: high = 0x8F; break;
+            default: break;
+            }
+        }
+
+        if (byte < low || byte > high) {
+            break;
+        }
+    }
+    return count;
+}
+
+uint32_t decodeSequence(const uint8_t* bytes, int length)
+{
+    static const uint8_t leadMask[] = {0, 0x7F, 0x1F, 0x0F, 0x07};
+
+    uint32_t codePoint = bytes[0] & leadMask[length];
+    for (int i = 1; i < length; ++i) {
+        codePoint = (codePoint << 6) | (bytes[i] & 0x3F);
+    }
+    return codePoint;
+}
+
+void appendCodePoint(QString& out, uint32_t codePoint)
+{
+    if (codePoint < 0x10000) {
+        out.append(QChar(static_cast<char16_t>(codePoint)));
+    } else {
+        codePoint -= 0x10000;
+        out.append(QChar(static_cast<char16_t>(0xD800 + (codePoint >> 10))));
+        out.append(QChar(static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF))));
+    }
+}
+
+void appendLatin1(QString& out, uint8_t byte)
+{
+    out.append(QChar(static_cast<char16_t>(byte)));
+}
+
+/**
+ * Length of the run of ASCII bytes starting at data
+ */
+int asciiRun(const uint8_t* data, int size)
+{
+    int i = 0;
+
+#ifdef __SSE2__
+    // The top bit of each byte is set only for non-ASCII
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int mask = _mm_movemask_epi8(chunk);
+        if (mask != 0) {
+            return i + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+#endif
+
+    while (i < size && data[i] < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+} // anonymous namespace
+
+QString Utf8StreamDecoder::decode(const QByteArray& data)
+{
+    return decode(data.constData(), data.size());
+}
+
+QString Utf8StreamDecoder::decode(const char* data, int size)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    QString out;
+    out.reserve(size + m_pendingSize);
+
+    int i = 0;
+
+    // Finish the character the previous chunk ended in
+    if (m_pendingSize > 0) {
+        uint8_t joined[4];
+        int joinedSize = m_pendingSize;
+        for (int k = 0; k < m_pendingSize; ++k) {
+            joined[k] = m_pending[k];
+        }
+        while (joinedSize < 4 && joinedSize - m_pendingSize < size) {
+            joined[joinedSize] = bytes[joinedSize - m_pendingSize];
+            ++joinedSize;
+        }
+
+        int length = sequenceLength(joined[0]);
+        int valid = validPrefix(joined, joinedSize, length);
+
+        if (valid == length) {
+            appendCodePoint(out, decodeSequence(joined, length));
+            i = length - m_pendingSize;
+            m_pendingSize = 0;
+        } else if (valid == joinedSize) {
+            // Still incomplete; keep waiting
+            for (int k = m_pendingSize; k < joinedSize; ++k) {
+                m_pending[k] = joined[k];
+            }
+            m_pendingSize = joinedSize;
+            return out;
+        } else {
+            // Broken sequence: the held bytes are shown as they are
+            for (int k = 0; k < m_pendingSize; ++k) {
+                appendLatin1(out, m_pending[k]);
+            }
+            m_pendingSize = 0;
+        }
+    }
+
+    while (i < size) {
+        int run = asciiRun(bytes + i, size - i);
+        if (run > 0) {
+            out.append(QLatin1String(data + i, run));
+            i += run;
+            if (i == size) {
+                break;
+            }
+        }
+
+        int length = sequenceLength(bytes[i]);
+        if (length == 0) {
+            appendLatin1(out, bytes[i]);
+            ++i;
+            continue;
+        }
+
+        int available = size - i;
+        int valid = validPrefix(bytes + i, available, length);
+
+        if (valid == length) {
+            appendCodePoint(out, decodeSequence(bytes + i, length));
+            i += length;
+        } else if (valid == available) {
+            // Chunk ends mid-character; the rest comes with the next read
+            for (int k = 0; k < available; ++k) {
+                m_pending[k] = bytes[i + k];
+            }
+            m_pendingSize = available;
+            break;
+        } else {
+            // Only the bad lead byte falls back; decoding resumes after it
+            appendLatin1(out, bytes[i]);
+            ++i;
+        }
+    }
+
+    return out;
+}
+
+QString Utf8StreamDecoder::flush()
+{
+    QString out;
+    for (int k = 0; k < m_pendingSize; ++k) {
+        appendLatin1(out, m_pending[k]);
+    }
+    m_pendingSize = 0;
+    return out;
+}
@@ -0,0 +1,48 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef UTF8STREAMDECODER_H
+#define UTF8STREAMDECODER_H
+
+#include <QByteArray>
+#include <QString>
+#include <cstdint>
+
+/**
+ * Stateful UTF-8 decoder for a byte stream that arrives in arbitrary chunks
+ *
+ * A multi-byte character split across two reads is held back until the
+ * rest arrives instead of being garbled. Bytes that are not valid UTF-8
+ * (boot ROM noise, baud mismatches, Latin-1 output) are shown as Latin-1
+ * one byte at a time, so one bad byte never changes how the rest of the
+ * chunk is decoded. Runs of ASCII, the bulk of any log, are copied
+ * 16 bytes per step with SSE2 where available.
+ */
+class Utf8StreamDecoder {
+public:
+    /**
+     * Decode the next chunk of the stream
+     */
+    QString decode(const QByteArray& data);
+    QString decode(const char* data, int size);
+
+    /**
+     * End of stream: return any held-back partial character as Latin-1
+     */
+    QString flush();
+
+    /**
+     * Forget held-back bytes (e.g. after reconnecting)
+     */
+    void reset() { m_pendingSize = 0; }
+
+    bool hasPending() const { return m_pendingSize > 0; }
+
+private:
+    // Lead bytes of an incomplete sequence from the previous chunk
+    uint8_t m_pending[3] = {};
+    int m_pendingSize = 0;
+};
+
+#endif // UTF8STREAMDECODER_H
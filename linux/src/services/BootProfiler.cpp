@@ -0,0 +1,217 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "BootProfiler.h"
+#include "protocol/BootBannerMatcher.h"
+
+#include <QSettings>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// ESP-IDF's own log lines for the usual boot stages
+const char* const kDefaultMilestones[][2] = {
+    {"bootloader", "2nd stage bootloader"},
+    {"app_main", "Calling app_main()"},
+    {"WiFi connected", "wifi:connected with"},
+    {"got IP", "sta ip:"},
+};
+
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+    // Nearest rank
+    size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+QString formatMs(double ms)
+{
+    return ms >= 10000 ? QString("%1 s").arg(ms / 1000.0, 0, 'f', 2)
+                       : QString("%1 ms").arg(std::lround(ms));
+}
+
+} // anonymous namespace
+
+std::vector<BootProfiler::Milestone> BootProfiler::configuredMilestones()
+{
+    std::vector<Milestone> milestones;
+
+    QSettings settings;
+    const QStringList entries = settings.value("BootProfiler/milestones").toStringList();
+    for (const QString& entry : entries) {
+        int separator = entry.indexOf('=');
+        if (separator <= 0 || separator == entry.size() - 1) {
+            continue;
+        }
+        milestones.push_back(Milestone{entry.left(separator).trimmed(), entry.mid(separator + 1)});
+    }
+
+    if (milestones.empty()) {
+        for (const auto& milestone : kDefaultMilestones) {
+            milestones.push_back(Milestone{milestone[0], milestone[1]});
+        }
+    }
+    return milestones;
+}
+
+BootProfiler::BootProfiler()
+    : BootProfiler(configuredMilestones())
+{
+}
+
+BootProfiler::BootProfiler(std::vector<Milestone> milestones)
+    : m_milestones(std::move(milestones))
+{
+}
+
+QString BootProfiler::Boot::summary(const std::vector<Milestone>& milestones) const
+{
+    QStringList parts;
+    parts << QString("first byte %1").arg(firstByteMs ? formatMs(*firstByteMs) : QString("-"));
+    for (size_t i = 0; i < milestones.size() && i < milestoneMs.size(); ++i) {
+        parts << QString("%1 %2").arg(milestones[i].name,
+                                      milestoneMs[i] ? formatMs(*milestoneMs[i]) : QString("-"));
+    }
+    return parts.join(", ") + (fromBanner ? " (from ROM banner)" : "");
+}
+
+void BootProfiler::markReset(int64_t timestampNs)
+{
+    startBoot(timestampNs, false);
+}
+
+void BootProfiler::feedBytes(int64_t timestampNs)
+{
+    poll(timestampNs);
+    if (m_current && !m_current->firstByteMs) {
+        m_current->firstByteMs = elapsedMs(*m_current, timestampNs);
+    }
+}
+
+void BootProfiler::feedLine(int64_t timestampNs, const QString& line)
+{
+    poll(timestampNs);
+
+    // A reset nobody told us about (reset button, watchdog, crash loop).
+    // After markReset() the banner is just the first output of that boot.
+    const bool banner = BootBannerMatcher::isRomBannerLine(line);
+    if (banner && !m_lastLineWasBanner) {
+        bool expected = m_current && !m_current->fromBanner &&
+                        std::none_of(m_current->milestoneMs.begin(), m_current->milestoneMs.end(),
+                                     [](const auto& ms) { return ms.has_value(); });
+        if (!expected) {
+            startBoot(timestampNs, true);
+            m_current->firstByteMs = 0;
+        }
+    }
+    m_lastLineWasBanner = banner;
+
+    if (!m_current) {
+        return;
+    }
+
+    for (size_t i = 0; i < m_milestones.size(); ++i) {
+        if (!m_current->milestoneMs[i] && line.contains(m_milestones[i].pattern)) {
+            m_current->milestoneMs[i] = elapsedMs(*m_current, timestampNs);
+        }
+    }
+
+    if (isComplete(*m_current)) {
+        finishBoot();
+    }
+}
+
+void BootProfiler::poll(int64_t nowNs)
+{
+    if (m_current && elapsedMs(*m_current, nowNs) >= BOOT_TIMEOUT_MS) {
+        finishBoot();
+    }
+}
+
+std::vector<BootProfiler::Boot> BootProfiler::takeFinished()
+{
+    return std::exchange(m_finished, {});
+}
+
+std::vector<BootProfiler::Stats> BootProfiler::statistics(const std::vector<const Boot*>& boots,
+                                                          const std::vector<Milestone>& milestones)
+{
+    std::vector<Stats> result;
+
+    auto summarize = [&](const QString& name, auto valueOf) {
+        Stats stats;
+        stats.name = name;
+
+        std::vector<double> values;
+        for (const Boot* boot : boots) {
+            if (std::optional<double> value = valueOf(*boot)) {
+                values.push_back(*value);
+            } else {
+                ++stats.missed;
+            }
+        }
+
+        stats.count = static_cast<int>(values.size());
+        if (!values.empty()) {
+            std::sort(values.begin(), values.end());
+            stats.minMs = values.front();
+            stats.maxMs = values.back();
+            stats.medianMs = percentile(values, 0.5);
+            stats.p90Ms = percentile(values, 0.9);
+
+            double total = 0;
+            for (double value : values) {
+                total += value;
+            }
+            stats.meanMs = total / values.size();
+        }
+        result.push_back(stats);
+    };
+
+    summarize("first byte", [](const Boot& boot) { return boot.firstByteMs; });
+    for (size_t i = 0; i < milestones.size(); ++i) {
+        summarize(milestones[i].name, [i](const Boot& boot) {
+            return i < boot.milestoneMs.size() ? boot.milestoneMs[i] : std::nullopt;
+        });
+    }
+    return result;
+}
+
+void BootProfiler::startBoot(int64_t timestampNs, bool fromBanner)
+{
+    if (m_current) {
+        finishBoot();
+    }
+
+    Boot boot;
+    boot.resetNs = timestampNs;
+    boot.fromBanner = fromBanner;
+    boot.milestoneMs.resize(m_milestones.size());
+    m_current = boot;
+}
+
+void BootProfiler::finishBoot()
+{
+    m_finished.push_back(*m_current);
+    m_history.push_back(*m_current);
+    if (m_history.size() > MAX_BOOTS) {
+        m_history.pop_front();
+    }
+    m_current.reset();
+}
+
+bool BootProfiler::isComplete(const Boot& boot) const
+{
+    return !m_milestones.empty() &&
+           std::all_of(boot.milestoneMs.begin(), boot.milestoneMs.end(),
+                       [](const auto& ms) { return ms.has_value(); });
+}
+
+double BootProfiler::elapsedMs(const Boot& boot, int64_t timestampNs)
+{
+    return std::max<int64_t>(0, timestampNs - boot.resetNs) / 1e6;
+}
@@ -0,0 +1,131 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef BOOTPROFILER_H
+#define BOOTPROFILER_H
+
+#include <QString>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+/**
+ * Boot timing, from reset to application-ready, measured on the monitor
+ * stream
+ *
+ * A boot starts at a reset: one the flasher issued (markReset()) or one
+ * announced by the ROM banner in the output. From there it records when
+ * the first byte arrived and when each milestone pattern first appeared.
+ * Every time is on the steady clock SerialReader stamps reads with, so
+ * system clock changes can't skew it. A boot ends at the next reset, once
+ * every milestone has been seen, or after BOOT_TIMEOUT_MS.
+ */
+class BootProfiler {
+public:
+    /// A boot that hasn't reached every milestone by now never will
+    static constexpr int64_t BOOT_TIMEOUT_MS = 60 * 1000;
+
+    /// Finished boots kept per port
+    static constexpr size_t MAX_BOOTS = 1000;
+
+    /**
+     * Named substring marking a point in the boot, e.g. app_main entry
+     */
+    struct Milestone {
+        QString name;
+        QString pattern;
+    };
+
+    struct Boot {
+        int64_t resetNs = 0;
+
+        /// The reset was only seen in the output (the ROM banner), so the
+        /// times are measured from the banner rather than the reset itself
+        bool fromBanner = false;
+
+        std::optional<double> firstByteMs;
+        std::vector<std::optional<double>> milestoneMs;    // Per milestone
+
+        /**
+         * One-line summary, e.g. "first byte 12 ms, app_main 310 ms, ..."
+         */
+        QString summary(const std::vector<Milestone>& milestones) const;
+    };
+
+    /**
+     * Distribution of one measurement over many boots
+     */
+    struct Stats {
+        QString name;
+        int count = 0;          // Boots that reached it
+        int missed = 0;         // Boots that didn't
+        double minMs = 0;
+        double medianMs = 0;
+        double p90Ms = 0;
+        double maxMs = 0;
+        double meanMs = 0;
+    };
+
+    /**
+     * Milestones from QSettings "BootProfiler/milestones", a list of
+     * "name=pattern" in boot order, or the ESP-IDF defaults
+     */
+    static std::vector<Milestone> configuredMilestones();
+
+    BootProfiler();
+    explicit BootProfiler(std::vector<Milestone> milestones);
+
+    const std::vector<Milestone>& milestones() const { return m_milestones; }
+
+    /**
+     * The device was reset at timestampNs (by the flasher or a trigger)
+     */
+    void markReset(int64_t timestampNs);
+
+    /**
+     * Bytes arrived at timestampNs
+     */
+    void feedBytes(int64_t timestampNs);
+
+    /**
+     * A complete line arrived at timestampNs
+     */
+    void feedLine(int64_t timestampNs, const QString& line);
+
+    /**
+     * Give up on a boot that has been running for BOOT_TIMEOUT_MS
+     */
+    void poll(int64_t nowNs);
+
+    /**
+     * Boots finished since the last call, oldest first
+     */
+    std::vector<Boot> takeFinished();
+
+    const std::deque<Boot>& history() const { return m_history; }
+    void clearHistory() { m_history.clear(); }
+
+    /**
+     * First byte and each milestone, summarized over boots
+     */
+    static std::vector<Stats> statistics(const std::vector<const Boot*>& boots,
+                                         const std::vector<Milestone>& milestones);
+
+private:
+    void startBoot(int64_t timestampNs, bool fromBanner);
+    void finishBoot();
+    bool isComplete(const Boot& boot) const;
+    static double elapsedMs(const Boot& boot, int64_t timestampNs);
+
+    std::vector<Milestone> m_milestones;
+    std::optional<Boot> m_current;
+    std::deque<Boot> m_history;
+    std::vector<Boot> m_finished;
+
+    // Consecutive banner lines belong to the same reset
+    bool m_lastLineWasBanner = false;
+};
+
+#endif // BOOTPROFILER_H
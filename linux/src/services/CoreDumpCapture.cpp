@@ -0,0 +1,436 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "CoreDumpCapture.h"
+#include "LogCapture.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char START_MARKER[] = "CORE DUMP START";
+const char END_MARKER[] = "CORE DUMP END";
+
+constexpr uint16_t EM_XTENSA = 94;
+constexpr uint16_t EM_RISCV = 243;
+constexpr uint16_t ET_CORE = 4;
+constexpr uint32_t PT_LOAD = 1;
+constexpr uint32_t PT_NOTE = 4;
+
+// Note types ESP-IDF writes
+constexpr uint32_t NT_PRSTATUS = 1;
+constexpr uint32_t NT_ESP_INFO = 8266;
+constexpr uint32_t NT_EXTRA_INFO = 677;
+constexpr uint32_t NT_PANIC_DETAILS = 1;
+
+// Registers follow a Linux-style elf_prstatus; pr_pid holds the TCB
+constexpr uint32_t PRSTATUS_PID = 24;
+constexpr uint32_t PRSTATUS_REGS = 72;
+
+// Xtensa gregset: pc, ps, loop and window registers, reserved, then ar[]
+constexpr uint32_t XTENSA_AR = 64 * 4;
+
+// FreeRTOS TCB: pxTopOfStack, two 20-byte list items, uxPriority, pxStack,
+// pcTaskName[16]
+constexpr uint32_t TCB_STACK = 48;
+constexpr uint32_t TCB_NAME = 52;
+constexpr int TASK_NAME_LENGTH = 16;
+
+bool isBase64(char c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+           (c >= '0' && c <= '9') || c == '+' || c == '/' || c == '=';
+}
+
+uint32_t readU32(const QByteArray& data, uint64_t offset)
+{
+    if (offset + 4 > static_cast<uint64_t>(data.size())) {
+        return 0;
+    }
+    const auto* p = reinterpret_cast<const uint8_t*>(data.constData() + offset);
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint16_t readU16(const QByteArray& data, uint64_t offset)
+{
+    if (offset + 2 > static_cast<uint64_t>(data.size())) {
+        return 0;
+    }
+    const auto* p = reinterpret_cast<const uint8_t*>(data.constData() + offset);
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+QString xtensaRegisterName(uint32_t index)
+{
+    if (index == 232) {
+        return "EXCCAUSE";
+    }
+    if (index == 238) {
+        return "EXCVADDR";
+    }
+    if (index >= 177 && index <= 183) {
+        return QString("EPC%1").arg(index - 176);
+    }
+    if (index >= 194 && index <= 199) {
+        return QString("EPS%1").arg(index - 192);
+    }
+    return QString("reg%1").arg(index);
+}
+
+QByteArray untilNul(const QByteArray& data)
+{
+    const int nul = data.indexOf('\0');
+    return nul < 0 ? data : data.left(nul);
+}
+
+/**
+ * Memory captured in the core's PT_LOAD segments
+ */
+struct Segment {
+    uint32_t address;
+    uint32_t size;
+    uint32_t offset;    // In the ELF
+};
+
+const Segment* segmentAt(const std::vector<Segment>& segments, uint32_t address)
+{
+    for (const Segment& segment : segments) {
+        if (address >= segment.address && address - segment.address < segment.size) {
+            return &segment;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+QStringList CoreDump::summary() const
+{
+    QStringList lines;
+    if (!error.isEmpty()) {
+        lines.append(QString("[Core dump: %1]").arg(error));
+        return lines;
+    }
+
+    lines.append(QString("[Core dump: %1 bytes, %2, %3 tasks%4]")
+                     .arg(size)
+                     .arg(architecture)
+                     .arg(tasks.size())
+                     .arg(savedPath.isEmpty() ? QString() : ", saved to " + savedPath));
+    if (!panicReason.isEmpty()) {
+        lines.append("  Panic: " + panicReason);
+    }
+    if (!appSha256.isEmpty()) {
+        lines.append("  App ELF SHA256: " + appSha256);
+    }
+
+    QString registers;
+    for (const auto& reg : exceptionRegisters) {
+        registers += QString("  %1 0x%2").arg(reg.first).arg(reg.second, 8, 16, QChar('0'));
+    }
+    if (!registers.isEmpty()) {
+        lines.append(registers);
+    }
+
+    // Code addresses are printed as plain hex words so the symbolizer
+    // annotates them like a live backtrace
+    for (const Task& task : tasks) {
+        QString line = QString("  %1 %2 (0x%3)  PC 0x%4  RA 0x%5  SP 0x%6  stack %7 B used")
+                           .arg(task.crashed ? "*" : " ")
+                           .arg(task.name.isEmpty() ? QString("?") : task.name, -16)
+                           .arg(task.tcb, 8, 16, QChar('0'))
+                           .arg(task.pc, 8, 16, QChar('0'))
+                           .arg(task.returnAddress, 8, 16, QChar('0'))
+                           .arg(task.sp, 8, 16, QChar('0'))
+                           .arg(task.stackUsed);
+        if (task.stackFree >= 0) {
+            line += QString(", %1 B free").arg(task.stackFree);
+        }
+        lines.append(line);
+    }
+    return lines;
+}
+
+CoreDumpCapture::CoreDumpCapture(const QString& deviceId)
+    : m_directory(dumpDirectory(deviceId))
+{
+    m_thread = std::thread([this]() {
+        run();
+    });
+}
+
+CoreDumpCapture::~CoreDumpCapture()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopRequested = true;
+        m_wake.wakeAll();
+    }
+    m_thread.join();
+}
+
+void CoreDumpCapture::consume(const char* data, size_t size)
+{
+    const char* end = data + size;
+    while (data < end) {
+        const char* newline = static_cast<const char*>(std::memchr(data, '\n', end - data));
+        const char* stop = newline ? newline : end;
+
+        // Outside a dump only the head of a line can hold the marker
+        size_t keep = static_cast<size_t>(stop - data);
+        if (!m_inDump) {
+            keep = std::min(keep, MAX_LINE_BYTES - std::min(MAX_LINE_BYTES, m_line.size()));
+        }
+        m_line.append(data, keep);
+
+        if (!newline) {
+            break;
+        }
+        endLine();
+        data = newline + 1;
+    }
+}
+
+void CoreDumpCapture::endLine()
+{
+    if (!m_inDump) {
+        if (m_line.find(START_MARKER) != std::string::npos) {
+            m_inDump = true;
+            m_base64.clear();
+            ++m_started;
+        }
+        m_line.clear();
+        return;
+    }
+
+    if (m_line.find(END_MARKER) != std::string::npos) {
+        m_inDump = false;
+        QMutexLocker locker(&m_mutex);
+        m_queue.push_back(std::move(m_base64));
+        m_base64 = std::string();
+        m_wake.wakeAll();
+    } else {
+        // A log line printed into the middle of the dump isn't part of it
+        bool clean = std::all_of(m_line.begin(), m_line.end(), [](char c) {
+            return isBase64(c) || c == '\r' || c == ' ';
+        });
+        if (clean) {
+            for (char c : m_line) {
+                if (isBase64(c)) {
+                    m_base64.push_back(c);
+                }
+            }
+        }
+
+        // A lost end marker mustn't swallow the rest of the session
+        if (m_base64.size() > MAX_BASE64_BYTES) {
+            m_inDump = false;
+            m_base64.clear();
+        }
+    }
+    m_line.clear();
+}
+
+std::vector<CoreDump> CoreDumpCapture::takeFinished()
+{
+    QMutexLocker locker(&m_mutex);
+    std::vector<CoreDump> finished;
+    finished.swap(m_finished);
+    return finished;
+}
+
+void CoreDumpCapture::run()
+{
+    for (;;) {
+        std::vector<std::string> queue;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.empty() && !m_stopRequested) {
+                m_wake.wait(&m_mutex);
+            }
+            if (m_stopRequested) {
+                return;
+            }
+            queue.swap(m_queue);
+        }
+
+        for (const std::string& base64 : queue) {
+            const QByteArray raw = QByteArray::fromBase64(
+                QByteArray(base64.data(), static_cast<int>(base64.size())));
+            CoreDump dump = parse(raw);
+            if (dump.error.isEmpty()) {
+                save(raw.mid(raw.indexOf("\x7f" "ELF")), dump);
+            }
+
+            QMutexLocker locker(&m_mutex);
+            m_finished.push_back(std::move(dump));
+        }
+    }
+}
+
+CoreDump CoreDumpCapture::parse(const QByteArray& raw)
+{
+    CoreDump dump;
+    dump.size = raw.size();
+
+    // A small header (total length, version, counts) precedes the ELF
+    const int elfStart = raw.indexOf("\x7f" "ELF");
+    if (elfStart < 0 || elfStart > 64) {
+        dump.error = "not an ELF core dump (older binary format?)";
+        return dump;
+    }
+    const uint32_t totalLength = readU32(raw, 0);
+    if (elfStart >= 4 && totalLength > static_cast<uint32_t>(raw.size())) {
+        dump.error = QString("incomplete, %1 of %2 bytes").arg(raw.size()).arg(totalLength);
+        return dump;
+    }
+
+    const QByteArray elf = raw.mid(elfStart);
+    if (elf.size() < 52 || elf[4] != 1 || elf[5] != 1 || readU16(elf, 16) != ET_CORE) {
+        dump.error = "not a 32-bit little-endian ELF core";
+        return dump;
+    }
+
+    const uint16_t machine = readU16(elf, 18);
+    dump.architecture = machine == EM_XTENSA ? "Xtensa"
+                      : machine == EM_RISCV ? "RISC-V"
+                      : QString("machine %1").arg(machine);
+
+    const uint32_t headerOffset = readU32(elf, 28);
+    const uint16_t headerSize = readU16(elf, 42);
+    const uint16_t headerCount = readU16(elf, 44);
+
+    std::vector<Segment> segments;
+    std::vector<std::pair<uint32_t, uint32_t>> notes;   // Offset, size
+    for (uint16_t i = 0; i < headerCount; ++i) {
+        const uint64_t header = headerOffset + static_cast<uint64_t>(i) * headerSize;
+        const uint32_t type = readU32(elf, header);
+        const uint32_t offset = readU32(elf, header + 4);
+        const uint32_t size = readU32(elf, header + 16);
+        if (static_cast<uint64_t>(offset) + size > static_cast<uint64_t>(elf.size())) {
+            continue;
+        }
+        if (type == PT_LOAD) {
+            segments.push_back(Segment{readU32(elf, header + 8), size, offset});
+        } else if (type == PT_NOTE) {
+            notes.emplace_back(offset, size);
+        }
+    }
+
+    uint32_t crashedTcb = 0;
+    for (const auto& note : notes) {
+        uint64_t pos = note.first;
+        const uint64_t end = static_cast<uint64_t>(note.first) + note.second;
+        while (pos + 12 <= end) {
+            const uint32_t nameSize = readU32(elf, pos);
+            const uint32_t descSize = readU32(elf, pos + 4);
+            const uint32_t type = readU32(elf, pos + 8);
+            const uint64_t nameOffset = pos + 12;
+            const uint64_t descOffset = nameOffset + ((nameSize + 3) & ~3u);
+            const uint64_t next = descOffset + ((static_cast<uint64_t>(descSize) + 3) & ~3ull);
+            if (next > end) {
+                break;
+            }
+            const QByteArray name = untilNul(elf.mid(static_cast<int>(nameOffset), static_cast<int>(nameSize)));
+            const QByteArray desc = elf.mid(static_cast<int>(descOffset), static_cast<int>(descSize));
+
+            if (name == "CORE" && type == NT_PRSTATUS) {
+                CoreDump::Task task;
+                task.tcb = readU32(desc, PRSTATUS_PID);
+                task.pc = readU32(desc, PRSTATUS_REGS);
+                if (machine == EM_XTENSA) {
+                    task.returnAddress = readU32(desc, PRSTATUS_REGS + XTENSA_AR);
+                    task.sp = readU32(desc, PRSTATUS_REGS + XTENSA_AR + 4);
+                } else {
+                    task.returnAddress = readU32(desc, PRSTATUS_REGS + 4);
+                    task.sp = readU32(desc, PRSTATUS_REGS + 8);
+                }
+                dump.tasks.push_back(task);
+            } else if (name == "ESP_CORE_DUMP_INFO" && type == NT_ESP_INFO) {
+                dump.appSha256 = QString::fromLatin1(untilNul(desc.mid(4)));
+            } else if (name == "EXTRA_INFO" && type == NT_EXTRA_INFO) {
+                crashedTcb = readU32(desc, 0);
+                if (machine == EM_XTENSA) {
+                    for (int offset = 4; offset + 8 <= desc.size(); offset += 8) {
+                        const uint32_t index = readU32(desc, offset);
+                        const uint32_t value = readU32(desc, offset + 4);
+                        if (index == 0 && value == 0) {
+                            continue;
+                        }
+                        const QString reg = xtensaRegisterName(index);
+                        if (value != 0 || reg == "EXCCAUSE" || reg == "EXCVADDR") {
+                            dump.exceptionRegisters.emplace_back(reg, value);
+                        }
+                    }
+                }
+            } else if (name == "ESP_PANIC_DETAILS" && type == NT_PANIC_DETAILS) {
+                dump.panicReason = QString::fromUtf8(untilNul(desc)).trimmed();
+            }
+            pos = next;
+        }
+    }
+
+    for (CoreDump::Task& task : dump.tasks) {
+        task.crashed = task.tcb == crashedTcb;
+
+        // The TCB and the live part of the stack are saved as memory
+        if (const Segment* tcb = segmentAt(segments, task.tcb)) {
+            const uint32_t offset = tcb->offset + (task.tcb - tcb->address);
+            if (task.tcb - tcb->address + TCB_NAME + TASK_NAME_LENGTH <= tcb->size) {
+                const QByteArray name = untilNul(elf.mid(static_cast<int>(offset + TCB_NAME), TASK_NAME_LENGTH));
+                const bool printable = std::all_of(name.begin(), name.end(),
+                                                   [](char c) { return c >= 0x20 && c < 0x7f; });
+                if (printable) {
+                    task.name = QString::fromLatin1(name);
+                }
+                const uint32_t stackBase = readU32(elf, offset + TCB_STACK);
+                if (stackBase != 0 && stackBase <= task.sp) {
+                    task.stackFree = task.sp - stackBase;
+                }
+            }
+        }
+        if (const Segment* stack = segmentAt(segments, task.sp)) {
+            task.stackUsed = stack->address + stack->size - task.sp;
+        }
+    }
+
+    std::stable_partition(dump.tasks.begin(), dump.tasks.end(),
+                          [](const CoreDump::Task& task) { return task.crashed; });
+
+    if (dump.tasks.empty()) {
+        dump.error = "no tasks in the core dump";
+    }
+    return dump;
+}
+
+void CoreDumpCapture::save(const QByteArray& elf, CoreDump& dump)
+{
+    if (!QDir().mkpath(m_directory)) {
+        return;
+    }
+
+    const QString path = QString("%1/%2.elf")
+        .arg(m_directory, QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz"));
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly) && file.write(elf) == elf.size()) {
+        dump.savedPath = path;
+    }
+}
+
+QString CoreDumpCapture::dumpDirectory(const QString& deviceId)
+{
+    // Alongside the captures, under the same device name
+    QString captures = LogCapture::captureDirectory(deviceId);
+    QString name = captures.mid(captures.lastIndexOf('/') + 1);
+
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QString("%1/coredumps/%2").arg(dir, name);
+}
@@ -0,0 +1,126 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef COREDUMPCAPTURE_H
+#define COREDUMPCAPTURE_H
+
+#include "serial/SerialReader.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QWaitCondition>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * A decoded ESP-IDF core dump
+ */
+struct CoreDump {
+    struct Task {
+        uint32_t tcb = 0;           // Task handle
+        QString name;
+        uint32_t pc = 0;
+        uint32_t returnAddress = 0; // A0 on Xtensa, RA on RISC-V
+        uint32_t sp = 0;
+        uint32_t stackUsed = 0;     // Bytes captured above SP
+        int64_t stackFree = -1;     // SP down to the stack's base; -1 if unknown
+        bool crashed = false;
+    };
+
+    QString error;                  // Set if it couldn't be decoded
+    int size = 0;                   // Decoded bytes
+    QString savedPath;              // The ELF core, for gdb or espcoredump
+    QString architecture;
+    QString appSha256;              // Of the app ELF that crashed
+    QString panicReason;
+    std::vector<std::pair<QString, uint32_t>> exceptionRegisters;
+    std::vector<Task> tasks;        // Crashed task first
+
+    /**
+     * Lines for the monitor, e.g. "* main  PC 0x400d1234 ..."
+     */
+    QStringList summary() const;
+};
+
+/**
+ * Picks ESP-IDF UART core dumps out of a port's raw output and decodes them
+ *
+ * The firmware prints the dump as base64 between "CORE DUMP START" and
+ * "CORE DUMP END" marker lines. consume() runs on the reader thread and
+ * only splits lines and collects the base64; a worker thread decodes the
+ * block, saves the ELF core and parses its notes and segments, so a dump
+ * of several hundred KB never touches the GUI thread. The monitor picks
+ * up results with takeFinished().
+ */
+class CoreDumpCapture : public ByteSink {
+public:
+    /// Base64 beyond this is not a core dump we can use
+    static constexpr size_t MAX_BASE64_BYTES = 16 * 1024 * 1024;
+
+    /// Longest line kept while looking for the start marker
+    static constexpr size_t MAX_LINE_BYTES = 256;
+
+    /**
+     * @param deviceId Serial number, or port name when there is none;
+     *                 names the directory dumps are saved in
+     */
+    explicit CoreDumpCapture(const QString& deviceId);
+    ~CoreDumpCapture() override;
+
+    CoreDumpCapture(const CoreDumpCapture&) = delete;
+    CoreDumpCapture& operator=(const CoreDumpCapture&) = delete;
+
+    /**
+     * Reader thread: look for dumps in the next bytes of output
+     */
+    void consume(const char* data, size_t size) override;
+
+    /**
+     * Start markers seen so far (lets the monitor say one is coming)
+     */
+    uint64_t dumpsStarted() const { return m_started; }
+
+    /**
+     * Dumps decoded since the last call
+     */
+    std::vector<CoreDump> takeFinished();
+
+    /**
+     * Parse a decoded core dump (the base64 between the markers)
+     * Doesn't save anything; used by the worker and usable on its own.
+     */
+    static CoreDump parse(const QByteArray& raw);
+
+    static QString dumpDirectory(const QString& deviceId);
+
+private:
+    void endLine();
+    void run();
+    void save(const QByteArray& elf, CoreDump& dump);
+
+    QString m_directory;
+
+    // Reader thread only
+    std::string m_line;
+    std::string m_base64;
+    bool m_inDump = false;
+
+    std::atomic<uint64_t> m_started{0};
+
+    // Shared with the worker
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    std::vector<std::string> m_queue;
+    std::vector<CoreDump> m_finished;
+    bool m_stopRequested = false;
+
+    std::thread m_thread;
+};
+
+#endif // COREDUMPCAPTURE_H
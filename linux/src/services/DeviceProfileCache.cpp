@@ -0,0 +1,85 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "DeviceProfileCache.h"
+
+#include "serial/ResetSequence.h"
+
+#include <QSettings>
+
+std::optional<DeviceProfile> DeviceProfileCache::lookup(const QString& serialNumber) const
+{
+    if (serialNumber.isEmpty()) {
+        return std::nullopt;
+    }
+
+    QSettings settings;
+    settings.beginGroup(groupFor(serialNumber));
+
+    if (!settings.contains("resetStrategy")) {
+        return std::nullopt;
+    }
+
+    auto strategy = resetStrategyFromName(settings.value("resetStrategy").toString());
+    auto baudRate = baudRateFromValue(settings.value("bestBaudRate").toInt());
+    if (!strategy || !baudRate) {
+        // Written by an incompatible version - treat as unknown
+        return std::nullopt;
+    }
+
+    DeviceProfile profile;
+    profile.serialNumber = serialNumber;
+    profile.chip = ESP32Chips::familyFromName(settings.value("chip").toString());
+    profile.resetStrategy = *strategy;
+    profile.needsReopen = settings.value("needsReopen", false).toBool();
+    profile.bestBaudRate = *baudRate;
+    profile.baudLimited = settings.value("baudLimited", false).toBool();
+    profile.resetTimingScale = settings.value("resetTimingScale", profile.resetTimingScale).toDouble();
+    profile.readyMs = settings.value("readyMs", profile.readyMs).toInt();
+    profile.syncAttempts = settings.value("syncAttempts", profile.syncAttempts).toInt();
+    profile.eraseMsPerSector = settings.value("eraseMsPerSector", profile.eraseMsPerSector).toDouble();
+    profile.lastSeen = settings.value("lastSeen").toDateTime();
+    return profile;
+}
+
+void DeviceProfileCache::store(const DeviceProfile& profile)
+{
+    if (profile.serialNumber.isEmpty()) {
+        return;
+    }
+
+    QSettings settings;
+    settings.beginGroup(groupFor(profile.serialNumber));
+    settings.setValue("serialNumber", profile.serialNumber);
+    settings.setValue("chip", ESP32Chips::familyName(profile.chip));
+    settings.setValue("resetStrategy", resetStrategyName(profile.resetStrategy));
+    settings.setValue("needsReopen", profile.needsReopen);
+    settings.setValue("bestBaudRate", baudRateValue(profile.bestBaudRate));
+    settings.setValue("baudLimited", profile.baudLimited);
+    settings.setValue("resetTimingScale", profile.resetTimingScale);
+    settings.setValue("readyMs", profile.readyMs);
+    settings.setValue("resetSequence",
+                      ResetSequence::forStrategy(profile.resetStrategy)
+                          .scaled(profile.resetTimingScale)
+                          .toString());
+    settings.setValue("syncAttempts", profile.syncAttempts);
+    settings.setValue("eraseMsPerSector", profile.eraseMsPerSector);
+    settings.setValue("lastSeen", profile.lastSeen);
+}
+
+void DeviceProfileCache::forget(const QString& serialNumber)
+{
+    if (serialNumber.isEmpty()) {
+        return;
+    }
+
+    QSettings settings;
+    settings.remove(groupFor(serialNumber));
+}
+
+QString DeviceProfileCache::groupFor(const QString& serialNumber)
+{
+    // USB serial numbers may contain characters QSettings treats specially
+    return QString("DeviceProfiles/%1").arg(QString::fromLatin1(serialNumber.toUtf8().toHex()));
+}
@@ -0,0 +1,45 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef DEVICEPROFILECACHE_H
+#define DEVICEPROFILECACHE_H
+
+#include "models/DeviceProfile.h"
+
+#include <QString>
+#include <optional>
+
+/**
+ * Persistent per-device connection fingerprints
+ * Stored with QSettings under the application's organization, so the
+ * cache survives restarts. Each call opens its own QSettings instance,
+ * which keeps the cache safe to use from the flashing worker thread.
+ */
+class DeviceProfileCache {
+public:
+    DeviceProfileCache() = default;
+
+    /**
+     * Look up the profile for a USB serial number
+     * @param serialNumber USB serial number (empty never matches)
+     * @return Stored profile, or nullopt if the device has not been seen
+     */
+    std::optional<DeviceProfile> lookup(const QString& serialNumber) const;
+
+    /**
+     * Store or replace a device profile
+     * Profiles without a serial number are ignored.
+     */
+    void store(const DeviceProfile& profile);
+
+    /**
+     * Forget a device, so the next connection starts from scratch
+     */
+    void forget(const QString& serialNumber);
+
+private:
+    static QString groupFor(const QString& serialNumber);
+};
+
+#endif // DEVICEPROFILECACHE_H
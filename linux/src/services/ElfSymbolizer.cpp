@@ -0,0 +1,680 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "ElfSymbolizer.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+
+namespace {
+
+constexpr uint16_t EM_XTENSA = 94;
+constexpr uint32_t SHT_SYMTAB = 2;
+constexpr uint32_t SHF_EXECINSTR = 0x4;
+constexpr uint8_t STT_FUNC = 2;
+
+/**
+ * Bounds-checked little-endian reader over one section
+ * Running off the end sets failed and yields zeros, so a truncated or
+ * corrupt section stops the parse instead of reading past the buffer.
+ */
+struct Cursor {
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+    bool failed = false;
+
+    Cursor(const QByteArray& bytes, size_t offset = 0)
+        : data(reinterpret_cast<const uint8_t*>(bytes.constData()))
+        , size(static_cast<size_t>(bytes.size()))
+        , pos(offset)
+    {}
+
+    bool atEnd() const { return failed || pos >= size; }
+
+    bool need(size_t count) {
+        if (failed || count > size - std::min(pos, size)) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t fixed(int bytes) {
+        if (!need(bytes)) {
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(data[pos + i]) << (8 * i);
+        }
+        pos += bytes;
+        return value;
+    }
+
+    uint8_t u8() { return static_cast<uint8_t>(fixed(1)); }
+    uint16_t u16() { return static_cast<uint16_t>(fixed(2)); }
+    uint32_t u32() { return static_cast<uint32_t>(fixed(4)); }
+
+    uint64_t uleb() {
+        uint64_t value = 0;
+        int shift = 0;
+        while (need(1)) {
+            uint8_t byte = data[pos++];
+            if (shift < 64) {
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            }
+            shift += 7;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+        return value;
+    }
+
+    int64_t sleb() {
+        int64_t value = 0;
+        int shift = 0;
+        uint8_t byte = 0;
+        while (need(1)) {
+            byte = data[pos++];
+            if (shift < 64) {
+                value |= static_cast<int64_t>(byte & 0x7f) << shift;
+            }
+            shift += 7;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+        if (shift < 64 && (byte & 0x40)) {
+            value |= -(static_cast<int64_t>(1) << shift);
+        }
+        return value;
+    }
+
+    QString string() {
+        const size_t start = pos;
+        while (need(1) && data[pos] != 0) {
+            ++pos;
+        }
+        if (failed) {
+            return QString();
+        }
+        ++pos;
+        return QString::fromUtf8(reinterpret_cast<const char*>(data + start),
+                                 static_cast<int>(pos - start - 1));
+    }
+
+    void skip(uint64_t count) {
+        if (need(count)) {
+            pos += count;
+        }
+    }
+};
+
+QString stringAt(const QByteArray& table, uint64_t offset)
+{
+    if (offset >= static_cast<uint64_t>(table.size())) {
+        return QString();
+    }
+    return QString::fromUtf8(table.constData() + offset);
+}
+
+QString demangle(const char* name)
+{
+    if (std::strncmp(name, "_Z", 2) == 0) {
+        int status = 0;
+        char* readable = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status == 0 && readable) {
+            QString result = QString::fromUtf8(readable);
+            std::free(readable);
+            return result;
+        }
+        std::free(readable);
+    }
+    return QString::fromUtf8(name);
+}
+
+// DWARF forms used in v5 directory and file entry formats
+enum : uint64_t {
+    DW_FORM_block2 = 0x03, DW_FORM_block4 = 0x04, DW_FORM_data2 = 0x05,
+    DW_FORM_data4 = 0x06, DW_FORM_data8 = 0x07, DW_FORM_string = 0x08,
+    DW_FORM_block = 0x09, DW_FORM_block1 = 0x0a, DW_FORM_data1 = 0x0b,
+    DW_FORM_sdata = 0x0d, DW_FORM_strp = 0x0e, DW_FORM_udata = 0x0f,
+    DW_FORM_data16 = 0x1e, DW_FORM_line_strp = 0x1f,
+    DW_FORM_strx = 0x1a, DW_FORM_strx1 = 0x25, DW_FORM_strx2 = 0x26,
+    DW_FORM_strx4 = 0x28,
+};
+
+constexpr uint64_t DW_LNCT_path = 1;
+constexpr uint64_t DW_LNCT_directory_index = 2;
+
+struct EntryField {
+    uint64_t content;
+    uint64_t form;
+};
+
+/**
+ * Read one v5 attribute; strings come back as text, numbers in number
+ * @return false on a form this parser doesn't know (it can't be skipped)
+ */
+bool readForm(Cursor& cursor, uint64_t form, bool dwarf64,
+              const QByteArray& lineStrings, const QByteArray& strings,
+              QString& text, uint64_t& number)
+{
+    switch (form) {
+    case DW_FORM_string: text = cursor.string(); return true;
+    case DW_FORM_line_strp: text = stringAt(lineStrings, cursor.fixed(dwarf64 ? 8 : 4)); return true;
+    case DW_FORM_strp: text = stringAt(strings, cursor.fixed(dwarf64 ? 8 : 4)); return true;
+    case DW_FORM_strx: case DW_FORM_udata: number = cursor.uleb(); return true;
+    case DW_FORM_sdata: number = static_cast<uint64_t>(cursor.sleb()); return true;
+    case DW_FORM_data1: case DW_FORM_strx1: number = cursor.u8(); return true;
+    case DW_FORM_data2: case DW_FORM_strx2: number = cursor.u16(); return true;
+    case DW_FORM_data4: case DW_FORM_strx4: number = cursor.u32(); return true;
+    case DW_FORM_data8: number = cursor.fixed(8); return true;
+    case DW_FORM_data16: cursor.skip(16); return true;
+    case DW_FORM_block: cursor.skip(cursor.uleb()); return true;
+    case DW_FORM_block1: cursor.skip(cursor.u8()); return true;
+    case DW_FORM_block2: cursor.skip(cursor.u16()); return true;
+    case DW_FORM_block4: cursor.skip(cursor.u32()); return true;
+    default: return false;
+    }
+}
+
+/**
+ * Read a v5 directory or file name table
+ * Each entry is its path and, for files, the index of its directory.
+ */
+bool readEntryTable(Cursor& cursor, bool dwarf64,
+                    const QByteArray& lineStrings, const QByteArray& strings,
+                    std::vector<std::pair<QString, uint64_t>>& entries)
+{
+    const uint8_t formatCount = cursor.u8();
+    std::vector<EntryField> format(formatCount);
+    for (EntryField& field : format) {
+        field.content = cursor.uleb();
+        field.form = cursor.uleb();
+    }
+
+    const uint64_t count = cursor.uleb();
+    for (uint64_t i = 0; i < count && !cursor.failed; ++i) {
+        std::pair<QString, uint64_t> entry{QString(), 0};
+        for (const EntryField& field : format) {
+            QString text;
+            uint64_t number = 0;
+            if (!readForm(cursor, field.form, dwarf64, lineStrings, strings, text, number)) {
+                return false;
+            }
+            if (field.content == DW_LNCT_path) {
+                entry.first = text;
+            } else if (field.content == DW_LNCT_directory_index) {
+                entry.second = number;
+            }
+        }
+        entries.push_back(std::move(entry));
+    }
+    return !cursor.failed;
+}
+
+QString joinPath(const QString& directory, const QString& name)
+{
+    if (directory.isEmpty() || name.startsWith('/')) {
+        return name;
+    }
+    return directory.endsWith('/') ? directory + name : directory + '/' + name;
+}
+
+} // namespace
+
+ElfSymbolizer::ElfSymbolizer(const QString& elfPath)
+    : m_path(elfPath)
+    , m_modified(QFileInfo(elfPath).lastModified())
+{
+}
+
+bool ElfSymbolizer::isCurrent() const
+{
+    QFileInfo info(m_path);
+    return info.exists() && info.lastModified() == m_modified;
+}
+
+ElfSymbolizer::~ElfSymbolizer()
+{
+    if (m_loader.joinable()) {
+        m_loader.join();
+    }
+}
+
+void ElfSymbolizer::loadInBackground()
+{
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+
+    m_loader = std::thread([this]() {
+        finishLoading();
+    });
+}
+
+std::optional<ElfSymbolizer::Location> ElfSymbolizer::lookup(uint32_t address)
+{
+    ensureLoaded();
+    if (!isReady()) {
+        return std::nullopt;
+    }
+
+    address = normalize(address);
+    if (!isCode(address) || m_symbols.empty()) {
+        return std::nullopt;
+    }
+
+    // Last symbol starting at or before the address
+    auto symbol = std::upper_bound(m_symbols.begin(), m_symbols.end(), address,
+        [](uint32_t value, const Symbol& s) { return value < s.address; });
+    if (symbol == m_symbols.begin()) {
+        return std::nullopt;
+    }
+    --symbol;
+
+    uint32_t end = symbol->address + symbol->size;
+    if (symbol->size == 0) {
+        auto next = symbol + 1;
+        end = next != m_symbols.end() ? next->address : symbol->address + 1;
+    }
+    if (address >= end) {
+        return std::nullopt;
+    }
+
+    Location location;
+    location.address = address;
+    location.function = demangle(m_strtab.constData() + symbol->nameOffset);
+    location.offset = address - symbol->address;
+
+    auto row = std::upper_bound(m_rows.begin(), m_rows.end(), address,
+        [](uint32_t value, const LineRow& r) { return value < r.address; });
+    if (row != m_rows.begin()) {
+        --row;
+        if (row->line > 0) {
+            location.file = m_files.value(static_cast<int>(row->file));
+            location.line = row->line;
+        }
+    }
+    return location;
+}
+
+QStringList ElfSymbolizer::annotate(const QString& line)
+{
+    QStringList annotations;
+
+    // Cheap rejection: nearly every line carries no hex at all
+    int index = line.indexOf(QLatin1String("0x"));
+    if (index < 0) {
+        return annotations;
+    }
+
+    uint32_t previous = 0;
+    while (index >= 0) {
+        int pos = index + 2;
+        uint32_t value = 0;
+        int digits = 0;
+        while (pos < line.size() && digits <= 8) {
+            const char16_t c = line.at(pos).unicode();
+            int nibble;
+            if (c >= '0' && c <= '9') {
+                nibble = c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                nibble = c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                nibble = c - 'A' + 10;
+            } else {
+                break;
+            }
+            value = (value << 4) | static_cast<uint32_t>(nibble);
+            ++digits;
+            ++pos;
+        }
+
+        // Code addresses are printed as full 32-bit words
+        if (digits == 8 && value != previous) {
+            if (auto location = lookup(value)) {
+                QString text = QString("0x%1: %2").arg(value, 8, 16, QChar('0')).arg(location->function);
+                if (location->offset != 0) {
+                    text += QString("+0x%1").arg(location->offset, 0, 16);
+                }
+                if (location->line > 0) {
+                    text += QString(" at %1:%2").arg(location->file).arg(location->line);
+                }
+                annotations.append(text);
+                previous = value;
+            }
+        }
+        index = line.indexOf(QLatin1String("0x"), pos);
+    }
+    return annotations;
+}
+
+void ElfSymbolizer::ensureLoaded()
+{
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+    finishLoading();
+}
+
+void ElfSymbolizer::finishLoading()
+{
+    if (!load()) {
+        m_code.clear();
+        m_symbols.clear();
+        m_rows.clear();
+    }
+    m_ready.store(true, std::memory_order_release);
+}
+
+bool ElfSymbolizer::load()
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_error = QString("Cannot open %1: %2").arg(m_path, file.errorString());
+        return false;
+    }
+    const QByteArray elf = file.readAll();
+
+    Cursor header(elf);
+    if (elf.size() < 52 || std::memcmp(elf.constData(), "\x7f" "ELF", 4) != 0) {
+        m_error = "Not an ELF file";
+        return false;
+    }
+    if (elf[4] != 1 || elf[5] != 1) {
+        m_error = "Only 32-bit little-endian ELF files are supported";
+        return false;
+    }
+
+    header.pos = 18;
+    m_xtensa = header.u16() == EM_XTENSA;
+    header.pos = 32;
+    const uint32_t sectionOffset = header.u32();
+    header.pos = 46;
+    const uint16_t sectionSize = header.u16();
+    const uint16_t sectionCount = header.u16();
+    const uint16_t namesIndex = header.u16();
+
+    struct Section {
+        uint32_t name, type, flags, address, offset, size, link;
+    };
+    std::vector<Section> sections;
+    for (uint16_t i = 0; i < sectionCount; ++i) {
+        Cursor cursor(elf, sectionOffset + static_cast<size_t>(i) * sectionSize);
+        Section s;
+        s.name = cursor.u32();
+        s.type = cursor.u32();
+        s.flags = cursor.u32();
+        s.address = cursor.u32();
+        s.offset = cursor.u32();
+        s.size = cursor.u32();
+        s.link = cursor.u32();
+        if (cursor.failed) {
+            m_error = "Truncated section headers";
+            return false;
+        }
+        sections.push_back(s);
+    }
+
+    auto contents = [&](const Section& s) {
+        const uint32_t fileSize = static_cast<uint32_t>(elf.size());
+        if (s.offset > fileSize || s.size > fileSize - s.offset) {
+            return QByteArray();
+        }
+        return elf.mid(static_cast<int>(s.offset), static_cast<int>(s.size));
+    };
+    const QByteArray sectionNames = namesIndex < sections.size()
+        ? contents(sections[namesIndex]) : QByteArray();
+
+    QByteArray debugLine, debugLineStr, debugStr;
+    for (const Section& s : sections) {
+        if ((s.flags & SHF_EXECINSTR) && s.size > 0) {
+            m_code.push_back(Range{s.address, s.address + s.size});
+        }
+
+        const QString name = stringAt(sectionNames, s.name);
+        if (name == ".debug_line") {
+            debugLine = contents(s);
+        } else if (name == ".debug_line_str") {
+            debugLineStr = contents(s);
+        } else if (name == ".debug_str") {
+            debugStr = contents(s);
+        }
+
+        if (s.type != SHT_SYMTAB || s.link >= sections.size()) {
+            continue;
+        }
+        m_strtab = contents(sections[s.link]);
+        const QByteArray table = contents(s);
+        Cursor symbols(table);
+        while (!symbols.atEnd()) {
+            Symbol symbol;
+            symbol.nameOffset = symbols.u32();
+            symbol.address = symbols.u32();
+            symbol.size = symbols.u32();
+            const uint8_t info = symbols.u8();
+            symbols.skip(3);
+            if (symbols.failed || (info & 0xf) != STT_FUNC
+                || symbol.nameOffset >= static_cast<uint32_t>(m_strtab.size())) {
+                continue;
+            }
+            m_symbols.push_back(symbol);
+        }
+    }
+
+    if (m_symbols.empty()) {
+        m_error = "No function symbols (stripped ELF?)";
+        return false;
+    }
+
+    std::sort(m_code.begin(), m_code.end(),
+              [](const Range& a, const Range& b) { return a.start < b.start; });
+
+    // Sized symbols win over unsized aliases at the same address
+    std::sort(m_symbols.begin(), m_symbols.end(), [](const Symbol& a, const Symbol& b) {
+        return a.address != b.address ? a.address < b.address : a.size > b.size;
+    });
+    m_symbols.erase(std::unique(m_symbols.begin(), m_symbols.end(),
+        [](const Symbol& a, const Symbol& b) { return a.address == b.address; }),
+        m_symbols.end());
+
+    if (!debugLine.isEmpty()) {
+        parseLineTable(debugLine, debugLineStr, debugStr);
+    }
+    return true;
+}
+
+void ElfSymbolizer::parseLineTable(const QByteArray& lines, const QByteArray& lineStrings,
+                                   const QByteArray& strings)
+{
+    Cursor cursor(lines);
+    while (!cursor.atEnd()) {
+        // Unit header
+        bool dwarf64 = false;
+        uint64_t unitLength = cursor.u32();
+        if (unitLength == 0xffffffff) {
+            dwarf64 = true;
+            unitLength = cursor.fixed(8);
+        }
+        if (cursor.failed || unitLength > cursor.size - cursor.pos) {
+            break;
+        }
+        const size_t unitEnd = cursor.pos + unitLength;
+
+        const uint16_t version = cursor.u16();
+        if (version < 2 || version > 5) {
+            cursor.pos = unitEnd;
+            continue;
+        }
+        if (version >= 5) {
+            cursor.skip(2);     // Address and segment selector sizes
+        }
+        const uint64_t headerLength = cursor.fixed(dwarf64 ? 8 : 4);
+        const size_t programStart = cursor.pos + headerLength;
+
+        const uint8_t minInstruction = cursor.u8();
+        if (version >= 4) {
+            cursor.u8();        // VLIW operations per instruction; always 1 here
+        }
+        const bool defaultIsStmt = cursor.u8() != 0;
+        Q_UNUSED(defaultIsStmt);
+        const int8_t lineBase = static_cast<int8_t>(cursor.u8());
+        const uint8_t lineRange = cursor.u8();
+        const uint8_t opcodeBase = cursor.u8();
+        std::vector<uint8_t> opcodeLengths;
+        for (int i = 1; i < opcodeBase; ++i) {
+            opcodeLengths.push_back(cursor.u8());
+        }
+        if (cursor.failed || lineRange == 0) {
+            break;
+        }
+
+        // This unit's file table, as indexes into m_files
+        std::vector<uint32_t> files;
+        if (version >= 5) {
+            std::vector<std::pair<QString, uint64_t>> directories, names;
+            if (!readEntryTable(cursor, dwarf64, lineStrings, strings, directories)
+                || !readEntryTable(cursor, dwarf64, lineStrings, strings, names)) {
+                cursor.pos = unitEnd;
+                continue;
+            }
+            for (const auto& name : names) {
+                const QString directory = name.second < directories.size()
+                    ? directories[name.second].first : QString();
+                files.push_back(fileId(joinPath(directory, name.first)));
+            }
+        } else {
+            QStringList directories{QString()};     // 0: the compilation directory
+            for (QString directory = cursor.string(); !directory.isEmpty(); directory = cursor.string()) {
+                directories.append(directory);
+            }
+            files.push_back(0);                     // Numbering starts at 1
+            for (QString name = cursor.string(); !name.isEmpty(); name = cursor.string()) {
+                const uint64_t directory = cursor.uleb();
+                cursor.uleb();                      // Modification time
+                cursor.uleb();                      // Length
+                files.push_back(fileId(joinPath(directories.value(static_cast<int>(directory)), name)));
+            }
+        }
+
+        // Line number program
+        cursor.pos = programStart;
+        uint64_t address = 0;
+        uint64_t fileNumber = 1;
+        int64_t line = 1;
+        auto emitRow = [&](bool endSequence) {
+            const uint32_t file = fileNumber < files.size() ? files[fileNumber] : 0;
+            m_rows.push_back(LineRow{static_cast<uint32_t>(address), file,
+                                     endSequence ? 0 : static_cast<int32_t>(line)});
+        };
+
+        while (cursor.pos < unitEnd && !cursor.failed) {
+            const uint8_t opcode = cursor.u8();
+            if (opcode >= opcodeBase) {
+                const int adjusted = opcode - opcodeBase;
+                address += static_cast<uint64_t>(adjusted / lineRange) * minInstruction;
+                line += lineBase + adjusted % lineRange;
+                emitRow(false);
+                continue;
+            }
+
+            switch (opcode) {
+            case 0: {   // Extended
+                const uint64_t length = cursor.uleb();
+                const size_t next = cursor.pos + length;
+                const uint8_t extended = length > 0 ? cursor.u8() : 0;
+                if (extended == 1) {            // DW_LNE_end_sequence
+                    emitRow(true);
+                    address = 0;
+                    fileNumber = 1;
+                    line = 1;
+                } else if (extended == 2) {     // DW_LNE_set_address
+                    address = cursor.fixed(static_cast<int>(std::min<uint64_t>(length - 1, 8)));
+                } else if (extended == 3) {     // DW_LNE_define_file
+                    const QString name = cursor.string();
+                    cursor.uleb();
+                    cursor.uleb();
+                    cursor.uleb();
+                    files.push_back(fileId(name));
+                }
+                cursor.pos = next;
+                break;
+            }
+            case 1:     // DW_LNS_copy
+                emitRow(false);
+                break;
+            case 2:     // DW_LNS_advance_pc
+                address += cursor.uleb() * minInstruction;
+                break;
+            case 3:     // DW_LNS_advance_line
+                line += cursor.sleb();
+                break;
+            case 4:     // DW_LNS_set_file
+                fileNumber = cursor.uleb();
+                break;
+            case 8:     // DW_LNS_const_add_pc
+                address += static_cast<uint64_t>((255 - opcodeBase) / lineRange) * minInstruction;
+                break;
+            case 9:     // DW_LNS_fixed_advance_pc
+                address += cursor.u16();
+                break;
+            default:    // Anything else only has operands to skip
+                for (int i = 0; i < opcodeLengths[opcode - 1]; ++i) {
+                    cursor.uleb();
+                }
+                break;
+            }
+        }
+        cursor.failed = false;
+        cursor.pos = unitEnd;
+    }
+
+    // Where one sequence ends at the address the next starts, the end row
+    // goes first so the lookup lands on the start of the next one
+    std::stable_sort(m_rows.begin(), m_rows.end(), [](const LineRow& a, const LineRow& b) {
+        return a.address != b.address ? a.address < b.address : (a.line == 0 && b.line != 0);
+    });
+    m_fileIndex.clear();
+}
+
+uint32_t ElfSymbolizer::fileId(const QString& path)
+{
+    // Every compilation unit repeats the headers it includes
+    auto it = m_fileIndex.constFind(path);
+    if (it != m_fileIndex.constEnd()) {
+        return it.value();
+    }
+    const uint32_t id = static_cast<uint32_t>(m_files.size());
+    m_files.append(path);
+    m_fileIndex.insert(path, id);
+    return id;
+}
+
+uint32_t ElfSymbolizer::normalize(uint32_t address) const
+{
+    // Xtensa return addresses carry the caller's window size in the top
+    // two bits; code always lives at 0x4xxxxxxx
+    if (m_xtensa && (address & 0xc0000000) != 0x40000000 && (address & 0xc0000000) != 0) {
+        return (address & 0x3fffffff) | 0x40000000;
+    }
+    return address;
+}
+
+bool ElfSymbolizer::isCode(uint32_t address) const
+{
+    auto range = std::upper_bound(m_code.begin(), m_code.end(), address,
+        [](uint32_t value, const Range& r) { return value < r.start; });
+    return range != m_code.begin() && address < (range - 1)->end;
+}
@@ -0,0 +1,128 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef ELFSYMBOLIZER_H
+#define ELFSYMBOLIZER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/**
+ * Resolves code addresses to functions (and source lines) using the
+ * application ELF, for annotating panic output
+ *
+ * Loading turns the symbol table into a sorted array of address intervals
+ * and, if the ELF has DWARF line info, runs the .debug_line programs once
+ * into a sorted row table. Every lookup after that is a binary search,
+ * cheap enough for a crash loop. Loading reads the whole ELF, so the GUI
+ * starts it on a worker thread with loadInBackground(); otherwise the
+ * first lookup loads it.
+ * Only 32-bit little-endian ELF files are supported, which covers every
+ * ESP32 variant (Xtensa and RISC-V).
+ */
+class ElfSymbolizer {
+public:
+    struct Location {
+        uint32_t address = 0;
+        QString function;       // Demangled
+        uint32_t offset = 0;    // From the start of the function
+        QString file;           // Empty without line info
+        int line = 0;
+    };
+
+    explicit ElfSymbolizer(const QString& elfPath);
+    ~ElfSymbolizer();
+
+    /**
+     * Build the index on a worker thread; lookups find nothing until
+     * isReady(). Calling it again does nothing.
+     */
+    void loadInBackground();
+
+    /**
+     * The index is built (or failed to build)
+     */
+    bool isReady() const { return m_ready.load(std::memory_order_acquire); }
+
+    QString elfPath() const { return m_path; }
+
+    /**
+     * The file hasn't been rebuilt since this symbolizer was made
+     */
+    bool isCurrent() const;
+
+    /**
+     * Function (and source line) containing address
+     * Loads the ELF on first use, unless it is loading in the background;
+     * nullopt if it isn't code we know (or isn't known yet).
+     */
+    std::optional<Location> lookup(uint32_t address);
+
+    /**
+     * One annotation per code address in a line of device output, e.g.
+     * "0x42001234: app_main at /src/main.c:42"
+     * Finds backtraces, register dumps, "abort() was called at PC ..." and
+     * so on alike: any hex word that falls inside executable code.
+     */
+    QStringList annotate(const QString& line);
+
+    /**
+     * Why loading failed, if it did
+     */
+    QString errorString() const { return isReady() ? m_error : QString(); }
+
+private:
+    struct Symbol {
+        uint32_t address;
+        uint32_t size;          // 0: extends to the next symbol
+        uint32_t nameOffset;    // Into m_strtab
+    };
+
+    struct LineRow {
+        uint32_t address;
+        uint32_t file;          // Into m_files
+        int32_t line;           // 0 ends a sequence
+    };
+
+    struct Range {
+        uint32_t start;
+        uint32_t end;
+    };
+
+    void ensureLoaded();
+    void finishLoading();
+    bool load();
+    void parseLineTable(const QByteArray& lines, const QByteArray& lineStrings,
+                        const QByteArray& strings);
+    uint32_t fileId(const QString& path);
+    uint32_t normalize(uint32_t address) const;
+    bool isCode(uint32_t address) const;
+
+    QString m_path;
+    QDateTime m_modified;
+    bool m_loaded = false;      // Loading started
+    QString m_error;
+
+    // Everything below is written by the loader until m_ready is set
+    std::thread m_loader;
+    std::atomic<bool> m_ready{false};
+
+    bool m_xtensa = false;
+    std::vector<Range> m_code;          // Executable sections
+    std::vector<Symbol> m_symbols;      // By address
+    QByteArray m_strtab;
+    std::vector<LineRow> m_rows;        // By address
+    QStringList m_files;
+    QHash<QString, uint32_t> m_fileIndex;   // Only while parsing
+};
+
+#endif // ELFSYMBOLIZER_H
@@ -0,0 +1,139 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "FlashJournal.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+QByteArray FlashJournal::firmwareHash(const FirmwareFile& firmware)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    for (const auto& image : firmware.images()) {
+        QByteArray offset(4, '\0');
+        for (int i = 0; i < 4; ++i) {
+            offset[i] = static_cast<char>((image.offset >> (i * 8)) & 0xFF);
+        }
+        hash.addData(offset);
+        hash.addData(image.data);
+    }
+    return hash.result();
+}
+
+bool FlashJournal::open(const QString& serialNumber, const QByteArray& firmwareHash)
+{
+    m_path.clear();
+    m_acked.clear();
+    m_unsavedBytes = 0;
+    m_firmwareHash = firmwareHash;
+
+    if (serialNumber.isEmpty()) {
+        return false;
+    }
+
+    m_path = pathFor(serialNumber);
+
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("firmwareSha256").toString() != QString::fromLatin1(firmwareHash.toHex())) {
+        // Different firmware - its progress means nothing for this one
+        return false;
+    }
+
+    for (const auto& value : root.value("images").toArray()) {
+        QJsonObject image = value.toObject();
+        uint32_t offset = static_cast<uint32_t>(image.value("offset").toInteger());
+        uint32_t acked = static_cast<uint32_t>(image.value("acked").toInteger());
+        if (acked > 0) {
+            m_acked[offset] = acked;
+        }
+    }
+
+    return !m_acked.empty();
+}
+
+uint32_t FlashJournal::ackedBytes(uint32_t imageOffset) const
+{
+    auto it = m_acked.find(imageOffset);
+    return it != m_acked.end() ? it->second : 0;
+}
+
+void FlashJournal::setAcked(uint32_t imageOffset, uint32_t bytes)
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    uint32_t previous = ackedBytes(imageOffset);
+    m_acked[imageOffset] = bytes;
+
+    if (bytes > previous) {
+        m_unsavedBytes += bytes - previous;
+        if (m_unsavedBytes >= SAVE_INTERVAL) {
+            save();
+        }
+    } else if (bytes < previous) {
+        // Never leave a journal on disk that claims more than is written
+        save();
+    }
+}
+
+void FlashJournal::save()
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    QJsonArray images;
+    for (const auto& entry : m_acked) {
+        QJsonObject image;
+        image.insert("offset", static_cast<qint64>(entry.first));
+        image.insert("acked", static_cast<qint64>(entry.second));
+        images.append(image);
+    }
+
+    QJsonObject root;
+    root.insert("firmwareSha256", QString::fromLatin1(m_firmwareHash.toHex()));
+    root.insert("images", images);
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+
+    // Atomic replace, so a crash mid-write can't leave a corrupt journal
+    QSaveFile file(m_path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+
+    m_unsavedBytes = 0;
+}
+
+void FlashJournal::discard()
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    QFile::remove(m_path);
+    m_acked.clear();
+    m_unsavedBytes = 0;
+}
+
+QString FlashJournal::pathFor(const QString& serialNumber)
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QString("%1/journals/%2.json")
+        .arg(dir, QString::fromLatin1(serialNumber.toUtf8().toHex()));
+}
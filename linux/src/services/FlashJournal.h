@@ -0,0 +1,80 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef FLASHJOURNAL_H
+#define FLASHJOURNAL_H
+
+#include "models/FirmwareFile.h"
+
+#include <QByteArray>
+#include <QString>
+#include <map>
+#include <cstdint>
+
+/**
+ * Persistent record of how much of each image the ROM has acknowledged
+ *
+ * One JSON file per device (by USB serial number) in the application data
+ * directory, tagged with the SHA-256 of the firmware being written. If a
+ * flash is interrupted, the next attempt with the same board and the same
+ * firmware can verify the acknowledged regions and carry on from there.
+ *
+ * Images are written front to back, so each image's progress is a single
+ * acknowledged range starting at its offset.
+ */
+class FlashJournal {
+public:
+    FlashJournal() = default;
+
+    /**
+     * SHA-256 over the offsets and contents of all images
+     */
+    static QByteArray firmwareHash(const FirmwareFile& firmware);
+
+    /**
+     * Start journaling a flash
+     * Loads the existing journal if it was written for the same firmware,
+     * otherwise starts empty. Devices without a serial number can't be
+     * told apart, so nothing is journaled for them.
+     * @return true if there is earlier progress to resume from
+     */
+    bool open(const QString& serialNumber, const QByteArray& firmwareHash);
+
+    /**
+     * Bytes acknowledged from the start of the image at offset
+     */
+    uint32_t ackedBytes(uint32_t imageOffset) const;
+
+    /**
+     * Record acknowledged progress for an image
+     * Can move backwards (a resumed session rewrites part of a sector).
+     * Written to disk every SAVE_INTERVAL bytes of progress.
+     */
+    void setAcked(uint32_t imageOffset, uint32_t bytes);
+
+    /**
+     * Write the journal to disk now
+     */
+    void save();
+
+    /**
+     * Delete the journal (flash completed, or progress is not trustworthy)
+     */
+    void discard();
+
+    bool isOpen() const { return !m_path.isEmpty(); }
+
+private:
+    static QString pathFor(const QString& serialNumber);
+
+    QString m_path;
+    QByteArray m_firmwareHash;
+    std::map<uint32_t, uint32_t> m_acked;
+    uint32_t m_unsavedBytes = 0;
+
+    // Rewriting the file per 1 KB block would cost more than it saves
+    static constexpr uint32_t SAVE_INTERVAL = 64 * 1024;
+};
+
+#endif // FLASHJOURNAL_H
@@ -0,0 +1,286 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "FlashPlan.h"
+#include "TimeoutEstimator.h"
+#include "protocol/ESP32Protocol.h"
+
+#include <algorithm>
+
+namespace {
+
+// FLASH_DATA header (16 bytes) plus the command header (8 bytes)
+constexpr int FLASH_DATA_OVERHEAD = 24;
+
+// Small commands: header plus a few words of payload
+constexpr int SMALL_COMMAND_BYTES = 32;
+
+// Settle time around a baud rate change (see FlashingService::changeBaudRate)
+constexpr double BAUD_CHANGE_SECONDS = 0.1;
+
+// Time from FLASH_END to a confirmed reset
+constexpr double REBOOT_SECONDS = 0.3;
+
+struct Extent {
+    uint32_t address;
+    QByteArray data;
+    QString label;
+
+    uint32_t end() const { return address + static_cast<uint32_t>(data.size()); }
+};
+
+uint32_t alignDown(uint32_t value)
+{
+    return value - (value % ESP32Protocol::FLASH_SECTOR_SIZE);
+}
+
+uint32_t alignUp(uint32_t value)
+{
+    return alignDown(value + ESP32Protocol::FLASH_SECTOR_SIZE - 1);
+}
+
+void appendWrites(std::vector<FlashOp>& ops, const std::vector<Extent>& extents,
+                  const FlashPlan::Options& options)
+{
+    for (const Extent& extent : extents) {
+        FlashOp erase;
+        erase.type = FlashOpType::EraseRegion;
+        erase.address = extent.address;
+        erase.size = static_cast<uint32_t>(extent.data.size());
+        erase.data = extent.data;
+        erase.label = extent.label;
+        ops.push_back(erase);
+
+        FlashOp write = erase;
+        write.type = FlashOpType::WriteExtent;
+        ops.push_back(write);
+
+        if (options.verify) {
+            FlashOp verify = erase;
+            verify.type = FlashOpType::Verify;
+            ops.push_back(verify);
+        }
+    }
+}
+
+} // anonymous namespace
+
+QString FlashOp::name() const
+{
+    switch (type) {
+    case FlashOpType::Reset:
+        return "reset";
+    case FlashOpType::Sync:
+        return "sync";
+    case FlashOpType::SetBaud:
+        return "set-baud";
+    case FlashOpType::Attach:
+        return "attach";
+    case FlashOpType::EraseRegion:
+        return "erase";
+    case FlashOpType::WriteExtent:
+        return "write";
+    case FlashOpType::Verify:
+        return "verify";
+    case FlashOpType::Reboot:
+        return "reboot";
+    }
+    return "unknown";
+}
+
+QString FlashOp::describe() const
+{
+    switch (type) {
+    case FlashOpType::SetBaud:
+        return QString("%1 %2").arg(name()).arg(baudRateValue(baudRate));
+    case FlashOpType::EraseRegion:
+    case FlashOpType::WriteExtent:
+    case FlashOpType::Verify:
+        return QString("%1 0x%2 +0x%3 (%4)")
+            .arg(name())
+            .arg(address, 8, 16, QChar('0'))
+            .arg(size, 8, 16, QChar('0'))
+            .arg(label);
+    default:
+        return name();
+    }
+}
+
+FlashPlan FlashPlan::build(const FirmwareFile& firmware, const Options& options)
+{
+    FlashPlan plan;
+    plan.m_options = options;
+    plan.m_source = firmware;
+
+    // ESP32 and ESP32-S2 keep the second-stage bootloader at 0x1000
+    const ESP32ChipDescriptor& chip = ESP32Chips::descriptor(options.chip);
+    plan.m_target = firmware.withBootloaderOffset(chip.bootloaderOffset);
+
+    if (options.connect) {
+        FlashOp reset;
+        reset.type = FlashOpType::Reset;
+        plan.m_ops.push_back(reset);
+
+        FlashOp sync;
+        sync.type = FlashOpType::Sync;
+        plan.m_ops.push_back(sync);
+
+        if (options.baudRate != BaudRate::Baud115200) {
+            FlashOp setBaud;
+            setBaud.type = FlashOpType::SetBaud;
+            setBaud.baudRate = options.baudRate;
+            plan.m_ops.push_back(setBaud);
+        }
+
+        // Required for ROM bootloader before flash operations
+        FlashOp attach;
+        attach.type = FlashOpType::Attach;
+        attach.attempts = 2;
+        plan.m_ops.push_back(attach);
+    }
+
+    std::vector<Extent> extents;
+    for (const auto& image : plan.m_target.images()) {
+        extents.push_back({image.offset, image.data, image.fileName()});
+    }
+    appendWrites(plan.m_ops, extents, options);
+
+    if (options.reboot) {
+        FlashOp reboot;
+        reboot.type = FlashOpType::Reboot;
+        plan.m_ops.push_back(reboot);
+    }
+
+    return plan;
+}
+
+FlashPlan FlashPlan::forChip(ESP32ChipFamily chip) const
+{
+    Options options = m_options;
+    options.chip = chip;
+
+    FlashPlan plan = build(m_source, options);
+    if (m_optimized) {
+        plan.optimize();
+    }
+    return plan;
+}
+
+void FlashPlan::optimize()
+{
+    m_optimized = true;
+
+    std::vector<FlashOp> before;
+    std::vector<FlashOp> after;
+    std::vector<Extent> extents;
+
+    for (const FlashOp& op : m_ops) {
+        switch (op.type) {
+        case FlashOpType::WriteExtent:
+            extents.push_back({op.address, op.data, op.label});
+            break;
+        case FlashOpType::EraseRegion:
+        case FlashOpType::Verify:
+            break;
+        case FlashOpType::Reboot:
+            after.push_back(op);
+            break;
+        default:
+            before.push_back(op);
+            break;
+        }
+    }
+
+    std::vector<Extent> sorted = extents;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Extent& a, const Extent& b) {
+        return a.address < b.address;
+    });
+
+    // Later images overwrite earlier ones where they overlap, so the
+    // package order matters and nothing may be moved or merged
+    for (size_t i = 1; i < sorted.size(); ++i) {
+        if (sorted[i].address < sorted[i - 1].end()) {
+            return;
+        }
+    }
+
+    std::vector<Extent> merged;
+    for (const Extent& extent : sorted) {
+        if (!merged.empty()) {
+            Extent& last = merged.back();
+
+            // The gap only spans sectors both FLASH_BEGINs would erase anyway;
+            // filling it with 0xFF writes nothing that erasing didn't
+            if (alignUp(last.end()) >= alignDown(extent.address)) {
+                last.data.append(QByteArray(static_cast<int>(extent.address - last.end()),
+                                            static_cast<char>(0xFF)));
+                last.data.append(extent.data);
+                last.label += " + " + extent.label;
+                continue;
+            }
+        }
+        merged.push_back(extent);
+    }
+
+    m_ops = before;
+    appendWrites(m_ops, merged, m_options);
+    m_ops.insert(m_ops.end(), after.begin(), after.end());
+}
+
+double FlashPlan::estimateSeconds(const FlashOp& op, const TimeoutEstimator& timeouts) const
+{
+    switch (op.type) {
+    case FlashOpType::Reset:
+        return m_options.resetMs / 1000.0;
+    case FlashOpType::Sync:
+    case FlashOpType::Attach:
+        return timeouts.expectedRoundTrip(SMALL_COMMAND_BYTES);
+    case FlashOpType::SetBaud:
+        return BAUD_CHANGE_SECONDS + timeouts.expectedRoundTrip(SMALL_COMMAND_BYTES);
+    case FlashOpType::EraseRegion:
+        return timeouts.expectedRoundTrip(SMALL_COMMAND_BYTES) + timeouts.expectedEraseTime(op.size);
+    case FlashOpType::WriteExtent: {
+        int blockSize = ESP32Protocol::FLASH_BLOCK_SIZE;
+        int blocks = (static_cast<int>(op.size) + blockSize - 1) / blockSize;
+        double perBlock = timeouts.expectedRoundTrip(blockSize + FLASH_DATA_OVERHEAD)
+                          + m_options.blockDelayMs / 1000.0;
+        return blocks * perBlock;
+    }
+    case FlashOpType::Verify:
+        return timeouts.expectedRoundTrip(SMALL_COMMAND_BYTES) + timeouts.expectedMd5Time(op.size);
+    case FlashOpType::Reboot:
+        return REBOOT_SECONDS;
+    }
+    return 0.0;
+}
+
+double FlashPlan::estimateSeconds(const TimeoutEstimator& timeouts) const
+{
+    double total = 0.0;
+    for (const FlashOp& op : m_ops) {
+        total += estimateSeconds(op, timeouts);
+    }
+    return total;
+}
+
+QStringList FlashPlan::describe(const TimeoutEstimator& timeouts) const
+{
+    QStringList lines;
+    for (const FlashOp& op : m_ops) {
+        lines << QString("%1  ~%2 s").arg(op.describe()).arg(estimateSeconds(op, timeouts), 0, 'f', 2);
+    }
+    lines << QString("total  ~%1 s").arg(estimateSeconds(timeouts), 0, 'f', 1);
+    return lines;
+}
+
+int FlashPlan::writeBytes() const
+{
+    int total = 0;
+    for (const FlashOp& op : m_ops) {
+        if (op.type == FlashOpType::WriteExtent) {
+            total += static_cast<int>(op.size);
+        }
+    }
+    return total;
+}
@@ -0,0 +1,159 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef FLASHPLAN_H
+#define FLASHPLAN_H
+
+#include "models/SerialPort.h"
+#include "models/FirmwareFile.h"
+#include "protocol/ESP32Chip.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include <cstdint>
+
+class TimeoutEstimator;
+
+/**
+ * Kinds of step in a flash plan
+ */
+enum class FlashOpType {
+    Reset,          // Open the port and reset the chip into the ROM loader
+    Sync,           // Establish the command channel, identify the chip
+    SetBaud,        // Switch both ends to a faster baud rate
+    Attach,         // SPI_ATTACH the flash chip
+    EraseRegion,    // FLASH_BEGIN: erase a region and open a write session
+    WriteExtent,    // FLASH_DATA blocks into the open session
+    Verify,         // SPI_FLASH_MD5 a region against the expected data
+    Reboot          // FLASH_END and reset into the new firmware
+};
+
+/**
+ * One step of a flash plan
+ */
+struct FlashOp {
+    FlashOpType type = FlashOpType::Sync;
+
+    /// Flash region (EraseRegion, WriteExtent, Verify)
+    uint32_t address = 0;
+    uint32_t size = 0;
+
+    /// Bytes to write or check (WriteExtent, Verify)
+    QByteArray data;
+
+    /// Where the data came from, e.g. "bootloader.bin"
+    QString label;
+
+    /// Target rate (SetBaud)
+    BaudRate baudRate = BaudRate::Baud115200;
+
+    /// How many times the executor may run this op before failing
+    int attempts = 1;
+
+    /**
+     * Short name, e.g. "erase"
+     */
+    QString name() const;
+
+    /**
+     * One-line description, e.g. "erase 0x00010000 +0x00040000 (firmware.bin)"
+     */
+    QString describe() const;
+};
+
+/**
+ * Ordered list of operations that flashes a firmware package
+ *
+ * Built from the firmware and options before anything touches the port,
+ * so it can be inspected, estimated and dry-run. Speed optimizations are
+ * transformations of the plan (see optimize()) rather than changes to
+ * the executor in FlashingService.
+ */
+class FlashPlan {
+public:
+    struct Options {
+        /// Chip the plan is for; decides the bootloader offset
+        ESP32ChipFamily chip = ESP32ChipFamily::Unknown;
+
+        /// Rate to flash at (115200 means no SetBaud op)
+        BaudRate baudRate = BaudRate::Baud115200;
+
+        /// Check every written extent with SPI_FLASH_MD5
+        bool verify = false;
+
+        /// Start with reset, sync, baud change and SPI attach (false when
+        /// the loader is already attached, e.g. in a session)
+        bool connect = true;
+
+        /// End with a reboot into the new firmware
+        bool reboot = true;
+
+        /// Pause after each data block (USB-JTAG-Serial pacing)
+        int blockDelayMs = 0;
+
+        /// Expected time from reset to a ready loader, for estimates
+        int resetMs = 500;
+    };
+
+    FlashPlan() = default;
+
+    /**
+     * Build the straightforward plan: one erase + write per image, in
+     * package order
+     */
+    static FlashPlan build(const FirmwareFile& firmware, const Options& options);
+
+    /**
+     * Same plan for a different chip (bootloader offset may move)
+     * Keeps optimization if this plan was optimized.
+     */
+    FlashPlan forChip(ESP32ChipFamily chip) const;
+
+    /**
+     * Sort writes by address and merge neighbouring extents whose gap lies
+     * in sectors that would be erased anyway, saving a FLASH_BEGIN and a
+     * duplicate partial-sector erase for each merge. Overlapping images
+     * keep their package order.
+     */
+    void optimize();
+
+    /**
+     * Expected duration of one op, in seconds
+     */
+    double estimateSeconds(const FlashOp& op, const TimeoutEstimator& timeouts) const;
+
+    /**
+     * Expected duration of the whole plan, in seconds
+     */
+    double estimateSeconds(const TimeoutEstimator& timeouts) const;
+
+    /**
+     * Dry run: one line per op with its estimated duration
+     */
+    QStringList describe(const TimeoutEstimator& timeouts) const;
+
+    const std::vector<FlashOp>& ops() const { return m_ops; }
+    const Options& options() const { return m_options; }
+
+    /**
+     * The firmware as it will be laid out in flash for this chip
+     */
+    const FirmwareFile& target() const { return m_target; }
+
+    /**
+     * Total bytes written by WriteExtent ops
+     */
+    int writeBytes() const;
+
+private:
+    std::vector<FlashOp> m_ops;
+    Options m_options;
+    FirmwareFile m_source;
+    FirmwareFile m_target;
+    bool m_optimized = false;
+};
+
+#endif // FLASHPLAN_H
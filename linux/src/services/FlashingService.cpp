@@ -5,8 +5,14 @@
 #include "FlashingService.h"
 #include "protocol/SLIPCodec.h"
 #include "protocol/ESP32Protocol.h"
+#include "serial/ResetSequence.h"
 
+#include <QCryptographicHash>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutexLocker>
+#include <algorithm>
 #include <thread>
 #include <chrono>
 
@@ -25,6 +31,11 @@ FlashingService::~FlashingService()
 }
 
 void FlashingService::flash(const FirmwareFile& firmware, const SerialPort& port, BaudRate baudRate)
+{
+    flash(planFor(firmware, port, baudRate), port);
+}
+
+void FlashingService::flash(const FlashPlan& plan, const SerialPort& port)
 {
     if (m_isFlashing) {
         return;
@@ -34,8 +45,8 @@ void FlashingService::flash(const FirmwareFile& firmware, const SerialPort& port
     m_isFlashing = true;
 
     // Run flashing in a separate thread
-    m_workerThread = QThread::create([this, firmware, port, baudRate]() {
-        runFlashing(firmware, port, baudRate);
+    m_workerThread = QThread::create([this, plan, port]() {
+        runFlashing(plan, port);
     });
 
     connect(m_workerThread, &QThread::finished, m_workerThread, &QThread::deleteLater);
@@ -49,233 +60,948 @@ void FlashingService::flash(const FirmwareFile& firmware, const SerialPort& port
 void FlashingService::cancel()
 {
     m_isCancelled = true;
+
+    // Wake an idle session so it can wind down
+    QMutexLocker locker(&m_jobMutex);
+    m_jobAvailable.wakeAll();
 }
 
-void FlashingService::runFlashing(const FirmwareFile& firmware, const SerialPort& port, BaudRate baudRate)
+void FlashingService::beginSession(const SerialPort& port, BaudRate baudRate)
 {
-    m_connection = std::make_unique<SerialConnection>();
+    if (m_isFlashing) {
+        return;
+    }
 
-    auto cleanup = [this]() {
-        if (m_connection) {
-            m_connection->close();
-            m_connection.reset();
+    m_isCancelled = false;
+    m_isFlashing = true;
+    m_sessionOpen = true;
+
+    {
+        QMutexLocker locker(&m_jobMutex);
+        m_jobs.clear();
+        m_endRequested = false;
+        m_rebootOnEnd = true;
+    }
+
+    // Connect only: reset, sync, baud change and SPI attach
+    FlashPlan::Options options = planOptionsFor(port, baudRate);
+    options.reboot = false;
+    FlashPlan plan = FlashPlan::build(FirmwareFile(), options);
+
+    m_workerThread = QThread::create([this, plan, port]() {
+        runSession(plan, port);
+    });
+
+    connect(m_workerThread, &QThread::finished, m_workerThread, &QThread::deleteLater);
+    connect(m_workerThread, &QThread::finished, this, [this]() {
+        m_workerThread = nullptr;
+    });
+
+    m_workerThread->start();
+}
+
+int FlashingService::submit(SessionJob job)
+{
+    QMutexLocker locker(&m_jobMutex);
+    if (!m_sessionOpen || m_endRequested) {
+        return 0;
+    }
+
+    job.id = m_nextJobId++;
+    m_jobs.push_back(job);
+    m_jobAvailable.wakeAll();
+    return job.id;
+}
+
+void FlashingService::endSession(bool reboot)
+{
+    QMutexLocker locker(&m_jobMutex);
+    m_endRequested = true;
+    m_rebootOnEnd = reboot;
+    m_jobAvailable.wakeAll();
+}
+
+FlashPlan FlashingService::planFor(const FirmwareFile& firmware, const SerialPort& port,
+                                   BaudRate baudRate) const
+{
+    FlashPlan plan = FlashPlan::build(firmware, planOptionsFor(port, baudRate));
+    plan.optimize();
+    return plan;
+}
+
+FlashPlan::Options FlashingService::planOptionsFor(const SerialPort& port, BaudRate baudRate) const
+{
+    // With a hardware handshake neither side can overrun the other, so
+    // the pacing and the ceilings learned without one don't apply
+    const bool flowControlled = PortSettings::forPort(port).effectiveFlowControl() == FlowControl::RtsCts;
+
+    FlashPlan::Options options;
+    options.baudRate = baudRate;
+    options.blockDelayMs = flowControlled ? 0 : BLOCK_DELAY_MS;
+
+    // What worked last time for this board, if we have seen it before
+    if (std::optional<DeviceProfile> cached = m_profileCache.lookup(port.serialNumber)) {
+        // Don't retry a baud rate this board has already failed at
+        if (cached->baudLimited && !flowControlled &&
+            baudRateValue(cached->bestBaudRate) < baudRateValue(baudRate)) {
+            options.baudRate = cached->bestBaudRate;
         }
+        options.chip = cached->chip;
+        options.resetMs = ResetSequence::forStrategy(cached->resetStrategy)
+                              .scaled(cached->resetTimingScale)
+                              .totalWaitMs()
+                          + cached->readyMs;
+    }
+
+    return options;
+}
+
+QStringList FlashingService::dryRun(const FirmwareFile& firmware, const SerialPort& port,
+                                    BaudRate baudRate) const
+{
+    FlashPlan plan = planFor(firmware, port, baudRate);
+
+    TimeoutEstimator estimator;
+    estimator.setBaudRate(baudRateValue(plan.options().baudRate));
+    if (std::optional<DeviceProfile> cached = m_profileCache.lookup(port.serialNumber)) {
+        estimator.setEraseMsPerSector(cached->eraseMsPerSector);
+    }
+    return plan.describe(estimator);
+}
+
+void FlashingService::adoptConnection(std::unique_ptr<SerialConnection> connection)
+{
+    QMutexLocker locker(&m_handoffMutex);
+    m_handoff = std::move(connection);
+    m_handBack = m_handoff != nullptr;
+}
+
+std::unique_ptr<SerialConnection> FlashingService::releaseConnection()
+{
+    QMutexLocker locker(&m_handoffMutex);
+    return std::move(m_handoff);
+}
+
+void FlashingService::releasePort()
+{
+    QMutexLocker locker(&m_handoffMutex);
+
+    if (m_connection && m_handBack && m_connection->isConnected() && !m_connection->isHungUp()) {
+        m_handoff = std::move(m_connection);
+    } else if (m_connection) {
+        m_connection->close();
+        m_connection.reset();
+    }
+    m_handBack = false;
+}
+
+FlashingService::RunContext FlashingService::startRun(const SerialPort& port)
+{
+    {
+        QMutexLocker locker(&m_handoffMutex);
+        m_connection = m_handoff ? std::move(m_handoff) : std::make_unique<SerialConnection>();
+    }
+
+    m_bootFailureReason.clear();
+    m_port = port;
+    m_chip = &ESP32Chips::descriptor(ESP32ChipFamily::ESP32C3);
+    m_timeouts = TimeoutEstimator();
+    m_journal = FlashJournal();
+
+    m_report = FlashReport();
+    m_report.serialNumber = port.serialNumber;
+    m_report.startedAt = QDateTime::currentDateTime();
+
+    m_linkBaudRate = BaudRate::Baud115200;
+    m_lineErrorBase.reset();
+    m_lineErrorsAtRate = 0;
+    m_retriesBeforeRate = 0;
+
+    RunContext ctx;
+    ctx.port = port;
+    ctx.settings = PortSettings::forPort(port);
+    ctx.cached = m_profileCache.lookup(port.serialNumber);
+    ctx.profile.serialNumber = port.serialNumber;
+    if (ctx.cached) {
+        ctx.profile.bestBaudRate = ctx.cached->bestBaudRate;
+        ctx.profile.baudLimited = ctx.cached->baudLimited;
+        m_timeouts.setEraseMsPerSector(ctx.cached->eraseMsPerSector);
+    }
+    return ctx;
+}
+
+void FlashingService::rememberSuccess(RunContext& ctx, BaudRate baudRate)
+{
+    const bool clean = m_report.totalRetries() == 0 && m_report.resyncs == 0 &&
+                       m_report.lineErrors() == 0;
+    if (!m_report.baudDowngrades.empty()) {
+        // It only finished after stepping down; start there next time
+        ctx.profile.bestBaudRate = m_linkBaudRate;
+        ctx.profile.baudLimited = true;
+    } else if (ctx.profile.baudLimited && clean && baudRate == ctx.profile.bestBaudRate) {
+        // Flawless at the ceiling: the limit may have been a bad cable or
+        // a one-off, so try one rate higher next time. A link that still
+        // can't take it steps back down during that run.
+        ctx.profile.bestBaudRate = higherBaudRate(baudRate);
+        ctx.profile.baudLimited = ctx.profile.bestBaudRate != baudRate;
+    } else if (baudRateValue(baudRate) > baudRateValue(ctx.profile.bestBaudRate)) {
+        ctx.profile.bestBaudRate = baudRate;
+    }
+    ctx.profile.eraseMsPerSector = m_timeouts.eraseMsPerSector();
+    ctx.profile.lastSeen = QDateTime::currentDateTime();
+    m_profileCache.store(ctx.profile);
+}
+
+void FlashingService::rememberFailure(RunContext& ctx, BaudRate baudRate, FlashingErrorType errorType)
+{
+    if (m_isCancelled) {
+        return;
+    }
+
+    if (!ctx.synced) {
+        // The remembered fast path (if any) no longer works for this board
+        m_profileCache.forget(ctx.port.serialNumber);
+    } else if (ctx.baudChanged && isLinkFailure(errorType)) {
+        // Connection was fine but the link failed at speed - step down next time
+        BaudRate failedAt = m_report.baudDowngrades.empty() ? baudRate : m_linkBaudRate;
+        ctx.profile.bestBaudRate = lowerBaudRate(failedAt);
+        ctx.profile.baudLimited = true;
+        ctx.profile.eraseMsPerSector = m_timeouts.eraseMsPerSector();
+        ctx.profile.lastSeen = QDateTime::currentDateTime();
+        m_profileCache.store(ctx.profile);
+    }
+}
+
+bool FlashingService::isLinkFailure(FlashingErrorType errorType) const
+{
+    // A wrong image, a pulled cable or a cancel says nothing about the rate
+    switch (errorType) {
+    case FlashingErrorType::FlashDataFailed:
+    case FlashingErrorType::BaudChangeTimeout:
+    case FlashingErrorType::Timeout:
+        return true;
+    case FlashingErrorType::Cancelled:
+    case FlashingErrorType::PortDisconnected:
+    case FlashingErrorType::InvalidFirmware:
+        return false;
+    default:
+        return m_lineErrorsAtRate >= LINE_ERROR_LIMIT;
+    }
+}
+
+void FlashingService::runFlashing(const FlashPlan& plan, const SerialPort& port)
+{
+    auto cleanup = [this]() {
+        releasePort();
         m_isFlashing = false;
     };
 
-    try {
-        // 1. Connect
-        emit stateChanged(FlashingState::connecting());
-        m_connection->open(port.path);
+    RunContext ctx = startRun(port);
+    QElapsedTimer runTimer;
+    runTimer.start();
 
-        // 2. Enter bootloader mode using DTR/RTS reset sequence
-        // For ESP32-C3 USB-JTAG-Serial, this triggers the built-in reset logic
-        // esptool uses only one reset strategy per device type - don't mix them
-        bool isUSBJTAGSerial = port.isESP32C3();
-        m_connection->enterBootloaderMode(isUSBJTAGSerial);
+    BaudRate effectiveBaudRate = plan.options().baudRate;
 
-        // Wait a moment for the chip to enter bootloader
-        // The USB-JTAG-Serial peripheral should stay connected
-        sleepMs(500);
+    auto fail = [&](const FlashingState& state) {
+        sampleLineErrors();
+        cleanup();
+        m_journal.save();
+        rememberFailure(ctx, effectiveBaudRate, state.errorType);
 
-        // Flush any remaining boot messages
-        m_connection->flush();
+        FlashingState result = m_isCancelled
+            ? FlashingState::error(FlashingErrorType::Cancelled)
+            : state;
+        emit stateChanged(result);
+
+        m_report.errorMessage = result.errorDescription();
+        m_report.durationMs = runTimer.elapsed();
+        emit reportReady(m_report);
+        emit finished(false);
+    };
+
+    try {
+        executePlan(plan, ctx);
+        rememberSuccess(ctx, effectiveBaudRate);
 
-        // Try syncing without closing the port first
-        // If that fails, we'll try the close/reopen approach
-        bool syncSucceeded = false;
+        m_journal.discard();
+        m_report.success = true;
+        m_report.durationMs = runTimer.elapsed();
 
-        try {
-            emit stateChanged(FlashingState::syncing());
-            syncWithRetry();
-            syncSucceeded = true;
-
-            // CRITICAL: Disable watchdogs IMMEDIATELY after first sync
-            // For USB-JTAG-Serial devices, the RTC watchdog can cause resets
-            // that interrupt flashing. We must disable it before doing anything else.
-            if (isUSBJTAGSerial) {
-                disableWatchdogs();
+        // The port is handed back before anyone hears the run is over
+        cleanup();
+        emit stateChanged(FlashingState::complete());
+        emit reportReady(m_report);
+        emit finished(true);
+
+    } catch (const FlashError& e) {
+        fail(e.state());
+    } catch (const std::exception& e) {
+        fail(FlashingState::error(FlashingErrorType::ConnectionFailed, QString::fromStdString(e.what())));
+    }
+}
+
+void FlashingService::executePlan(FlashPlan plan, RunContext& ctx)
+{
+    auto countWrites = [this, &ctx](const FlashPlan& current) {
+        ctx.bytesFlashed = 0;
+        ctx.totalBytes = current.writeBytes();
+        m_report.blocksTotal = 0;
+        for (const FlashOp& op : current.ops()) {
+            if (op.type == FlashOpType::WriteExtent) {
+                m_report.blocksTotal += (static_cast<int>(op.size) + ESP32Protocol::FLASH_BLOCK_SIZE - 1)
+                                        / ESP32Protocol::FLASH_BLOCK_SIZE;
             }
-        } catch (const std::exception&) {
-            // First sync attempt failed
         }
+    };
+    countWrites(plan);
 
-        // If sync failed, try closing and reopening the port
-        // This handles cases where USB-JTAG-Serial re-enumerates
-        if (!syncSucceeded) {
-            m_connection->close();
+    // Paced as the plan says, so a dry run's estimate matches the real run
+    ctx.blockDelayMs = plan.options().blockDelayMs;
 
-            // Wait for USB re-enumeration
-            sleepMs(2000);
+    for (size_t i = 0; i < plan.ops().size(); ++i) {
+        // Copy: the plan may be replaced below
+        FlashOp op = plan.ops()[i];
 
-            // Try to reopen the port multiple times
-            bool opened = false;
-            for (int attempt = 1; attempt <= 5; ++attempt) {
-                try {
-                    m_connection->open(port.path);
-                    opened = true;
-                    break;
-                } catch (const std::exception&) {
-                    if (attempt < 5) {
-                        sleepMs(500);
-                    }
-                }
-            }
+        if (m_isCancelled) {
+            throw FlashError(FlashingErrorType::Cancelled);
+        }
 
-            if (!opened) {
-                throw std::runtime_error("Could not reopen port after reset");
+        // Before rather than after each op: after a reboot the app talks
+        // at its own rate, which the driver counts as framing errors
+        sampleLineErrors();
+
+        QElapsedTimer timer;
+        timer.start();
+
+        int attempt = 0;
+        for (;;) {
+            ++attempt;
+            try {
+                runOp(op, ctx);
+                break;
+            } catch (const FlashError& e) {
+                bool retryable = e.type() != FlashingErrorType::Cancelled &&
+                                 e.type() != FlashingErrorType::PortDisconnected;
+                if (m_isCancelled || !retryable || attempt >= op.attempts) {
+                    throw;
+                }
             }
+        }
 
-            // Flush any garbage data
-            m_connection->flush();
+        m_report.opTimings.push_back({op.describe(), timer.elapsed(), attempt});
 
-            // Try sync again
-            emit stateChanged(FlashingState::syncing());
-            syncWithRetry();
+        if (op.type == FlashOpType::Sync) {
+            // The plan was made before the chip was known; the remaining
+            // ops change if the bootloader lives elsewhere on this chip
+            if (ctx.profile.chip != ESP32ChipFamily::Unknown &&
+                ctx.profile.chip != plan.options().chip) {
+                plan = plan.forChip(ctx.profile.chip);
+                countWrites(plan);
+            }
 
-            // CRITICAL: Disable watchdogs IMMEDIATELY after sync
-            if (isUSBJTAGSerial) {
-                disableWatchdogs();
+            // Pick up where an interrupted flash of the same firmware left off
+            if (plan.writeBytes() > 0) {
+                ctx.resumable = m_journal.open(ctx.port.serialNumber,
+                                               FlashJournal::firmwareHash(plan.target()));
             }
         }
+    }
+}
 
-        // 4. Change baud rate if needed
-        if (baudRate != BaudRate::Baud115200) {
+void FlashingService::runOp(const FlashOp& op, RunContext& ctx)
+{
+    try {
+        switch (op.type) {
+        case FlashOpType::Reset:
+            enterLoader(ctx);
+            break;
+
+        case FlashOpType::Sync:
+            prepareLoader(ctx);
+            break;
+
+        case FlashOpType::SetBaud:
             emit stateChanged(FlashingState::changingBaudRate());
-            changeBaudRate(baudRate);
+            ctx.baudChanged = true;
+            changeBaudRate(op.baudRate);
+            m_report.baudRate = baudRateValue(op.baudRate);
+            break;
+
+        case FlashOpType::Attach:
+            spiAttach();
+            break;
+
+        case FlashOpType::EraseRegion:
+            eraseRegion(op, ctx);
+            break;
+
+        case FlashOpType::WriteExtent:
+            flashImage(imageFor(op), ctx.firstBlock, ctx.bytesFlashed, ctx.totalBytes, ctx.blockDelayMs);
+            ctx.bytesFlashed += static_cast<int>(op.size);
+            break;
+
+        case FlashOpType::Verify:
+            verifyRegion(op);
+            break;
+
+        case FlashOpType::Reboot:
+            // Returns as soon as the reset is confirmed, no fixed restart wait
+            emit stateChanged(FlashingState::restarting());
+            flashEnd(true, ctx.port.isUSBJTAGSerial());
+            break;
+        }
+    } catch (const FlashError&) {
+        throw;
+    } catch (const SerialError& e) {
+        if (m_isCancelled) {
+            throw FlashError(FlashingErrorType::Cancelled);
+        }
+        QString message = QString::fromStdString(e.what());
+        if (e.type() == SerialError::ReadFailed || e.type() == SerialError::WriteFailed) {
+            throw FlashError(FlashingErrorType::PortDisconnected, message);
+        }
+        throw FlashError(FlashingErrorType::ConnectionFailed, message);
+    } catch (const std::exception& e) {
+        if (m_isCancelled) {
+            throw FlashError(FlashingErrorType::Cancelled);
         }
+        throw FlashError(errorTypeFor(op.type), QString::fromStdString(e.what()));
+    }
+}
+
+void FlashingService::runSession(const FlashPlan& connectPlan, const SerialPort& port)
+{
+    auto cleanup = [this]() {
+        releasePort();
+        m_sessionOpen = false;
+        m_isFlashing = false;
+    };
 
-        // 5. Attach SPI flash (required for ROM bootloader before flash operations)
-        spiAttach();
+    RunContext ctx = startRun(port);
+    ctx.planOptions = connectPlan.options();
+    QElapsedTimer runTimer;
+    runTimer.start();
 
-        // 6. Flash all images in the firmware package
-        int totalBytes = firmware.totalSize();
-        int bytesFlashed = 0;
+    // 1. Attach to the loader once for the whole session
+    try {
+        executePlan(connectPlan, ctx);
+    } catch (const std::exception& e) {
+        const auto* flashError = dynamic_cast<const FlashError*>(&e);
+        FlashingState state = m_isCancelled
+            ? FlashingState::error(FlashingErrorType::Cancelled)
+            : flashError ? flashError->state()
+                         : FlashingState::error(FlashingErrorType::ConnectionFailed,
+                                                QString::fromStdString(e.what()));
+        rememberFailure(ctx, ctx.planOptions.baudRate, state.errorType);
+        cleanup();
 
-        for (const auto& image : firmware.images()) {
-            if (m_isCancelled) {
-                throw std::runtime_error("Cancelled");
+        emit stateChanged(state);
+        emit sessionReady(false, state.errorDescription());
+        emit sessionEnded(false);
+        return;
+    }
+
+    ctx.planOptions.chip = ctx.profile.chip;
+    emit sessionReady(true, QString());
+
+    // 2. Run jobs as they are submitted, until the session is ended
+    bool healthy = true;
+    for (;;) {
+        SessionJob job;
+        {
+            QMutexLocker locker(&m_jobMutex);
+            while (m_jobs.empty() && !m_endRequested && !m_isCancelled) {
+                m_jobAvailable.wait(&m_jobMutex);
             }
+            if (m_isCancelled || m_jobs.empty()) {
+                break;
+            }
+            job = m_jobs.front();
+            m_jobs.pop_front();
+        }
 
-            int blockSize = ESP32Protocol::FLASH_BLOCK_SIZE;
-            int numBlocks = (image.size() + blockSize - 1) / blockSize;
-
-            // Begin flash for this image
-            emit stateChanged(FlashingState::erasing());
-            flashBegin(
-                static_cast<uint32_t>(image.size()),
-                static_cast<uint32_t>(numBlocks),
-                static_cast<uint32_t>(blockSize),
-                image.offset
-            );
-
-            // Send data blocks
-            for (int blockNum = 0; blockNum < numBlocks; ++blockNum) {
-                if (m_isCancelled) {
-                    throw std::runtime_error("Cancelled");
-                }
+        SessionResult result = runJob(job, ctx);
+        emit jobFinished(result);
+
+        if (!ctx.synced) {
+            // The loader is gone; nothing else can run on this session
+            healthy = false;
+            break;
+        }
+    }
+
+    // 3. Reboot into the new firmware once, at the very end
+    sampleLineErrors();
+    if (healthy && m_rebootOnEnd && !m_isCancelled) {
+        try {
+            FlashOp reboot;
+            reboot.type = FlashOpType::Reboot;
+            runOp(reboot, ctx);
+        } catch (const FlashError& e) {
+            healthy = false;
+            emit stateChanged(e.state());
+        }
+    }
+
+    if (healthy && !m_isCancelled) {
+        rememberSuccess(ctx, ctx.planOptions.baudRate);
+    }
+
+    m_report.success = healthy && !m_isCancelled;
+    m_report.durationMs = runTimer.elapsed();
+
+    cleanup();
+    if (m_report.success) {
+        emit stateChanged(FlashingState::complete());
+    } else if (m_isCancelled) {
+        emit stateChanged(FlashingState::error(FlashingErrorType::Cancelled));
+    }
+    emit reportReady(m_report);
+    emit sessionEnded(m_report.success);
+}
+
+SessionResult FlashingService::runJob(const SessionJob& job, RunContext& ctx)
+{
+    SessionResult result;
+    result.jobId = job.id;
+    result.type = job.type;
 
-                int start = blockNum * blockSize;
-                int end = qMin(start + blockSize, image.size());
-                QByteArray blockData = image.data.mid(start, end - start);
+    // Session jobs write into the already attached loader and never reboot
+    FlashPlan::Options options = ctx.planOptions;
+    options.connect = false;
+    options.reboot = false;
 
-                // Pad last block with 0xFF if needed
-                if (blockData.size() < blockSize) {
-                    blockData.append(QByteArray(blockSize - blockData.size(), static_cast<char>(0xFF)));
+    try {
+        switch (job.type) {
+        case SessionJob::Flash:
+        case SessionJob::WriteData: {
+            FirmwareFile firmware = job.type == SessionJob::Flash
+                ? job.firmware
+                : FirmwareFile(std::vector<FirmwareImage>{{"device data", job.data, job.address}});
+            FlashPlan plan = FlashPlan::build(firmware, options);
+            plan.optimize();
+            executePlan(plan, ctx);
+            break;
+        }
+
+        case SessionJob::Verify: {
+            options.verify = true;
+            FlashPlan plan = FlashPlan::build(job.firmware, options);
+            for (const FlashOp& op : plan.ops()) {
+                if (op.type == FlashOpType::Verify) {
+                    runOp(op, ctx);
                 }
+            }
+            break;
+        }
 
-                // Calculate overall progress across all images
-                double imageProgress = static_cast<double>(blockNum + 1) / numBlocks;
-                double overallProgress = (bytesFlashed + imageProgress * image.size()) / totalBytes;
-                emit stateChanged(FlashingState::flashing(overallProgress));
+        case SessionJob::ReadBack:
+            result.data = flashMd5(job.address, job.size);
+            break;
 
-                flashData(blockData, blockNum);
+        case SessionJob::ReadMac:
+            result.data = readMac();
+            break;
 
-                // Small delay after each block to prevent USB-JTAG-Serial buffer overflow
-                // The ROM bootloader (without stub) can overwhelm the USB peripheral
-                // This is a known issue with ESP32-C3 USB-JTAG-Serial
-                sleepMs(BLOCK_DELAY_MS);
+        case SessionJob::ReadEfuses:
+            result.data = readEfuses(job.address, job.size);
+            break;
+        }
+        result.success = true;
+
+    } catch (const std::exception& e) {
+        const auto* flashError = dynamic_cast<const FlashError*>(&e);
+        const auto* serialError = dynamic_cast<const SerialError*>(&e);
+
+        result.errorMessage = flashError
+            ? flashError->state().errorDescription()
+            : QString::fromStdString(e.what());
+
+        bool portLost = (flashError && flashError->type() == FlashingErrorType::PortDisconnected) ||
+                        (serialError && (serialError->type() == SerialError::ReadFailed ||
+                                         serialError->type() == SerialError::WriteFailed));
+        if (portLost) {
+            ctx.synced = false;
+        }
+    }
+
+    return result;
+}
+
+QByteArray FlashingService::readMac()
+{
+    // Factory MAC: low word holds bytes 2-5, high word bytes 0-1 (esptool's layout)
+    uint32_t word0 = readReg(m_chip->efuseMacWord0);
+    uint32_t word1 = readReg(m_chip->efuseMacWord0 + 4);
+
+    QByteArray mac;
+    mac.append(static_cast<char>((word1 >> 8) & 0xFF));
+    mac.append(static_cast<char>(word1 & 0xFF));
+    mac.append(static_cast<char>((word0 >> 24) & 0xFF));
+    mac.append(static_cast<char>((word0 >> 16) & 0xFF));
+    mac.append(static_cast<char>((word0 >> 8) & 0xFF));
+    mac.append(static_cast<char>(word0 & 0xFF));
+    return mac;
+}
+
+QByteArray FlashingService::readEfuses(uint32_t offset, uint32_t wordCount)
+{
+    QByteArray words;
+    for (uint32_t i = 0; i < wordCount; ++i) {
+        uint32_t value = readReg(m_chip->efuseBase + offset + i * 4);
+        for (int byte = 0; byte < 4; ++byte) {
+            words.append(static_cast<char>((value >> (byte * 8)) & 0xFF));
+        }
+    }
+    return words;
+}
+
+FlashingErrorType FlashingService::errorTypeFor(FlashOpType type)
+{
+    switch (type) {
+    case FlashOpType::SetBaud:
+        return FlashingErrorType::BaudChangeTimeout;
+    case FlashOpType::EraseRegion:
+        return FlashingErrorType::FlashBeginFailed;
+    case FlashOpType::WriteExtent:
+        return FlashingErrorType::FlashDataFailed;
+    case FlashOpType::Verify:
+        return FlashingErrorType::ChecksumMismatch;
+    case FlashOpType::Reboot:
+        return FlashingErrorType::FlashEndFailed;
+    default:
+        return FlashingErrorType::ConnectionFailed;
+    }
+}
+
+void FlashingService::enterLoader(RunContext& ctx)
+{
+    // 1. Connect
+    emit stateChanged(FlashingState::connecting());
+    m_connection->setFlowControl(ctx.settings.effectiveFlowControl());
+    if (m_connection->isConnected()) {
+        // Adopted from the monitor; drop its unread output
+        m_connection->flush();
+    } else {
+        m_connection->open(ctx.port.path);
+    }
+
+    // 2. Enter bootloader mode using DTR/RTS reset sequences
+    // Escalates across sequences and timings until the ROM answers SYNC,
+    // starting with whatever worked last time for this board.
+    // Boards known to need the reopen skip the in-place attempts.
+    emit stateChanged(FlashingState::syncing());
+
+    const bool cachedStrategyAllowed = ctx.cached &&
+        (!ctx.settings.resetStrategy || *ctx.settings.resetStrategy == ctx.cached->resetStrategy);
+    if (cachedStrategyAllowed && ctx.cached->needsReopen) {
+        m_connection->enterBootloaderMode(
+            ResetSequence::forStrategy(ctx.cached->resetStrategy).scaled(ctx.cached->resetTimingScale));
+        ctx.profile.resetStrategy = ctx.cached->resetStrategy;
+        ctx.profile.resetTimingScale = ctx.cached->resetTimingScale;
+    } else {
+        ctx.synced = resetIntoBootloader(resetAttempts(ctx.port, ctx.settings, ctx.cached), ctx.profile);
+    }
+
+    if (ctx.synced) {
+        return;
+    }
+
+    // If sync failed, try closing and reopening the port
+    // This handles cases where USB-JTAG-Serial re-enumerates
+    m_connection->close();
+
+    // Wait for USB re-enumeration
+    sleepMs(2000);
+
+    // Try to reopen the port multiple times
+    bool opened = false;
+    for (int attempt = 1; attempt <= 5; ++attempt) {
+        try {
+            m_connection->open(ctx.port.path);
+            opened = true;
+            break;
+        } catch (const std::exception&) {
+            if (attempt < 5) {
+                sleepMs(500);
             }
+        }
+    }
+
+    if (!opened) {
+        throw FlashError(FlashingErrorType::ConnectionFailed, "Could not reopen port after reset");
+    }
 
-            bytesFlashed += image.size();
+    // Flush any garbage data
+    m_connection->flush();
+    ctx.profile.needsReopen = true;
+}
+
+void FlashingService::prepareLoader(RunContext& ctx)
+{
+    if (!ctx.synced) {
+        emit stateChanged(FlashingState::syncing());
+        try {
+            ctx.profile.syncAttempts = syncWithRetry(SYNC_RETRIES);
+        } catch (const SerialError&) {
+            throw;
+        } catch (const std::exception&) {
+            if (m_isCancelled) {
+                throw;
+            }
+            throw FlashError(FlashingErrorType::SyncFailed, m_bootFailureReason, SYNC_RETRIES);
         }
+        ctx.synced = true;
+    }
+
+    // Identify the chip so the right register map is used
+    ctx.profile.chip = detectChip();
+    m_report.chipName = ESP32Chips::familyName(ctx.profile.chip);
 
-        // 7. Verify (implicit - checksums validated per block)
+    // CRITICAL: Disable watchdogs IMMEDIATELY after sync
+    // For USB-JTAG-Serial devices, the RTC watchdog can cause resets
+    // that interrupt flashing. We must disable it before doing anything else.
+    if (ctx.port.isUSBJTAGSerial()) {
+        disableWatchdogs();
+    }
+}
+
+void FlashingService::eraseRegion(const FlashOp& op, RunContext& ctx)
+{
+    FirmwareImage image = imageFor(op);
+    int numBlocks = (image.size() + ESP32Protocol::FLASH_BLOCK_SIZE - 1) / ESP32Protocol::FLASH_BLOCK_SIZE;
+
+    ctx.firstBlock = 0;
+    if (ctx.resumable) {
         emit stateChanged(FlashingState::verifying());
-        sleepMs(100);
+        ctx.firstBlock = verifiedBlocks(image);
+    }
 
-        // 8. Complete flashing and reboot
-        emit stateChanged(FlashingState::restarting());
-        flashEnd(true, isUSBJTAGSerial);
+    if (ctx.firstBlock >= numBlocks) {
+        return;
+    }
 
-        sleepMs(1000); // 1 second for device to restart
+    // Begin flash for this extent (only the part still to be written)
+    emit stateChanged(FlashingState::erasing());
+    beginImageAt(image, ctx.firstBlock);
+}
 
-        emit stateChanged(FlashingState::complete());
-        cleanup();
-        emit finished(true);
+void FlashingService::verifyRegion(const FlashOp& op)
+{
+    emit stateChanged(FlashingState::verifying());
 
-    } catch (const std::exception& e) {
-        cleanup();
+    QByteArray expected = QCryptographicHash::hash(op.data, QCryptographicHash::Md5);
+    if (flashMd5(op.address, op.size) != expected) {
+        throw FlashError(FlashingErrorType::ChecksumMismatch,
+                         QString("MD5 mismatch at 0x%1").arg(op.address, 8, 16, QChar('0')));
+    }
+}
 
-        QString errorMsg = QString::fromStdString(e.what());
+FirmwareImage FlashingService::imageFor(const FlashOp& op)
+{
+    FirmwareImage image;
+    image.filePath = op.label;
+    image.data = op.data;
+    image.offset = op.address;
+    return image;
+}
 
-        if (m_isCancelled || errorMsg.contains("Cancelled")) {
-            emit stateChanged(FlashingState::error(FlashingErrorType::Cancelled));
-        } else if (errorMsg.contains("sync")) {
-            emit stateChanged(FlashingState::error(FlashingErrorType::SyncFailed, errorMsg, SYNC_RETRIES));
-        } else if (errorMsg.contains("Cannot open") || errorMsg.contains("reopen")) {
-            emit stateChanged(FlashingState::error(FlashingErrorType::ConnectionFailed, errorMsg));
-        } else {
-            emit stateChanged(FlashingState::error(FlashingErrorType::ConnectionFailed, errorMsg));
+std::vector<FlashingService::ResetAttempt> FlashingService::resetAttempts(
+    const SerialPort& port, const PortSettings& settings, const std::optional<DeviceProfile>& cached) const
+{
+    std::vector<ResetAttempt> attempts;
+    auto add = [&attempts](ResetStrategy strategy, double timingScale) {
+        for (const ResetAttempt& existing : attempts) {
+            if (existing.strategy == strategy && qFuzzyCompare(existing.timingScale, timingScale)) {
+                return;
+            }
         }
+        attempts.push_back({strategy, timingScale});
+    };
 
-        emit finished(false);
+    // The fixture's wiring is known; only the timing is left to find
+    if (settings.resetStrategy) {
+        if (cached && cached->resetStrategy == *settings.resetStrategy) {
+            add(cached->resetStrategy, cached->resetTimingScale);
+        }
+        add(*settings.resetStrategy, 1.0);
+        add(*settings.resetStrategy, SLOW_RESET_TIMING_SCALE);
+        return attempts;
+    }
+
+    // What worked last time goes first
+    if (cached) {
+        add(cached->resetStrategy, cached->resetTimingScale);
+    }
+
+    // esptool uses only the USB-JTAG-Serial sequence for native USB devices,
+    // and alternates classic and unix-tight sequences for USB-UART bridges
+    ResetStrategy preferred = defaultResetStrategy(port);
+    add(preferred, 1.0);
+    if (preferred == ResetStrategy::Classic) {
+        add(ResetStrategy::UnixTight, 1.0);
+    }
+    add(preferred, SLOW_RESET_TIMING_SCALE);
+
+    return attempts;
+}
+
+bool FlashingService::resetIntoBootloader(const std::vector<ResetAttempt>& attempts,
+                                          DeviceProfile& profile)
+{
+    using Clock = std::chrono::steady_clock;
+
+    for (const ResetAttempt& attempt : attempts) {
+        if (m_isCancelled) {
+            throw std::runtime_error("Cancelled");
+        }
+
+        try {
+            ResetSequence sequence =
+                ResetSequence::forStrategy(attempt.strategy).scaled(attempt.timingScale);
+            m_connection->enterBootloaderMode(sequence);
+            int64_t resetEndNs = steadyNowNs();
+
+            // Listen for the ROM boot banner: "waiting for download" means
+            // the loader is ready now, a flash boot means this sequence
+            // failed and there is no point spending the sync window on it
+            BootBannerMatcher::Result banner = listenForBootBanner();
+            if (banner == BootBannerMatcher::NormalBoot) {
+                continue;
+            }
+
+            // Probe with short SYNCs instead of sleeping a fixed time:
+            // the first answer tells us exactly when the loader is ready.
+            // Without a banner (ROM log disabled, USB CDC still coming up)
+            // this is also how readiness is detected.
+            Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(READY_WINDOW_MS);
+            int syncAttempts = 0;
+
+            while (Clock::now() < deadline) {
+                ++syncAttempts;
+                int64_t respondedNs = 0;
+                try {
+                    respondedNs = performSync(PROBE_SYNC_TIMEOUT);
+                } catch (const SerialError&) {
+                    throw;
+                } catch (const std::exception&) {
+                    if (m_isCancelled) {
+                        throw;
+                    }
+                    continue;
+                }
+
+                profile.resetStrategy = attempt.strategy;
+                profile.resetTimingScale = attempt.timingScale;
+                profile.readyMs = static_cast<int>((respondedNs - resetEndNs) / 1000000);
+                profile.syncAttempts = syncAttempts;
+                return true;
+            }
+        } catch (const SerialError&) {
+            // Port went away (USB re-enumeration) - further sequences on
+            // this file descriptor cannot work, leave it to the reopen path
+            profile.resetStrategy = attempt.strategy;
+            profile.resetTimingScale = attempt.timingScale;
+            return false;
+        }
+    }
+
+    // Remember the strategy the reopen path will be working from
+    if (!attempts.empty()) {
+        profile.resetStrategy = attempts.back().strategy;
+        profile.resetTimingScale = attempts.back().timingScale;
+    }
+    return false;
+}
+
+BootBannerMatcher::Result FlashingService::listenForBootBanner()
+{
+    using Clock = std::chrono::steady_clock;
+
+    BootBannerMatcher matcher;
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(BANNER_WINDOW_MS);
+
+    while (Clock::now() < deadline) {
+        if (m_isCancelled) {
+            throw std::runtime_error("Cancelled");
+        }
+
+        QByteArray data = m_connection->read(BANNER_READ_TIMEOUT);
+        BootBannerMatcher::Result result = matcher.feed(data);
+
+        if (result == BootBannerMatcher::NormalBoot) {
+            m_bootFailureReason = QString("chip booted from flash instead of download mode (%1)")
+                                      .arg(matcher.matchedLine());
+            return result;
+        }
+        if (result == BootBannerMatcher::DownloadMode) {
+            m_bootFailureReason.clear();
+            return result;
+        }
     }
+
+    return BootBannerMatcher::None;
 }
 
-void FlashingService::syncWithRetry()
+int FlashingService::syncWithRetry(int maxAttempts)
 {
-    for (int attempt = 1; attempt <= SYNC_RETRIES; ++attempt) {
+    for (int attempt = 1; attempt <= maxAttempts; ++attempt) {
         try {
             performSync();
-            return; // Success
+            return attempt; // Success
         } catch (const std::exception&) {
-            if (attempt == SYNC_RETRIES) {
+            if (attempt == maxAttempts) {
                 throw std::runtime_error("Failed to sync with bootloader");
             }
             sleepMs(SYNC_RETRY_DELAY_MS);
         }
     }
+    return maxAttempts;
 }
 
-void FlashingService::performSync()
+int64_t FlashingService::performSync(double timeout)
 {
     QByteArray syncCommand = ESP32Protocol::buildSyncCommand();
     QByteArray slipEncoded = SLIPCodec::encode(syncCommand);
 
     // Send ONE sync packet (not 7 like before!)
     // esptool sends 1 sync, then reads 7 additional responses to drain
+    QElapsedTimer timer;
+    timer.start();
     m_connection->write(slipEncoded);
 
     // Wait for first response
-    ESP32Response response = waitForResponse(ESP32Command::Sync, 1.0);
+    ESP32Response response = waitForResponse(ESP32Command::Sync, timeout);
+    int64_t respondedNs = steadyNowNs();
 
     if (!response.isSuccess()) {
         throw std::runtime_error("Sync failed");
     }
 
-    // Read 7 more responses to drain extra sync responses (like esptool does)
-    // The ROM bootloader sends multiple responses to sync
-    for (int i = 0; i < 7; ++i) {
+    // First round trip of the session - calibrates every later timeout
+    m_timeouts.addSample(timer.nsecsElapsed() / 1e9, slipEncoded.size());
+
+    // The ROM bootloader sends multiple responses to sync; they follow
+    // the first straight away, so drain until the line goes quiet rather
+    // than waiting out one timeout per response
+    QElapsedTimer drain;
+    drain.start();
+    while (drain.elapsed() < SYNC_DRAIN_MAX_MS) {
         try {
-            waitForResponse(ESP32Command::Sync, 0.1);
-        } catch (...) {
-            // Ignore drain timeouts
+            if (m_connection->read(SYNC_DRAIN_GAP).isEmpty()) {
+                break;
+            }
+        } catch (const SerialError& e) {
+            if (e.type() != SerialError::Timeout) {
+                throw;
+            }
+            break;
         }
     }
 
     // Flush any remaining data
     m_connection->flush();
+    return respondedNs;
 }
 
 void FlashingService::changeBaudRate(BaudRate rate)
@@ -285,24 +1011,64 @@ void FlashingService::changeBaudRate(BaudRate rate)
         115200
     );
     QByteArray encoded = SLIPCodec::encode(command);
+    sampleLineErrors();
     m_connection->write(encoded);
 
     // Brief delay then change host baud rate
     sleepMs(50);
     m_connection->setBaudRate(rate);
+    m_timeouts.setBaudRate(baudRateValue(rate));
     sleepMs(50);
 
     // Sync again at new baud rate
     performSync();
+
+    // Bytes caught mid-switch are garbled by design, not by the link
+    m_linkBaudRate = rate;
+    m_lineErrorBase = m_connection->errorCounters();
+    m_lineErrorsAtRate = 0;
+    m_retriesBeforeRate = m_report.totalRetries();
+}
+
+void FlashingService::sampleLineErrors()
+{
+    std::optional<SerialErrorCounters> counters =
+        m_connection ? m_connection->errorCounters() : std::nullopt;
+    if (!counters) {
+        return;
+    }
+
+    if (m_lineErrorBase) {
+        const SerialErrorCounters delta = counters->since(*m_lineErrorBase);
+        m_report.frameErrors += delta.frame;
+        m_report.overruns += delta.overrun;
+        m_report.parityErrors += delta.parity;
+        m_report.bufferOverruns += delta.bufferOverrun;
+        m_lineErrorsAtRate += delta.lineErrors();
+    }
+    m_report.lineErrorsCounted = true;
+    m_lineErrorBase = counters;
+}
+
+bool FlashingService::canStepDown() const
+{
+    return m_linkBaudRate != lowerBaudRate(m_linkBaudRate) &&
+           static_cast<int>(m_report.baudDowngrades.size()) < MAX_BAUD_STEPS;
+}
+
+void FlashingService::stepDownBaudRate()
+{
+    const BaudRate rate = lowerBaudRate(m_linkBaudRate);
+    emit stateChanged(FlashingState::changingBaudRate());
+    changeBaudRate(rate);
+    m_report.baudRate = baudRateValue(rate);
+    m_report.baudDowngrades.push_back(baudRateValue(rate));
 }
 
 void FlashingService::spiAttach()
 {
     QByteArray command = ESP32Protocol::buildSpiAttachCommand();
-    QByteArray encoded = SLIPCodec::encode(command);
-    m_connection->write(encoded);
-
-    ESP32Response response = waitForResponse(ESP32Command::SpiAttach, 3.0);
+    ESP32Response response = sendCommand(ESP32Command::SpiAttach, command);
     if (!response.isSuccess()) {
         throw std::runtime_error(QString("SPI attach failed: status=%1, error=%2")
                                      .arg(response.status)
@@ -311,40 +1077,73 @@ void FlashingService::spiAttach()
     }
 }
 
+ESP32ChipFamily FlashingService::detectChip()
+{
+    // Every ROM answers READ_REG, and the magic register is unique per family
+    const ESP32ChipDescriptor* chip = nullptr;
+    try {
+        chip = ESP32Chips::fromMagicValue(readReg(ESP32Chips::CHIP_DETECT_MAGIC_REG));
+    } catch (const std::exception&) {
+    }
+
+    // Newer ROMs also report a chip ID through GET_SECURITY_INFO
+    if (!chip) {
+        try {
+            QByteArray command = ESP32Protocol::buildGetSecurityInfoCommand();
+            ESP32Response response = sendCommand(ESP32Command::GetSecurityInfo, command);
+            if (auto chipId = ESP32Protocol::parseSecurityInfoChipId(response)) {
+                chip = ESP32Chips::fromChipId(*chipId);
+            }
+        } catch (const std::exception&) {
+        }
+    }
+
+    if (!chip) {
+        // Fall back to the register map this tool has always used
+        m_chip = &ESP32Chips::descriptor(ESP32ChipFamily::ESP32C3);
+        return ESP32ChipFamily::Unknown;
+    }
+
+    m_chip = chip;
+    emit chipDetected(QString::fromLatin1(chip->name));
+    return chip->family;
+}
+
 void FlashingService::disableWatchdogs()
 {
     // 1. Disable RTC Watchdog
-    // First unlock the write protection
-    writeReg(ESP32C3Registers::RTC_WDT_WPROTECT, ESP32C3Registers::RTC_WDT_WKEY);
+    if (m_chip->hasRtcWatchdog()) {
+        // First unlock the write protection
+        writeReg(m_chip->rtcWdtWprotect, m_chip->rtcWdtWkey);
 
-    // Read current config and clear WDT_EN bit
-    uint32_t wdtConfig = readReg(ESP32C3Registers::RTC_WDT_CONFIG0);
-    uint32_t newWdtConfig = wdtConfig & ~ESP32C3Registers::WDT_EN_BIT;
-    writeReg(ESP32C3Registers::RTC_WDT_CONFIG0, newWdtConfig);
+        // Read current config and clear WDT_EN bit
+        uint32_t wdtConfig = readReg(m_chip->rtcWdtConfig0);
+        uint32_t newWdtConfig = wdtConfig & ~ESP32C3Registers::WDT_EN_BIT;
+        writeReg(m_chip->rtcWdtConfig0, newWdtConfig);
 
-    // Re-lock write protection
-    writeReg(ESP32C3Registers::RTC_WDT_WPROTECT, 0);
+        // Re-lock write protection
+        writeReg(m_chip->rtcWdtWprotect, 0);
+    }
 
     // 2. Enable Super Watchdog auto-feed (effectively disables it)
-    // First unlock the write protection
-    writeReg(ESP32C3Registers::SWD_WPROTECT, ESP32C3Registers::SWD_WKEY);
+    if (m_chip->hasSuperWatchdog()) {
+        // First unlock the write protection
+        writeReg(m_chip->swdWprotect, m_chip->swdWkey);
 
-    // Read current config and set SWD_AUTO_FEED_EN bit
-    uint32_t swdConfig = readReg(ESP32C3Registers::SWD_CONF);
-    uint32_t newSwdConfig = swdConfig | ESP32C3Registers::SWD_AUTO_FEED_EN_BIT;
-    writeReg(ESP32C3Registers::SWD_CONF, newSwdConfig);
+        // Read current config and set SWD_AUTO_FEED_EN bit
+        uint32_t swdConfig = readReg(m_chip->swdConf);
+        uint32_t newSwdConfig = swdConfig | m_chip->swdAutoFeedBit;
+        writeReg(m_chip->swdConf, newSwdConfig);
 
-    // Re-lock write protection
-    writeReg(ESP32C3Registers::SWD_WPROTECT, 0);
+        // Re-lock write protection
+        writeReg(m_chip->swdWprotect, 0);
+    }
 }
 
 uint32_t FlashingService::readReg(uint32_t address)
 {
     QByteArray command = ESP32Protocol::buildReadRegCommand(address);
-    QByteArray encoded = SLIPCodec::encode(command);
-    m_connection->write(encoded);
-
-    ESP32Response response = waitForResponse(ESP32Command::ReadReg, 1.0);
+    ESP32Response response = sendCommand(ESP32Command::ReadReg, command);
     if (!response.isSuccess()) {
         throw std::runtime_error(QString("READ_REG failed at 0x%1")
                                      .arg(address, 8, 16, QChar('0'))
@@ -356,10 +1155,7 @@ uint32_t FlashingService::readReg(uint32_t address)
 void FlashingService::writeReg(uint32_t address, uint32_t value)
 {
     QByteArray command = ESP32Protocol::buildWriteRegCommand(address, value);
-    QByteArray encoded = SLIPCodec::encode(command);
-    m_connection->write(encoded);
-
-    ESP32Response response = waitForResponse(ESP32Command::WriteReg, 1.0);
+    ESP32Response response = sendCommand(ESP32Command::WriteReg, command);
     if (!response.isSuccess()) {
         throw std::runtime_error(QString("WRITE_REG failed at 0x%1")
                                      .arg(address, 8, 16, QChar('0'))
@@ -371,40 +1167,240 @@ void FlashingService::flashBegin(uint32_t size, uint32_t numBlocks, uint32_t blo
 {
     QByteArray command = ESP32Protocol::buildFlashBeginCommand(size, numBlocks, blockSize, offset);
     QByteArray encoded = SLIPCodec::encode(command);
+
+    // The ROM erases the whole region before answering
+    QElapsedTimer timer;
+    timer.start();
     m_connection->write(encoded);
 
-    ESP32Response response = waitForResponse(ESP32Command::FlashBegin, 30.0); // Erase can take time
+    ESP32Response response = waitForResponse(ESP32Command::FlashBegin,
+                                             m_timeouts.eraseTimeout(size, encoded.size()));
+    m_timeouts.addEraseSample(timer.nsecsElapsed() / 1e9, size, encoded.size());
     if (!response.isSuccess()) {
-        throw std::runtime_error(QString("Flash begin failed: status=%1")
-                                     .arg(response.status)
-                                     .toStdString());
+        throw FlashError(FlashingErrorType::FlashBeginFailed,
+                         QString("Flash begin failed: status=%1").arg(response.status),
+                         response.error);
     }
 }
 
-void FlashingService::flashData(const QByteArray& block, int sequenceNumber)
+ESP32Response FlashingService::flashData(const QByteArray& block, int sequenceNumber)
 {
     QByteArray command = ESP32Protocol::buildFlashDataCommand(block, static_cast<uint32_t>(sequenceNumber));
+    m_report.blocksSent++;
+    return sendCommand(ESP32Command::FlashData, command);
+}
+
+void FlashingService::flashImage(const FirmwareImage& image, int firstBlock, int bytesFlashed, int totalBytes,
+                                 int blockDelayMs)
+{
+    int blockSize = ESP32Protocol::FLASH_BLOCK_SIZE;
+    int numBlocks = (image.size() + blockSize - 1) / blockSize;
+
+    if (firstBlock >= numBlocks) {
+        return;
+    }
+
+    // Sequence numbers restart at 0 whenever the session is resumed
+    int sessionStart = firstBlock;
+    int blockNum = firstBlock;
+    int blockAttempts = 0;
+
+    while (blockNum < numBlocks) {
+        if (m_isCancelled) {
+            throw std::runtime_error("Cancelled");
+        }
+
+        int start = blockNum * blockSize;
+        int end = qMin(start + blockSize, image.size());
+        QByteArray blockData = image.data.mid(start, end - start);
+
+        // Pad last block with 0xFF if needed
+        if (blockData.size() < blockSize) {
+            blockData.append(QByteArray(blockSize - blockData.size(), static_cast<char>(0xFF)));
+        }
+
+        // Calculate overall progress across all images
+        double imageProgress = static_cast<double>(blockNum + 1) / numBlocks;
+        double overallProgress = (bytesFlashed + imageProgress * image.size()) / totalBytes;
+        emit stateChanged(FlashingState::flashing(overallProgress));
+
+        QString failure;
+        bool resync = false;
+
+        try {
+            ESP32Response response = flashData(blockData, blockNum - sessionStart);
+            if (response.isSuccess()) {
+                ++blockNum;
+                blockAttempts = 0;
+                m_journal.setAcked(image.offset, static_cast<uint32_t>(qMin(blockNum * blockSize, image.size())));
+
+                // Small delay after each block to prevent USB-JTAG-Serial buffer overflow
+                // The ROM bootloader (without stub) can overwhelm the USB peripheral
+                // This is a known issue with ESP32-C3 USB-JTAG-Serial
+                // Fixtures with RTS/CTS are paced by the handshake instead
+                if (blockDelayMs > 0) {
+                    sleepMs(blockDelayMs);
+                }
+                continue;
+            }
+
+            failure = QString("Flash data failed at block %1: status=%2, error=%3")
+                          .arg(blockNum)
+                          .arg(response.status)
+                          .arg(response.error);
+
+            // The ROM rejected the block and is still in step - resend it,
+            // unless resending already failed once
+            resync = blockAttempts > 0;
+        } catch (const SerialError&) {
+            // Port is gone - nothing to retry on
+            throw;
+        } catch (const std::exception& e) {
+            if (m_isCancelled) {
+                throw;
+            }
+
+            // No answer: we can't know whether the block was written
+            failure = QString("Flash data failed at block %1: %2").arg(blockNum).arg(e.what());
+            resync = true;
+        }
+
+        ++blockAttempts;
+        uint32_t address = image.offset + static_cast<uint32_t>(start);
+        m_report.blockRetries[address]++;
+
+        // The driver only sees errors on the way in; blocks the ROM
+        // rejected are the other direction's, so both count against a rate
+        sampleLineErrors();
+        bool exhausted = blockAttempts > BLOCK_RETRY_LIMIT ||
+                         m_report.totalRetries() - m_retriesBeforeRate > FLASH_RETRY_BUDGET;
+        bool stepDown = canStepDown() && (exhausted || m_lineErrorsAtRate >= LINE_ERROR_LIMIT);
+
+        if (exhausted && !stepDown) {
+            throw FlashError(FlashingErrorType::FlashDataFailed, failure, blockNum);
+        }
+
+        if (resync || stepDown) {
+            sessionStart = resumeImage(image, blockNum, stepDown);
+            blockNum = sessionStart;
+            m_report.resyncs++;
+            if (stepDown) {
+                blockAttempts = 0;
+            }
+        } else {
+            m_report.retransmissions++;
+        }
+    }
+}
+
+void FlashingService::beginImageAt(const FirmwareImage& image, int firstBlock)
+{
+    int blockSize = ESP32Protocol::FLASH_BLOCK_SIZE;
+    int start = firstBlock * blockSize;
+    int size = image.size() - start;
+    int numBlocks = (size + blockSize - 1) / blockSize;
+
+    flashBegin(
+        static_cast<uint32_t>(size),
+        static_cast<uint32_t>(numBlocks),
+        static_cast<uint32_t>(blockSize),
+        image.offset + static_cast<uint32_t>(start)
+    );
+}
+
+int FlashingService::resumeImage(const FirmwareImage& image, int failedBlock, bool stepDown)
+{
+    // Drop whatever is left of the failed exchange and get back in step
+    m_connection->flush();
+    syncWithRetry(RESYNC_ATTEMPTS);
+
+    // The ROM only takes the new rate from a link that is in step
+    if (stepDown) {
+        stepDownBaudRate();
+    }
+
+    // FLASH_BEGIN erases whole sectors, so restart at the sector holding
+    // the failed block and rewrite the blocks before it in that sector
+    int blocksPerSector = ESP32Protocol::FLASH_SECTOR_SIZE / ESP32Protocol::FLASH_BLOCK_SIZE;
+    int firstBlock = (failedBlock / blocksPerSector) * blocksPerSector;
+
+    // Blocks before the failed one in that sector are erased again
+    m_journal.setAcked(image.offset, static_cast<uint32_t>(firstBlock * ESP32Protocol::FLASH_BLOCK_SIZE));
+
+    beginImageAt(image, firstBlock);
+    return firstBlock;
+}
+
+int FlashingService::verifiedBlocks(const FirmwareImage& image)
+{
+    uint32_t acked = m_journal.ackedBytes(image.offset);
+    uint32_t imageSize = static_cast<uint32_t>(image.size());
+
+    // Only whole sectors survive a resumed FLASH_BEGIN; a finished image
+    // is checked in full
+    uint32_t length = acked >= imageSize
+        ? imageSize
+        : (acked / ESP32Protocol::FLASH_SECTOR_SIZE) * ESP32Protocol::FLASH_SECTOR_SIZE;
+    if (length == 0) {
+        return 0;
+    }
+
+    QByteArray expected = QCryptographicHash::hash(image.data.left(static_cast<int>(length)),
+                                                   QCryptographicHash::Md5);
+    QByteArray actual;
+    try {
+        actual = flashMd5(image.offset, length);
+    } catch (const SerialError&) {
+        throw;
+    } catch (const std::exception&) {
+        if (m_isCancelled) {
+            throw;
+        }
+    }
+
+    if (actual != expected) {
+        // Flash no longer holds what the journal says - rewrite the image
+        m_journal.setAcked(image.offset, 0);
+        return 0;
+    }
+
+    m_report.resumedBytes += length;
+    int blockSize = ESP32Protocol::FLASH_BLOCK_SIZE;
+    return length == imageSize
+        ? (image.size() + blockSize - 1) / blockSize
+        : static_cast<int>(length) / blockSize;
+}
+
+QByteArray FlashingService::flashMd5(uint32_t address, uint32_t size)
+{
+    QByteArray command = ESP32Protocol::buildSpiFlashMd5Command(address, size);
     QByteArray encoded = SLIPCodec::encode(command);
     m_connection->write(encoded);
 
-    ESP32Response response = waitForResponse(ESP32Command::FlashData, RESPONSE_TIMEOUT);
-    if (!response.isSuccess()) {
-        throw std::runtime_error(QString("Flash data failed at block %1: status=%2")
-                                     .arg(sequenceNumber)
-                                     .arg(response.status)
+    ESP32Response response = waitForResponse(ESP32Command::SpiFlashMd5,
+                                             m_timeouts.md5Timeout(size, encoded.size()));
+    auto digest = ESP32Protocol::parseFlashMd5(response);
+    if (!digest) {
+        throw std::runtime_error(QString("SPI_FLASH_MD5 failed at 0x%1")
+                                     .arg(address, 8, 16, QChar('0'))
                                      .toStdString());
     }
+    return *digest;
 }
 
 void FlashingService::flashEnd(bool reboot, bool isUSBJTAGSerial)
 {
-    QByteArray command = ESP32Protocol::buildFlashEndCommand(reboot);
-    QByteArray encoded = SLIPCodec::encode(command);
-    m_connection->write(encoded);
+    // For USB-JTAG-Serial devices, the FLASH_END reboot flag often doesn't work
+    // because the ROM bootloader's soft reset doesn't reset the USB peripheral.
+    // Stay in the loader and reset the whole chip through the RTC watchdog instead.
+    bool registerReset = reboot && isUSBJTAGSerial && m_chip->hasRtcWatchdog();
+
+    QByteArray command = ESP32Protocol::buildFlashEndCommand(reboot && !registerReset);
+    int64_t resetNs = steadyNowNs();
 
     // Flash end might not get a response if rebooting
     try {
-        ESP32Response response = waitForResponse(ESP32Command::FlashEnd, 2.0);
+        ESP32Response response = sendCommand(ESP32Command::FlashEnd, command);
         if (!response.isSuccess() && !reboot) {
             throw std::runtime_error("Flash end failed");
         }
@@ -415,26 +1411,117 @@ void FlashingService::flashEnd(bool reboot, bool isUSBJTAGSerial)
         }
     }
 
-    // For USB-JTAG-Serial devices, the FLASH_END reboot flag often doesn't work
-    // because the ROM bootloader's soft reset doesn't reset the USB peripheral.
-    // We need to do a hard reset using DTR/RTS.
-    if (reboot && isUSBJTAGSerial) {
+    if (!reboot) {
+        return;
+    }
+
+    if (registerReset) {
+        resetNs = steadyNowNs();
+        try {
+            watchdogReset();
+        } catch (const std::exception&) {
+            // The reset may already be under way - confirmation decides
+        }
+    }
+
+    if (waitForResetConfirmation()) {
+        emit deviceRebooted(m_port, resetNs);
+        return;
+    }
+
+    // Fall back to a hard reset using DTR/RTS
+    if (isUSBJTAGSerial && m_connection->isConnected() &&
+        m_connection->flowControl() == FlowControl::None) {
+        resetNs = steadyNowNs();
         m_connection->hardReset();
     }
+    emit deviceRebooted(m_port, resetNs);
+}
+
+void FlashingService::watchdogReset()
+{
+    // Arm the RTC watchdog with a short timeout and a system reset action.
+    // Unlike the ROM's soft reset this also resets the USB-JTAG-Serial
+    // peripheral, so the device re-enumerates and boots the new firmware.
+    writeReg(m_chip->rtcWdtWprotect, m_chip->rtcWdtWkey);
+    writeReg(m_chip->rtcWdtConfig1, ESP32C3Registers::WDT_SYSTEM_RESET_TIMEOUT);
+    writeReg(m_chip->rtcWdtConfig0, ESP32C3Registers::WDT_SYSTEM_RESET_CONFIG);
+
+    // The chip may reset before this response arrives
+    try {
+        writeReg(m_chip->rtcWdtWprotect, 0);
+    } catch (const std::exception&) {
+    }
+}
+
+bool FlashingService::waitForResetConfirmation()
+{
+    using Clock = std::chrono::steady_clock;
+
+    // The ROM prints its banner at 115200 after any reset
+    try {
+        m_connection->setBaudRate(BaudRate::Baud115200);
+    } catch (const SerialError&) {
+        return !QFile::exists(m_port.path);
+    }
+
+    BootBannerMatcher matcher;
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(RESET_CONFIRM_WINDOW_MS);
+
+    while (Clock::now() < deadline) {
+        try {
+            matcher.feed(m_connection->read(BANNER_READ_TIMEOUT));
+        } catch (const SerialError&) {
+            // Port vanished - the USB device is re-enumerating after the reset
+            return true;
+        }
+
+        if (matcher.sawRomBanner()) {
+            return true;
+        }
+        if (!QFile::exists(m_port.path)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+ESP32Response FlashingService::sendCommand(ESP32Command command, const QByteArray& packet)
+{
+    QByteArray encoded = SLIPCodec::encode(packet);
+
+    QElapsedTimer timer;
+    timer.start();
+    m_connection->write(encoded);
+
+    try {
+        ESP32Response response = waitForResponse(command, m_timeouts.responseTimeout(encoded.size()));
+        m_timeouts.addSample(timer.nsecsElapsed() / 1e9, encoded.size());
+        return response;
+    } catch (const std::exception&) {
+        if (!m_isCancelled) {
+            m_timeouts.backoff();
+        }
+        throw;
+    }
 }
 
 ESP32Response FlashingService::waitForResponse(ESP32Command command, double timeout)
 {
-    QDateTime deadline = QDateTime::currentDateTime().addMSecs(static_cast<qint64>(timeout * 1000));
+    // Monotonic, and read slices never run past the deadline, so the
+    // adaptive timeouts are the ones actually applied
+    const int64_t deadlineNs = steadyNowNs() + static_cast<int64_t>(timeout * 1e9);
     m_slipDecoder.reset();
 
-    while (QDateTime::currentDateTime() < deadline) {
+    for (int64_t remainingNs = deadlineNs - steadyNowNs(); remainingNs > 0;
+         remainingNs = deadlineNs - steadyNowNs()) {
         if (m_isCancelled) {
             throw std::runtime_error("Cancelled");
         }
 
         try {
-            QByteArray data = m_connection->read(0.1);
+            QByteArray data = m_connection->read(std::min(remainingNs / 1e9, RESPONSE_READ_SLICE));
 
             std::vector<QByteArray> packets = m_slipDecoder.process(data);
 
@@ -457,6 +1544,12 @@ ESP32Response FlashingService::waitForResponse(ESP32Command command, double time
                                  .toStdString());
 }
 
+int64_t FlashingService::steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 void FlashingService::sleepMs(int ms)
 {
     std::this_thread::sleep_for(std::chrono::milliseconds(ms));
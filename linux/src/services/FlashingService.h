@@ -8,15 +8,30 @@
 #include "models/SerialPort.h"
 #include "models/FirmwareFile.h"
 #include "models/FlashingState.h"
+#include "models/FlashReport.h"
+#include "models/SessionJob.h"
+#include "serial/PortSettings.h"
 #include "serial/SerialConnection.h"
 #include "protocol/SLIPCodec.h"
 #include "protocol/ESP32Protocol.h"
+#include "protocol/BootBannerMatcher.h"
+#include "protocol/ESP32Chip.h"
+#include "services/DeviceProfileCache.h"
+#include "services/FlashJournal.h"
+#include "services/FlashPlan.h"
+#include "services/TimeoutEstimator.h"
 
 #include <QObject>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QStringList>
 #include <QThread>
 #include <functional>
 #include <atomic>
+#include <deque>
 #include <memory>
+#include <optional>
+#include <vector>
 
 /**
  * Service that orchestrates the ESP32 flashing process
@@ -38,29 +53,242 @@ public:
      */
     void flash(const FirmwareFile& firmware, const SerialPort& port, BaudRate baudRate);
 
+    /**
+     * Execute a prepared flash plan (see planFor())
+     * This method is asynchronous - it starts flashing in a worker thread
+     */
+    void flash(const FlashPlan& plan, const SerialPort& port);
+
+    /**
+     * Build the optimized plan flash() would execute for this board
+     * Uses the cached device profile for baud limit, chip and reset timing.
+     */
+    FlashPlan planFor(const FirmwareFile& firmware, const SerialPort& port, BaudRate baudRate) const;
+
+    /**
+     * Describe the plan for this board with estimated durations, without
+     * touching the port
+     */
+    QStringList dryRun(const FirmwareFile& firmware, const SerialPort& port, BaudRate baudRate) const;
+
     /**
      * Cancel the current flash operation
+     * An open session is ended without rebooting.
      */
     void cancel();
 
+    /**
+     * Open a session: reset, sync and attach once, then stay attached to
+     * the ROM loader while jobs are submitted
+     * Emits sessionReady when the loader is attached (or failed to attach).
+     */
+    void beginSession(const SerialPort& port, BaudRate baudRate);
+
+    /**
+     * Queue a job on the open session (thread-safe)
+     * Jobs run in submission order; each one emits jobFinished.
+     * @return Job ID, or 0 if no session is open
+     */
+    int submit(SessionJob job);
+
+    /**
+     * Finish the queued jobs, then close the session
+     * @param reboot Reboot into the new firmware at the end
+     */
+    void endSession(bool reboot = true);
+
+    /**
+     * Use a port someone else already has open (the serial monitor) for
+     * the next run, instead of opening it again
+     * After the run the connection is kept for releaseConnection() rather
+     * than closed, so the owner keeps reading without a reopen.
+     */
+    void adoptConnection(std::unique_ptr<SerialConnection> connection);
+
+    /**
+     * Take back the adopted connection once the run has finished
+     * @return The still open port, or nullptr if it was lost (e.g. the
+     *         device re-enumerated after the reset)
+     */
+    std::unique_ptr<SerialConnection> releaseConnection();
+
     bool isFlashing() const { return m_isFlashing; }
+    bool isSessionOpen() const { return m_sessionOpen; }
 
 signals:
     void stateChanged(FlashingState state);
     void finished(bool success);
+    void chipDetected(const QString& chipName);
+    void reportReady(const FlashReport& report);
+    void sessionReady(bool success, const QString& errorMessage);
+    void jobFinished(const SessionResult& result);
+    void sessionEnded(bool success);
+
+    /**
+     * The chip was reset into its application at timestampNs (steady
+     * clock, like SerialReader timestamps), for boot timing
+     */
+    void deviceRebooted(const SerialPort& port, qint64 timestampNs);
 
 private:
-    void runFlashing(const FirmwareFile& firmware, const SerialPort& port, BaudRate baudRate);
+    /**
+     * State shared by the ops of one plan execution
+     */
+    struct RunContext {
+        SerialPort port;
+        PortSettings settings;      // How the fixture is wired
+        std::optional<DeviceProfile> cached;
+        DeviceProfile profile;
+
+        bool synced = false;        // ROM loader has answered SYNC
+        bool baudChanged = false;   // Link was switched to a faster rate
+        bool resumable = false;     // Journal holds earlier progress
+
+        int firstBlock = 0;         // Where the open write session starts
+        int bytesFlashed = 0;       // Progress across extents
+        int totalBytes = 0;
+        int blockDelayMs = 0;       // Pause after each block, from the plan being run
+
+        // Options of the plan that attached the session
+        FlashPlan::Options planOptions;
+    };
+
+    /**
+     * Plan options for this board (cached baud limit, chip, reset timing)
+     */
+    FlashPlan::Options planOptionsFor(const SerialPort& port, BaudRate baudRate) const;
+
+    /**
+     * Reset per-run state and look up the board's cached profile
+     */
+    RunContext startRun(const SerialPort& port);
+
+    /**
+     * Update the cached profile after a run
+     * Only failures of the link itself lower the baud ceiling; a clean
+     * run at the ceiling raises it a step to probe again next time.
+     */
+    void rememberSuccess(RunContext& ctx, BaudRate baudRate);
+    void rememberFailure(RunContext& ctx, BaudRate baudRate, FlashingErrorType errorType);
+
+    /**
+     * The run failed because the link couldn't carry the data
+     */
+    bool isLinkFailure(FlashingErrorType errorType) const;
+
+    /**
+     * End of a run: close the port, or keep it for releaseConnection()
+     * if it was adopted and is still usable
+     */
+    void releasePort();
+
+    void runFlashing(const FlashPlan& plan, const SerialPort& port);
+
+    /**
+     * Session worker: attach, run submitted jobs, reboot once at the end
+     */
+    void runSession(const FlashPlan& connectPlan, const SerialPort& port);
+
+    /**
+     * Run one session job; failures are reported in the result
+     * A lost port marks the context as no longer synced.
+     */
+    SessionResult runJob(const SessionJob& job, RunContext& ctx);
+
+    /**
+     * Factory MAC address from eFuse (6 bytes)
+     */
+    QByteArray readMac();
+
+    /**
+     * Raw eFuse words starting at offset from the eFuse base, little-endian
+     */
+    QByteArray readEfuses(uint32_t offset, uint32_t wordCount);
+
+    /**
+     * Run every op of a plan in order, with per-op retries and timing
+     * Throws FlashError on the first op that fails all its attempts.
+     */
+    void executePlan(FlashPlan plan, RunContext& ctx);
+
+    /**
+     * Run one op, converting any failure into a typed FlashError
+     */
+    void runOp(const FlashOp& op, RunContext& ctx);
+
+    /**
+     * Error type reported when an op of this type fails
+     */
+    static FlashingErrorType errorTypeFor(FlashOpType type);
+
+    /**
+     * Reset op: open the port and get the chip into the ROM loader
+     * Falls back to closing and reopening the port for USB re-enumeration.
+     */
+    void enterLoader(RunContext& ctx);
+
+    /**
+     * Sync op: SYNC if the reset didn't already, identify the chip and
+     * disable the watchdogs
+     */
+    void prepareLoader(RunContext& ctx);
+
+    /**
+     * EraseRegion op: FLASH_BEGIN for the part of the extent still to be
+     * written (all of it unless the journal says otherwise)
+     */
+    void eraseRegion(const FlashOp& op, RunContext& ctx);
+
+    /**
+     * Verify op: compare the ROM's MD5 of the region with the expected data
+     */
+    void verifyRegion(const FlashOp& op);
+
+    static FirmwareImage imageFor(const FlashOp& op);
 
     /**
      * Perform sync with bootloader with retries
+     * @param maxAttempts Number of SYNC attempts before giving up
+     * @return Number of attempts the successful sync took
      */
-    void syncWithRetry();
+    int syncWithRetry(int maxAttempts);
 
     /**
      * Perform a single sync attempt
+     * @param timeout Seconds to wait for the first SYNC response
+     * @return When the first response arrived (steadyNowNs)
+     */
+    int64_t performSync(double timeout = 1.0);
+
+    /**
+     * One reset sequence to try, with its wait times scaled
+     */
+    struct ResetAttempt {
+        ResetStrategy strategy;
+        double timingScale;
+    };
+
+    /**
+     * Ordered reset sequences to escalate through for a port
+     * Starts with the cached fingerprint, if there is one; a port set up
+     * with a reset strategy only tries that one.
+     */
+    std::vector<ResetAttempt> resetAttempts(const SerialPort& port, const PortSettings& settings,
+                                            const std::optional<DeviceProfile>& cached) const;
+
+    /**
+     * Run reset sequences until one gets a SYNC response from the ROM
+     * Records the sequence, timing and time-to-ready in profile.
+     * @return true if the loader answered, false if the reopen path is needed
      */
-    void performSync();
+    bool resetIntoBootloader(const std::vector<ResetAttempt>& attempts, DeviceProfile& profile);
+
+    /**
+     * Scan incoming bytes for the ROM boot banner right after a reset
+     * Returns as soon as the banner is conclusive; records the banner line
+     * as the failure reason if the chip booted the application instead.
+     */
+    BootBannerMatcher::Result listenForBootBanner();
 
     /**
      * Change baud rate
@@ -72,8 +300,16 @@ private:
      */
     void spiAttach();
 
+    /**
+     * Identify the connected chip and select its register map
+     * Reads CHIP_DETECT_MAGIC_REG, falling back to GET_SECURITY_INFO.
+     * @return Detected family, or Unknown (ESP32-C3 registers are then used)
+     */
+    ESP32ChipFamily detectChip();
+
     /**
      * Disable RTC and Super watchdogs for USB-JTAG-Serial devices
+     * Uses the register map of the detected chip.
      */
     void disableWatchdogs();
 
@@ -93,15 +329,89 @@ private:
     void flashBegin(uint32_t size, uint32_t numBlocks, uint32_t blockSize, uint32_t offset);
 
     /**
-     * Flash a single data block
+     * Send a single data block
+     * @return The ROM's response; a timeout throws
+     */
+    ESP32Response flashData(const QByteArray& block, int sequenceNumber);
+
+    /**
+     * Write one image into an open session, retrying failed blocks within
+     * the retry budget
+     * A rejected block is resent once; after that, or when a block goes
+     * unanswered, the session is resynced and resumed from the block's sector.
+     * @param firstBlock Block to start at (earlier blocks are already verified)
+     * @param bytesFlashed Bytes of earlier images, for overall progress
+     * @param blockDelayMs Pause after each acknowledged block
+     */
+    void flashImage(const FirmwareImage& image, int firstBlock, int bytesFlashed, int totalBytes,
+                    int blockDelayMs);
+
+    /**
+     * Check the journaled progress of an image against the flash contents
+     * Hashes the acknowledged whole sectors with SPI_FLASH_MD5.
+     * @return Number of leading blocks that don't need writing again
+     */
+    int verifiedBlocks(const FirmwareImage& image);
+
+    /**
+     * MD5 of a flash region, computed by the ROM
+     */
+    QByteArray flashMd5(uint32_t address, uint32_t size);
+
+    /**
+     * Send FLASH_BEGIN for the part of an image from firstBlock onwards
      */
-    void flashData(const QByteArray& block, int sequenceNumber);
+    void beginImageAt(const FirmwareImage& image, int firstBlock);
+
+    /**
+     * SYNC and restart the image at the sector containing failedBlock
+     * @param stepDown Move the link to the next slower rate before restarting
+     * @return Block the new session starts at
+     */
+    int resumeImage(const FirmwareImage& image, int failedBlock, bool stepDown = false);
+
+    /**
+     * Add the driver's line error counts since the last sample to the report
+     * The first sample after the port opens only sets the baseline.
+     */
+    void sampleLineErrors();
+
+    /**
+     * Whether the link is above the slowest rate and may still step down
+     */
+    bool canStepDown() const;
+
+    /**
+     * Move the synced link to the next slower rate, mid-session
+     */
+    void stepDownBaudRate();
 
     /**
      * End flash operation
+     * When rebooting, returns as soon as the reset is confirmed.
      */
     void flashEnd(bool reboot, bool isUSBJTAGSerial);
 
+    /**
+     * Reset the chip by arming the RTC watchdog via WRITE_REG
+     */
+    void watchdogReset();
+
+    /**
+     * Wait until the chip has demonstrably reset
+     * Confirmed by the port disappearing (USB re-enumeration) or by the
+     * ROM banner appearing on the line.
+     * @return false if nothing was seen within the confirmation window
+     */
+    bool waitForResetConfirmation();
+
+    /**
+     * Send a command and wait for its response with an adaptive timeout
+     * Successful round trips calibrate the timeout; failures back it off.
+     * @param packet Unencoded command packet
+     */
+    ESP32Response sendCommand(ESP32Command command, const QByteArray& packet);
+
     /**
      * Wait for a response from the bootloader
      */
@@ -112,17 +422,87 @@ private:
      */
     static void sleepMs(int ms);
 
+    /**
+     * steady_clock time in nanoseconds
+     */
+    static int64_t steadyNowNs();
+
     std::unique_ptr<SerialConnection> m_connection;
     SLIPDecoder m_slipDecoder;
+    DeviceProfileCache m_profileCache;
+    TimeoutEstimator m_timeouts;
+    FlashReport m_report;
+    FlashJournal m_journal;
     std::atomic<bool> m_isCancelled{false};
     std::atomic<bool> m_isFlashing{false};
 
+    // Why the last reset failed to reach download mode, if the ROM told us
+    QString m_bootFailureReason;
+    SerialPort m_port;          // Port of the current run
+
+    // Rate the link is at, the driver's counters as of the last sample,
+    // and what this rate has cost so far
+    BaudRate m_linkBaudRate = BaudRate::Baud115200;
+    std::optional<SerialErrorCounters> m_lineErrorBase;
+    uint64_t m_lineErrorsAtRate = 0;
+    int m_retriesBeforeRate = 0;
+
+    // Register map of the connected chip (set after sync)
+    const ESP32ChipDescriptor* m_chip = nullptr;
+
     // Constants matching macOS implementation exactly
     static constexpr int SYNC_RETRIES = 20;
-    static constexpr double RESPONSE_TIMEOUT = 5.0;
     static constexpr int BLOCK_DELAY_MS = 5;
     static constexpr int SYNC_RETRY_DELAY_MS = 50;
 
+    // Block retries: per block, across the whole flash, and SYNCs to
+    // get back in step before resuming
+    static constexpr int BLOCK_RETRY_LIMIT = 3;
+    static constexpr int FLASH_RETRY_BUDGET = 16;
+    static constexpr int RESYNC_ATTEMPTS = 5;
+
+    // A block failure at a rate that has seen this many line errors, or
+    // that ran out of retries, steps the link down instead of failing;
+    // each slower rate gets a fresh retry budget
+    static constexpr uint64_t LINE_ERROR_LIMIT = 4;
+    static constexpr int MAX_BAUD_STEPS = 2;
+
+    // Reset escalation: how long to probe for the loader after each
+    // sequence, and how much to stretch the waits on the slow retry
+    static constexpr int READY_WINDOW_MS = 1000;
+    static constexpr double PROBE_SYNC_TIMEOUT = 0.1;
+
+    // The ROM answers one SYNC with eight back to back; a gap this long
+    // means the rest have all arrived
+    static constexpr double SYNC_DRAIN_GAP = 0.01;
+    static constexpr int SYNC_DRAIN_MAX_MS = 100;
+    static constexpr double SLOW_RESET_TIMING_SCALE = 3.0;
+
+    // Longest single read while waiting for a response; bounds how long
+    // a cancel goes unnoticed
+    static constexpr double RESPONSE_READ_SLICE = 0.1;
+
+    // Boot banner listen phase after each reset sequence
+    static constexpr int BANNER_WINDOW_MS = 300;
+    static constexpr double BANNER_READ_TIMEOUT = 0.02;
+
+    // How long to wait for proof of a reset before falling back to DTR/RTS
+    static constexpr int RESET_CONFIRM_WINDOW_MS = 500;
+
+    // Session job queue, shared between the caller and the worker thread
+    QMutex m_jobMutex;
+    QWaitCondition m_jobAvailable;
+    std::deque<SessionJob> m_jobs;
+    bool m_endRequested = false;
+    bool m_rebootOnEnd = true;
+    int m_nextJobId = 1;
+    std::atomic<bool> m_sessionOpen{false};
+
+    // Connection handed over by adoptConnection(), before and after a run
+    QMutex m_handoffMutex;
+    std::unique_ptr<SerialConnection> m_handoff;
+    bool m_handBack = false;
+
     QThread* m_workerThread = nullptr;
 };
 
@@ -0,0 +1,342 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "LogCapture.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QMutexLocker>
+#include <QStandardPaths>
+
+#include <cstring>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+#ifdef HAVE_ZSTD
+// Fast enough for several ports at 2 Mbaud on one core
+constexpr int ZSTD_LEVEL = 3;
+#endif
+
+void appendLittleEndian(QByteArray& out, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i) {
+        out.append(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+} // anonymous namespace
+
+LogCapture::~LogCapture()
+{
+    stop();
+}
+
+bool LogCapture::zstdAvailable()
+{
+#ifdef HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LogCapture::start(const QString& deviceId, Compression compression)
+{
+    stop();
+
+    m_directory = captureDirectory(deviceId);
+    m_compression = zstdAvailable() ? compression : Compression::None;
+    m_writtenOffset = 0;
+    m_bytesCaptured = 0;
+    m_droppedBytes = 0;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending.clear();
+        m_pendingIndex.clear();
+        m_streamOffset = 0;
+        m_lastIndexMs = 0;
+        m_stopRequested = false;
+        m_error.clear();
+    }
+
+    if (!QDir().mkpath(m_directory) || !openFiles()) {
+        closeFiles();
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_accepting = true;
+    }
+
+    m_thread = std::thread([this]() {
+        run();
+    });
+    return true;
+}
+
+void LogCapture::stop()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_accepting = false;
+        m_stopRequested = true;
+        m_wake.wakeAll();
+    }
+
+    m_thread.join();
+}
+
+void LogCapture::consume(const char* data, size_t size)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_accepting) {
+        return;
+    }
+
+    if (m_pending.size() + size > MAX_PENDING_BYTES) {
+        m_droppedBytes += size;
+        return;
+    }
+
+    int64_t now = QDateTime::currentMSecsSinceEpoch();
+    if (now - m_lastIndexMs >= INDEX_INTERVAL_MS) {
+        m_pendingIndex.push_back({now, m_streamOffset});
+        m_lastIndexMs = now;
+    }
+
+    bool wasBelow = m_pending.size() < WAKE_BYTES;
+    m_pending.insert(m_pending.end(), data, data + size);
+    m_streamOffset += size;
+
+    if (wasBelow && m_pending.size() >= WAKE_BYTES) {
+        m_wake.wakeOne();
+    }
+}
+
+QString LogCapture::currentFile() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_currentFile;
+}
+
+QString LogCapture::errorString() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_error;
+}
+
+QString LogCapture::captureDirectory(const QString& deviceId)
+{
+    // Keep the directory readable; anything unusual becomes '_'
+    QString name;
+    for (QChar c : deviceId) {
+        char16_t u = c.unicode();
+        bool safe = (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') ||
+                    (u >= '0' && u <= '9') || u == '-' || u == '_' || u == '.';
+        name += safe ? c : QChar('_');
+    }
+    if (name.isEmpty() || name.startsWith('.')) {
+        name.prepend("device");
+    }
+
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QString("%1/captures/%2").arg(dir, name);
+}
+
+void LogCapture::run()
+{
+    std::vector<char> batch;
+    std::vector<IndexEntry> index;
+
+    for (;;) {
+        bool stopping;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_pending.size() < WAKE_BYTES && !m_stopRequested) {
+                m_wake.wait(&m_mutex, WRITE_INTERVAL_MS);
+            }
+            // Swapping keeps both buffers' capacity, so steady state allocates nothing
+            batch.swap(m_pending);
+            index.swap(m_pendingIndex);
+            stopping = m_stopRequested;
+        }
+
+        if (!batch.empty()) {
+            writeBatch(batch, index);
+        }
+        batch.clear();
+        index.clear();
+
+        if (stopping) {
+            break;
+        }
+    }
+
+    closeFiles();
+}
+
+void LogCapture::writeBatch(const std::vector<char>& data, const std::vector<IndexEntry>& index)
+{
+    if (!m_log.isOpen()) {
+        return;
+    }
+
+    if (m_fileBytes >= MAX_FILE_BYTES) {
+        closeFiles();
+        if (!openFiles()) {
+            return;
+        }
+    }
+
+    QByteArray records;
+    for (const IndexEntry& entry : index) {
+        appendLittleEndian(records, static_cast<uint64_t>(entry.timestampMs));
+        appendLittleEndian(records, entry.streamOffset - m_fileStartOffset);
+    }
+    if (!records.isEmpty() && m_index.write(records) != records.size()) {
+        fail(m_index.errorString());
+        return;
+    }
+    m_index.flush();
+
+    bool written;
+    if (m_compression == Compression::Zstd) {
+        written = writeCompressed(data.data(), data.size(), false);
+    } else {
+        written = m_log.write(data.data(), static_cast<qint64>(data.size())) ==
+                  static_cast<qint64>(data.size());
+        if (!written) {
+            fail(m_log.errorString());
+        }
+    }
+
+    if (written) {
+        m_fileBytes += static_cast<int64_t>(data.size());
+        m_writtenOffset += data.size();
+        m_bytesCaptured += data.size();
+    }
+}
+
+bool LogCapture::openFiles()
+{
+    QString stamp = QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz");
+    QString base = QString("%1/%2").arg(m_directory, stamp);
+    QString logName = base + (m_compression == Compression::Zstd ? ".log.zst" : ".log");
+
+    // Batches are already large; skip QFile's own buffer
+    m_log.setFileName(logName);
+    m_index.setFileName(base + ".idx");
+    if (!m_log.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        fail(m_log.errorString());
+        return false;
+    }
+    if (!m_index.open(QIODevice::WriteOnly)) {
+        fail(m_index.errorString());
+        m_log.close();
+        return false;
+    }
+
+#ifdef HAVE_ZSTD
+    if (m_compression == Compression::Zstd) {
+        m_zstd = ZSTD_createCCtx();
+        ZSTD_CCtx_setParameter(m_zstd, ZSTD_c_compressionLevel, ZSTD_LEVEL);
+        m_compressBuffer.resize(ZSTD_CStreamOutSize());
+    }
+#endif
+
+    m_fileBytes = 0;
+    m_fileStartOffset = m_writtenOffset;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_currentFile = logName;
+    }
+
+    pruneOldFiles();
+    return true;
+}
+
+void LogCapture::closeFiles()
+{
+#ifdef HAVE_ZSTD
+    if (m_zstd) {
+        if (m_log.isOpen()) {
+            writeCompressed(nullptr, 0, true);
+        }
+        ZSTD_freeCCtx(m_zstd);
+        m_zstd = nullptr;
+    }
+#endif
+
+    m_log.close();
+    m_index.close();
+}
+
+void LogCapture::pruneOldFiles()
+{
+    QDir dir(m_directory);
+    QStringList logs = dir.entryList({"*.log", "*.log.zst"}, QDir::Files, QDir::Name);
+
+    // Names start with the capture time, so name order is age order
+    while (logs.size() > MAX_FILES_PER_DEVICE) {
+        QString oldest = logs.takeFirst();
+        QString base = oldest.left(oldest.indexOf(".log"));
+        dir.remove(oldest);
+        dir.remove(base + ".idx");
+    }
+}
+
+bool LogCapture::writeCompressed(const char* data, size_t size, bool endFrame)
+{
+#ifdef HAVE_ZSTD
+    // Flushing each batch keeps the file decodable up to the last write,
+    // even if the app is killed mid-capture
+    ZSTD_EndDirective mode = endFrame ? ZSTD_e_end : ZSTD_e_flush;
+    ZSTD_inBuffer input{data, size, 0};
+
+    for (;;) {
+        ZSTD_outBuffer output{m_compressBuffer.data(), m_compressBuffer.size(), 0};
+        size_t remaining = ZSTD_compressStream2(m_zstd, &output, &input, mode);
+        if (ZSTD_isError(remaining)) {
+            fail(QString::fromLatin1(ZSTD_getErrorName(remaining)));
+            return false;
+        }
+
+        qint64 produced = static_cast<qint64>(output.pos);
+        if (produced > 0 && m_log.write(m_compressBuffer.data(), produced) != produced) {
+            fail(m_log.errorString());
+            return false;
+        }
+
+        if (remaining == 0 && input.pos == input.size) {
+            return true;
+        }
+    }
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(size);
+    Q_UNUSED(endFrame);
+    return false;
+#endif
+}
+
+void LogCapture::fail(const QString& message)
+{
+    m_log.close();
+    m_index.close();
+
+    QMutexLocker locker(&m_mutex);
+    m_error = message;
+    m_accepting = false;
+}
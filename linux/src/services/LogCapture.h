@@ -0,0 +1,142 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef LOGCAPTURE_H
+#define LOGCAPTURE_H
+
+#include "serial/SerialReader.h"
+
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_ZSTD
+struct ZSTD_CCtx_s;
+#endif
+
+/**
+ * Captures a port's raw output to disk for long soak tests
+ *
+ * consume() runs on the reader thread and only appends to a memory
+ * buffer; a writer thread moves that buffer to disk in large writes. If
+ * the disk can't keep up the newest bytes are dropped and counted - the
+ * reader is never held up.
+ *
+ * Files go to AppDataLocation/captures/<device>/<start time>.log (or
+ * .log.zst when compressed) and rotate every MAX_FILE_BYTES. Next to each
+ * is a .idx file of 16-byte little-endian records: milliseconds since the
+ * epoch (int64) and the uncompressed byte offset in the log (uint64),
+ * written at most every INDEX_INTERVAL_MS.
+ */
+class LogCapture : public ByteSink {
+public:
+    enum class Compression {
+        None,
+        Zstd
+    };
+
+    /// Uncompressed bytes per file before rotating
+    static constexpr int64_t MAX_FILE_BYTES = 256LL * 1024 * 1024;
+
+    /// Oldest files beyond this are deleted when a new one is opened
+    static constexpr int MAX_FILES_PER_DEVICE = 32;
+
+    /// Buffered bytes beyond which new output is dropped
+    static constexpr size_t MAX_PENDING_BYTES = 64 * 1024 * 1024;
+
+    /// The writer wakes early once this much is buffered
+    static constexpr size_t WAKE_BYTES = 1024 * 1024;
+
+    static constexpr int WRITE_INTERVAL_MS = 250;
+    static constexpr int INDEX_INTERVAL_MS = 100;
+
+    LogCapture() = default;
+    ~LogCapture() override;
+
+    LogCapture(const LogCapture&) = delete;
+    LogCapture& operator=(const LogCapture&) = delete;
+
+    /**
+     * Whether this build can write zstd-compressed captures
+     */
+    static bool zstdAvailable();
+
+    /**
+     * Start capturing into the device's capture directory
+     * @param deviceId Serial number, or port name when there is none
+     * @return false if the first file could not be created
+     */
+    bool start(const QString& deviceId, Compression compression = Compression::None);
+
+    /**
+     * Write out everything buffered and close the files
+     */
+    void stop();
+
+    bool isRunning() const { return m_thread.joinable(); }
+
+    /**
+     * Reader thread: queue bytes for the writer (never blocks on disk)
+     */
+    void consume(const char* data, size_t size) override;
+
+    QString currentFile() const;
+    QString errorString() const;
+
+    uint64_t bytesCaptured() const { return m_bytesCaptured; }
+    uint64_t droppedBytes() const { return m_droppedBytes; }
+
+    static QString captureDirectory(const QString& deviceId);
+
+private:
+    struct IndexEntry {
+        int64_t timestampMs;
+        uint64_t streamOffset;
+    };
+
+    void run();
+    void writeBatch(const std::vector<char>& data, const std::vector<IndexEntry>& index);
+    bool openFiles();
+    void closeFiles();
+    void pruneOldFiles();
+    bool writeCompressed(const char* data, size_t size, bool endFrame);
+    void fail(const QString& message);
+
+    QString m_directory;
+    Compression m_compression = Compression::None;
+    std::thread m_thread;
+
+    // Shared with the reader thread
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    std::vector<char> m_pending;
+    std::vector<IndexEntry> m_pendingIndex;
+    uint64_t m_streamOffset = 0;
+    int64_t m_lastIndexMs = 0;
+    bool m_accepting = false;
+    bool m_stopRequested = false;
+    QString m_currentFile;
+    QString m_error;
+
+    // Writer thread only
+    QFile m_log;
+    QFile m_index;
+    int64_t m_fileBytes = 0;
+    uint64_t m_writtenOffset = 0;
+    uint64_t m_fileStartOffset = 0;
+    std::vector<char> m_compressBuffer;
+#ifdef HAVE_ZSTD
+    ZSTD_CCtx_s* m_zstd = nullptr;
+#endif
+
+    std::atomic<uint64_t> m_bytesCaptured{0};
+    std::atomic<uint64_t> m_droppedBytes{0};
+};
+
+#endif // LOGCAPTURE_H
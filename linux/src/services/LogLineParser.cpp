@@ -0,0 +1,207 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "LogLineParser.h"
+
+#include <cstring>
+
+namespace {
+
+constexpr char16_t ESCAPE = 0x1B;
+
+// Past this many tags, new ones are counted as untagged; a garbled stream
+// can otherwise invent a new "tag" every line
+constexpr int MAX_TAGS = 4096;
+
+} // anonymous namespace
+
+LogRecord LogLineParser::parse(QStringView line)
+{
+    LogRecord record;
+    const int length = static_cast<int>(line.size());
+    int i = 0;
+
+    // "[ttyUSB0 A50285BI] " in the merged view
+    if (length > 0 && line[0] == QChar('[')) {
+        int close = static_cast<int>(line.indexOf(QLatin1String("] ")));
+        if (close > 0) {
+            i = close + 2;
+        }
+    }
+
+    // Color code, if it wasn't stripped
+    if (i < length && line[i].unicode() == ESCAPE) {
+        int end = static_cast<int>(line.indexOf(QChar('m'), i));
+        if (end < 0) {
+            return record;
+        }
+        i = end + 1;
+    }
+
+    if (length - i < 5 || line[i + 1] != QChar(' ') || line[i + 2] != QChar('(')) {
+        return record;
+    }
+    const LogLevel level = logLevelFromLetter(line[i]);
+    if (level == LogLevel::None) {
+        return record;
+    }
+
+    // "(1234)" is milliseconds since boot; "(12:34:56.789)" is wall time
+    int64_t total = 0;
+    int64_t field = 0;
+    int digits = 0;
+    int fractionDigits = 0;
+    bool clock = false;
+    bool fraction = false;
+    int j = i + 3;
+    for (; j < length; ++j) {
+        const char16_t c = line[j].unicode();
+        if (c >= '0' && c <= '9') {
+            field = field * 10 + (c - '0');
+            ++digits;
+            if (fraction) {
+                ++fractionDigits;
+            }
+        } else if (c == ':' && !fraction) {
+            total = (total + field) * 60;
+            field = 0;
+            clock = true;
+        } else if (c == '.' && !fraction) {
+            total += field;
+            field = 0;
+            fraction = true;
+        } else {
+            break;
+        }
+    }
+    if (j >= length || line[j] != QChar(')') || digits == 0) {
+        return record;
+    }
+
+    record.level = level;
+    if (fraction) {
+        int64_t scale = 1;
+        for (int k = 0; k < fractionDigits; ++k) {
+            scale *= 10;
+        }
+        record.uptimeMs = total * 1000 + field * 1000 / scale;
+    } else {
+        record.uptimeMs = clock ? (total + field) * 1000 : field;
+    }
+
+    // ") tag: message"
+    int tagStart = j + 2;
+    if (tagStart > length) {
+        return record;
+    }
+    int separator = static_cast<int>(line.indexOf(QLatin1String(": "), tagStart));
+    if (separator < 0 && line.endsWith(QChar(':'))) {
+        separator = length - 1;
+    }
+
+    if (separator > tagStart) {
+        record.tagStart = tagStart;
+        record.tagLength = separator - tagStart;
+        record.messageStart = std::min(separator + 2, length);
+    } else {
+        record.messageStart = tagStart;
+    }
+    record.messageLength = length - record.messageStart;
+
+    // Trailing color reset, if it wasn't stripped
+    if (line.endsWith(QLatin1String("\x1b[0m")) && record.messageLength >= 4) {
+        record.messageLength -= 4;
+    }
+    return record;
+}
+
+QByteArray AnsiStripper::strip(const QByteArray& data)
+{
+    if (m_state == State::Text && !std::memchr(data.constData(), ESCAPE, static_cast<size_t>(data.size()))) {
+        return data;
+    }
+
+    QByteArray text;
+    text.reserve(data.size());
+    for (char c : data) {
+        const auto byte = static_cast<unsigned char>(c);
+        switch (m_state) {
+        case State::Text:
+            if (byte == ESCAPE) {
+                m_state = State::Escape;
+            } else {
+                text.append(c);
+            }
+            break;
+        case State::Escape:
+            // ESC [ starts a control sequence; any other ESC pair is whole
+            m_state = byte == '[' ? State::Sequence : State::Text;
+            break;
+        case State::Sequence:
+            if (byte >= 0x40 && byte <= 0x7E) {
+                m_state = State::Text;
+            }
+            break;
+        }
+    }
+    return text;
+}
+
+int LogStats::count(QStringView line, const LogRecord& record)
+{
+    const int level = static_cast<int>(record.level);
+    ++m_totals[level];
+    if (!record.hasTag()) {
+        return NO_TAG;
+    }
+
+    const QStringView tag = line.mid(record.tagStart, record.tagLength);
+    int id = m_lastTag;
+    if (id == NO_TAG || m_tags[id] != tag) {
+        const QString name = tag.toString();
+        id = m_tagIds.value(name, NO_TAG);
+        if (id == NO_TAG) {
+            if (tagCount() >= MAX_TAGS) {
+                return NO_TAG;
+            }
+            id = tagCount();
+            m_tags.append(name);
+            m_tagCounts.push_back(Counts{});
+            m_tagIds.insert(name, id);
+        }
+    }
+
+    ++m_tagCounts[id][level];
+    m_lastTag = id;
+    return id;
+}
+
+void LogStats::clear()
+{
+    m_tags.clear();
+    m_tagCounts.clear();
+    m_tagIds.clear();
+    m_totals = Counts{};
+    m_lastTag = NO_TAG;
+}
+
+QString LogStats::describe(const Counts& counts)
+{
+    static const struct {
+        LogLevel level;
+        const char* letter;
+    } kLevels[] = {
+        {LogLevel::Error, "E"}, {LogLevel::Warning, "W"}, {LogLevel::Info, "I"},
+        {LogLevel::Debug, "D"}, {LogLevel::Verbose, "V"},
+    };
+
+    QStringList parts;
+    for (const auto& entry : kLevels) {
+        uint64_t count = counts[static_cast<int>(entry.level)];
+        if (count > 0) {
+            parts.append(QString("%1 %2").arg(entry.letter).arg(count));
+        }
+    }
+    return parts.join("  ");
+}
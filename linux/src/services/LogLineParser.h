@@ -0,0 +1,114 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef LOGLINEPARSER_H
+#define LOGLINEPARSER_H
+
+#include "models/LogLevel.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * One ESP-IDF log line, "I (1234) wifi: connected", as spans of the line
+ * Lines in any other format have level None and no tag.
+ */
+struct LogRecord {
+    LogLevel level = LogLevel::None;
+    int64_t uptimeMs = -1;      // -1 if the line has no timestamp
+    int tagStart = 0;
+    int tagLength = 0;
+    int messageStart = 0;
+    int messageLength = 0;
+
+    bool hasTag() const { return tagLength > 0; }
+};
+
+/**
+ * Splits a line into a LogRecord without copying any of it
+ *
+ * Understands both timestamp styles ESP-IDF prints, "(1234)" milliseconds
+ * since boot and "(12:34:56.789)" system time, and skips a merged view's
+ * "[port] " prefix.
+ */
+class LogLineParser {
+public:
+    static LogRecord parse(QStringView line);
+};
+
+/**
+ * Removes ANSI escape sequences (ESP-IDF's log colors) from a byte stream
+ *
+ * Sequences split across reads are handled. Chunks without an escape
+ * byte, which is nearly all of them with colors off, are passed through
+ * without a copy.
+ */
+class AnsiStripper {
+public:
+    QByteArray strip(const QByteArray& data);
+    void reset() { m_state = State::Text; }
+
+private:
+    enum class State {
+        Text,
+        Escape,     // After ESC
+        Sequence    // After ESC [ until the final byte
+    };
+
+    State m_state = State::Text;
+};
+
+/**
+ * Lines per tag and level
+ *
+ * Tags get small integer ids so a view can keep one per line and filter
+ * on them cheaply.
+ */
+class LogStats {
+public:
+    using Counts = std::array<uint64_t, 6>;     // Indexed by LogLevel
+
+    /// Id of lines without a tag
+    static constexpr int NO_TAG = -1;
+
+    /**
+     * Count a parsed line
+     * @return Its tag id (NO_TAG if it has none)
+     */
+    int count(QStringView line, const LogRecord& record);
+
+    void clear();
+
+    /**
+     * Every line, by level
+     */
+    const Counts& totals() const { return m_totals; }
+
+    int tagCount() const { return static_cast<int>(m_tags.size()); }
+    const QString& tagName(int id) const { return m_tags[id]; }
+    const Counts& tagCounts(int id) const { return m_tagCounts[id]; }
+    int tagId(const QString& tag) const { return m_tagIds.value(tag, NO_TAG); }
+
+    /**
+     * e.g. "E 3  W 12  I 480"
+     */
+    static QString describe(const Counts& counts);
+
+private:
+    QStringList m_tags;
+    std::vector<Counts> m_tagCounts;
+    QHash<QString, int> m_tagIds;
+    Counts m_totals{};
+
+    // Consecutive lines mostly share a tag; this skips the hash for them
+    int m_lastTag = NO_TAG;
+};
+
+#endif // LOGLINEPARSER_H
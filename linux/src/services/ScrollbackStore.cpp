@@ -0,0 +1,434 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "ScrollbackStore.h"
+#include "services/LogLineParser.h"
+
+#include <QRegularExpression>
+
+#include <algorithm>
+
+namespace {
+
+// Fastest zlib level: sealing a block costs about a millisecond
+constexpr int COMPRESSION_LEVEL = 1;
+
+inline void trigramBits(const char* bytes, uint32_t& first, uint32_t& second)
+{
+    uint64_t trigram = static_cast<uint8_t>(bytes[0]) |
+                       (static_cast<uint64_t>(static_cast<uint8_t>(bytes[1])) << 8) |
+                       (static_cast<uint64_t>(static_cast<uint8_t>(bytes[2])) << 16);
+    uint64_t hash = trigram * 0x9E3779B97F4A7C15ULL;
+    first = static_cast<uint32_t>(hash >> 48) % ScrollbackStore::BLOOM_BITS;
+    second = static_cast<uint32_t>(hash >> 32) % ScrollbackStore::BLOOM_BITS;
+}
+
+/**
+ * Index of the ']' closing the class opened at start, or -1
+ * A ']' right after "[" or "[^" is a literal, and so is one ending a
+ * POSIX class like "[:alpha:]".
+ */
+int skipClass(const QString& pattern, int start)
+{
+    int i = start + 1;
+    if (i < pattern.size() && pattern[i] == QChar('^')) {
+        ++i;
+    }
+    if (i < pattern.size() && pattern[i] == QChar(']')) {
+        ++i;
+    }
+    for (; i < pattern.size(); ++i) {
+        const QChar c = pattern[i];
+        if (c == QChar('\\')) {
+            ++i;
+        } else if (c == QChar('[') && pattern.mid(i + 1, 1) == QLatin1String(":")) {
+            i = pattern.indexOf(QLatin1String(":]"), i + 2);
+            if (i < 0) {
+                return -1;
+            }
+            ++i;
+        } else if (c == QChar(']')) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Index of the ')' closing the group opened at start, or -1
+ */
+int skipGroup(const QString& pattern, int start)
+{
+    int depth = 0;
+    for (int i = start; i < pattern.size(); ++i) {
+        const QChar c = pattern[i];
+        if (c == QChar('\\')) {
+            ++i;
+        } else if (c == QChar('[')) {
+            i = skipClass(pattern, i);
+            if (i < 0) {
+                return -1;
+            }
+        } else if (c == QChar('(')) {
+            ++depth;
+        } else if (c == QChar(')') && --depth == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Literal runs every match of a regex must contain, lowercased UTF-8,
+ * three bytes or longer (shorter ones have no trigram to look up)
+ *
+ * Conservative: groups, classes and escapes end a run, a run only counts
+ * if nothing makes it optional, and anything hard to reason about
+ * (top-level alternation, extended mode, numeric escapes) yields nothing,
+ * which just means every block is scanned.
+ */
+std::vector<QByteArray> requiredLiterals(const QString& pattern, bool caseSensitive)
+{
+    std::vector<QByteArray> literals;
+    QString run;
+    auto endRun = [&]() {
+        // The filter folds ASCII case only, a case-insensitive regex all of it
+        QByteArray utf8 = run.toUtf8();
+        bool ascii = std::all_of(utf8.begin(), utf8.end(), [](char b) { return (b & 0x80) == 0; });
+        if (utf8.size() >= 3 && (caseSensitive || ascii)) {
+            literals.push_back(utf8.toLower());
+        }
+        run.clear();
+    };
+
+    for (int i = 0; i < pattern.size(); ++i) {
+        const QChar c = pattern[i];
+        switch (c.unicode()) {
+        case '|':
+            return {};
+        case '\\': {
+            if (i + 1 >= pattern.size()) {
+                return {};
+            }
+            const QChar escaped = pattern[++i];
+            if (!escaped.isLetterOrNumber()) {
+                run += escaped;
+            } else if (QString("dDwWsSbBntrfvhHRAzZG").contains(escaped)) {
+                endRun();
+            } else {
+                return {};  // \x41, \Q...\E, back-references and the like
+            }
+            break;
+        }
+        case '(': {
+            // (?x) makes whitespace in the pattern mean nothing
+            if (pattern.mid(i, 2) == QLatin1String("(?")) {
+                for (int j = i + 2; j < pattern.size() && (pattern[j].isLetter() || pattern[j] == QChar('-')); ++j) {
+                    if (pattern[j] == QChar('x')) {
+                        return {};
+                    }
+                }
+            }
+            endRun();
+            i = skipGroup(pattern, i);
+            if (i < 0) {
+                return {};
+            }
+            break;
+        }
+        case '[':
+            endRun();
+            i = skipClass(pattern, i);
+            if (i < 0) {
+                return {};
+            }
+            break;
+        case '*':
+        case '?':
+        case '{':
+            // The character before may not be there at all
+            run.chop(run.size() >= 2 && run.back().isLowSurrogate() ? 2 : 1);
+            endRun();
+            if (c == QChar('{')) {
+                i = pattern.indexOf(QChar('}'), i);
+                if (i < 0) {
+                    return {};
+                }
+            }
+            break;
+        case '+':
+        case '.':
+        case '^':
+        case '$':
+            endRun();
+            break;
+        default:
+            run += c;
+            break;
+        }
+    }
+    endRun();
+    return literals;
+}
+
+} // anonymous namespace
+
+int64_t ScrollbackStore::Block::storedBytes() const
+{
+    return compressed.size() + text.size() +
+           static_cast<int64_t>(offsets.size() * sizeof(uint32_t)) +
+           static_cast<int64_t>(timeDeltas.size() * sizeof(uint32_t)) +
+           static_cast<int64_t>(levels.size()) +
+           static_cast<int64_t>(bloom.size() * sizeof(uint64_t));
+}
+
+void ScrollbackStore::append(int64_t lineNumber, const QString& line, int64_t timestampMs)
+{
+    // A gap in numbering (the view was cleared) starts a new block, so
+    // line numbers within a block stay contiguous
+    if (!m_blocks.empty() && !m_blocks.back().sealed &&
+        lineNumber != m_blocks.back().firstLine + m_blocks.back().lineCount()) {
+        seal();
+    }
+
+    if (m_blocks.empty() || m_blocks.back().sealed) {
+        Block block;
+        block.id = m_nextBlockId++;
+        block.firstLine = lineNumber;
+        block.firstTimeMs = timestampMs;
+        block.lastTimeMs = timestampMs;
+        block.text.reserve(BLOCK_BYTES + 1024);
+        m_blocks.push_back(std::move(block));
+    }
+
+    Block& block = m_blocks.back();
+    QByteArray utf8 = line.toUtf8();
+    // Same parse as the views, so search and view filters agree
+    LogLevel level = LogLineParser::parse(line).level;
+
+    block.offsets.push_back(static_cast<uint32_t>(block.text.size()));
+    block.text.append(utf8);
+    block.text.append('\n');
+    block.timeDeltas.push_back(static_cast<uint32_t>(std::max<int64_t>(0, timestampMs - block.firstTimeMs)));
+    block.levels.push_back(level);
+    block.levelMask |= logLevelBit(level);
+    block.lastTimeMs = std::max(block.lastTimeMs, timestampMs);
+    block.rawSize += utf8.size() + 1;
+
+    ++m_lineCount;
+    m_rawBytes += utf8.size() + 1;
+
+    if (block.text.size() >= BLOCK_BYTES) {
+        seal();
+    }
+}
+
+void ScrollbackStore::clear()
+{
+    m_blocks.clear();
+    m_cache.clear();
+    m_lineCount = 0;
+    m_rawBytes = 0;
+    m_storedBytes = 0;
+}
+
+void ScrollbackStore::seal()
+{
+    if (m_blocks.empty() || m_blocks.back().sealed) {
+        return;
+    }
+
+    Block& block = m_blocks.back();
+    block.bloom.assign(BLOOM_BITS / 64, 0);
+    addTrigrams(block.bloom, block.text.toLower());
+
+    block.compressed = qCompress(block.text, COMPRESSION_LEVEL);
+    block.text = QByteArray();
+    block.sealed = true;
+    m_storedBytes += block.storedBytes();
+
+    while (m_storedBytes > MAX_BYTES && m_blocks.size() > 1) {
+        dropOldest();
+    }
+}
+
+void ScrollbackStore::dropOldest()
+{
+    const Block& block = m_blocks.front();
+    m_storedBytes -= block.storedBytes();
+    m_lineCount -= block.lineCount();
+    m_rawBytes -= block.rawSize;
+
+    uint64_t id = block.id;
+    m_cache.remove_if([id](const CachedText& cached) { return cached.id == id; });
+    m_blocks.pop_front();
+}
+
+const QByteArray& ScrollbackStore::blockText(const Block& block) const
+{
+    if (!block.sealed) {
+        return block.text;
+    }
+
+    for (auto it = m_cache.begin(); it != m_cache.end(); ++it) {
+        if (it->id == block.id) {
+            m_cache.splice(m_cache.begin(), m_cache, it);
+            return m_cache.front().text;
+        }
+    }
+
+    m_cache.push_front({block.id, qUncompress(block.compressed)});
+    if (m_cache.size() > CACHE_BLOCKS) {
+        m_cache.pop_back();
+    }
+    return m_cache.front().text;
+}
+
+void ScrollbackStore::addTrigrams(std::vector<uint64_t>& bloom, const QByteArray& lowered)
+{
+    const char* bytes = lowered.constData();
+    for (qsizetype i = 0; i + 3 <= lowered.size(); ++i) {
+        uint32_t first, second;
+        trigramBits(bytes + i, first, second);
+        bloom[first / 64] |= 1ULL << (first % 64);
+        bloom[second / 64] |= 1ULL << (second % 64);
+    }
+}
+
+bool ScrollbackStore::mayContain(const std::vector<uint64_t>& bloom, const QByteArray& lowered)
+{
+    const char* bytes = lowered.constData();
+    for (qsizetype i = 0; i + 3 <= lowered.size(); ++i) {
+        uint32_t first, second;
+        trigramBits(bytes + i, first, second);
+        if (!(bloom[first / 64] & (1ULL << (first % 64))) ||
+            !(bloom[second / 64] & (1ULL << (second % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ScrollbackStore::SearchResult ScrollbackStore::search(const Query& query) const
+{
+    SearchResult result;
+
+    QRegularExpression regex;
+    if (query.regex) {
+        regex = QRegularExpression(query.text, query.caseSensitive
+            ? QRegularExpression::NoPatternOption
+            : QRegularExpression::CaseInsensitiveOption);
+        if (!regex.isValid()) {
+            result.error = regex.errorString();
+            return result;
+        }
+    }
+
+    const QByteArray needle = query.text.toUtf8();
+    const QByteArray loweredNeedle = needle.toLower();
+    const bool substring = !query.regex && !needle.isEmpty();
+    const std::vector<QByteArray> regexLiterals =
+        query.regex ? requiredLiterals(query.text, query.caseSensitive) : std::vector<QByteArray>();
+
+    // Blocks are visited newest first so a capped result keeps the newest
+    for (auto it = m_blocks.rbegin(); it != m_blocks.rend(); ++it) {
+        const Block& block = *it;
+
+        if (block.lastTimeMs < query.fromMs || block.firstTimeMs > query.toMs ||
+            !(block.levelMask & query.levels)) {
+            ++result.blocksSkipped;
+            continue;
+        }
+        if (substring && block.sealed && !mayContain(block.bloom, loweredNeedle)) {
+            ++result.blocksSkipped;
+            continue;
+        }
+        if (block.sealed && std::any_of(regexLiterals.begin(), regexLiterals.end(),
+                                        [&block](const QByteArray& literal) {
+                                            return !mayContain(block.bloom, literal);
+                                        })) {
+            ++result.blocksSkipped;
+            continue;
+        }
+        ++result.blocksScanned;
+
+        const QByteArray& text = blockText(block);
+        const int count = block.lineCount();
+
+        auto lineEnd = [&](int i) -> qsizetype {
+            return (i + 1 < count ? block.offsets[i + 1] : text.size()) - 1;
+        };
+        auto timeOf = [&](int i) -> int64_t {
+            return block.firstTimeMs + block.timeDeltas[i];
+        };
+        auto wanted = [&](int i) -> bool {
+            int64_t time = timeOf(i);
+            return (logLevelBit(block.levels[i]) & query.levels) &&
+                   time >= query.fromMs && time <= query.toMs;
+        };
+        auto add = [&](int i) -> bool {
+            if (static_cast<int>(result.matches.size()) >= query.maxResults) {
+                result.truncated = true;
+                return false;
+            }
+            qsizetype start = block.offsets[i];
+            result.matches.push_back({block.firstLine + i, timeOf(i), block.levels[i],
+                                      QString::fromUtf8(text.mid(start, lineEnd(i) - start))});
+            return true;
+        };
+
+        if (substring) {
+            // Find hits in the whole block at once, then map them to lines
+            QByteArray lowered;
+            const QByteArray* haystack = &text;
+            const QByteArray* pattern = &needle;
+            if (!query.caseSensitive) {
+                lowered = text.toLower();
+                haystack = &lowered;
+                pattern = &loweredNeedle;
+            }
+
+            qsizetype from = haystack->size() - 1;
+            while (from >= 0) {
+                qsizetype hit = haystack->lastIndexOf(*pattern, from);
+                if (hit < 0) {
+                    break;
+                }
+
+                auto next = std::upper_bound(block.offsets.begin(), block.offsets.end(),
+                                             static_cast<uint32_t>(hit));
+                int line = static_cast<int>(next - block.offsets.begin()) - 1;
+                if (wanted(line) && !add(line)) {
+                    break;
+                }
+
+                // Other hits on the same line add nothing
+                from = static_cast<qsizetype>(block.offsets[line]) - 1;
+            }
+        } else {
+            for (int i = count - 1; i >= 0; --i) {
+                if (!wanted(i)) {
+                    continue;
+                }
+                if (query.regex) {
+                    qsizetype start = block.offsets[i];
+                    QString line = QString::fromUtf8(text.mid(start, lineEnd(i) - start));
+                    if (!regex.match(line).hasMatch()) {
+                        continue;
+                    }
+                }
+                if (!add(i)) {
+                    break;
+                }
+            }
+        }
+
+        if (result.truncated) {
+            break;
+        }
+    }
+
+    std::reverse(result.matches.begin(), result.matches.end());
+    return result;
+}
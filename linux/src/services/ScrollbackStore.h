@@ -0,0 +1,131 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef SCROLLBACKSTORE_H
+#define SCROLLBACKSTORE_H
+
+#include "models/LogLevel.h"
+
+#include <QByteArray>
+#include <QString>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <list>
+#include <vector>
+
+/**
+ * Long-term history of monitor lines, searchable without keeping it all
+ * as text in memory
+ *
+ * Lines are packed into blocks of about BLOCK_BYTES of UTF-8. A full block
+ * is compressed and keeps only a small index: per-line offset, timestamp
+ * and level, the set of levels it contains, its time range, and a bloom
+ * filter of its lowercased byte trigrams. A substring search skips every
+ * block whose filter lacks one of the query's trigrams and decompresses
+ * only the rest; a regex search does the same with the literal runs every
+ * match must contain (a regex without any, e.g. "a|b" or "\d+", scans
+ * every block). Oldest blocks are dropped once the store passes
+ * MAX_BYTES.
+ */
+class ScrollbackStore {
+public:
+    static constexpr int BLOCK_BYTES = 128 * 1024;
+    static constexpr int64_t MAX_BYTES = 96LL * 1024 * 1024;
+
+    /// 8 KB per block; about 1% false positives for a 5-character query
+    static constexpr int BLOOM_BITS = 64 * 1024;
+
+    struct Query {
+        QString text;
+        bool regex = false;
+        bool caseSensitive = false;
+        uint8_t levels = ALL_LOG_LEVELS;
+        int64_t fromMs = 0;
+        int64_t toMs = std::numeric_limits<int64_t>::max();
+
+        /// Newest matches are kept when there are more
+        int maxResults = 1000;
+    };
+
+    struct Match {
+        int64_t lineNumber;
+        int64_t timestampMs;
+        LogLevel level;
+        QString text;
+    };
+
+    struct SearchResult {
+        std::vector<Match> matches;     // Oldest first
+        bool truncated = false;         // More matches than maxResults
+        int blocksScanned = 0;
+        int blocksSkipped = 0;
+        QString error;                  // e.g. invalid regex
+    };
+
+    ScrollbackStore() = default;
+
+    /**
+     * Add a completed line
+     * @param lineNumber Absolute line number (see LineStore); increasing
+     */
+    void append(int64_t lineNumber, const QString& line, int64_t timestampMs);
+
+    void clear();
+
+    SearchResult search(const Query& query) const;
+
+    int64_t lineCount() const { return m_lineCount; }
+    int64_t rawBytes() const { return m_rawBytes; }
+
+    /**
+     * Memory held: compressed text plus indexes
+     */
+    int64_t storedBytes() const { return m_storedBytes; }
+
+private:
+    struct Block {
+        int64_t firstLine = 0;
+        int64_t firstTimeMs = 0;
+        int64_t lastTimeMs = 0;
+
+        // Line i is text[offsets[i], offsets[i + 1] - 1), '\n' separated
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> timeDeltas;   // ms after firstTimeMs
+        std::vector<LogLevel> levels;
+        uint8_t levelMask = 0;
+
+        QByteArray text;                    // Open block only
+        QByteArray compressed;              // Sealed blocks
+        std::vector<uint64_t> bloom;
+        uint64_t id = 0;
+        int64_t rawSize = 0;
+        bool sealed = false;
+
+        int lineCount() const { return static_cast<int>(levels.size()); }
+        int64_t storedBytes() const;
+    };
+
+    void seal();
+    void dropOldest();
+    const QByteArray& blockText(const Block& block) const;
+    static void addTrigrams(std::vector<uint64_t>& bloom, const QByteArray& lowered);
+    static bool mayContain(const std::vector<uint64_t>& bloom, const QByteArray& lowered);
+
+    std::deque<Block> m_blocks;
+    uint64_t m_nextBlockId = 1;
+    int64_t m_lineCount = 0;
+    int64_t m_rawBytes = 0;
+    int64_t m_storedBytes = 0;
+
+    // Recently decompressed blocks, most recent first
+    struct CachedText {
+        uint64_t id;
+        QByteArray text;
+    };
+    mutable std::list<CachedText> m_cache;
+    static constexpr size_t CACHE_BLOCKS = 4;
+};
+
+#endif // SCROLLBACKSTORE_H
@@ -0,0 +1,106 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "TimeoutEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+double TimeoutEstimator::wireTime(int bytes) const
+{
+    // 8N1: ten bits on the wire per byte
+    return (bytes * 10.0) / m_baudRate;
+}
+
+void TimeoutEstimator::addSample(double elapsed, int bytesSent)
+{
+    double rtt = std::max(0.0, elapsed - wireTime(bytesSent + RESPONSE_BYTES));
+
+    if (!m_hasSamples) {
+        m_srtt = rtt;
+        m_rttvar = rtt / 2.0;
+        m_hasSamples = true;
+    } else {
+        m_rttvar = 0.75 * m_rttvar + 0.25 * std::fabs(m_srtt - rtt);
+        m_srtt = 0.875 * m_srtt + 0.125 * rtt;
+    }
+
+    m_backoff = 1.0;
+}
+
+void TimeoutEstimator::backoff()
+{
+    m_backoff = std::min(m_backoff * 2.0, MAX_RTO / MIN_RTO);
+}
+
+double TimeoutEstimator::responseTimeout(int bytesSent) const
+{
+    double wire = wireTime(bytesSent + RESPONSE_BYTES);
+
+    if (!m_hasSamples) {
+        return wire + INITIAL_RTO;
+    }
+
+    double rto = std::clamp((m_srtt + 4.0 * m_rttvar) * m_backoff, MIN_RTO, MAX_RTO);
+    return wire + rto;
+}
+
+double TimeoutEstimator::eraseTimeout(uint32_t eraseSize, int bytesSent) const
+{
+    double erase;
+    if (m_eraseMsPerSector > 0.0) {
+        erase = sectorCount(eraseSize) * m_eraseMsPerSector * ERASE_SAFETY_FACTOR / 1000.0;
+    } else {
+        erase = sectorCount(eraseSize) * DEFAULT_ERASE_MS_PER_SECTOR / 1000.0;
+    }
+
+    return responseTimeout(bytesSent) + std::max(erase, MIN_ERASE_TIMEOUT);
+}
+
+double TimeoutEstimator::md5Timeout(uint32_t size, int bytesSent) const
+{
+    return responseTimeout(bytesSent) + MD5_SECONDS_PER_MB * size / (1024.0 * 1024.0);
+}
+
+double TimeoutEstimator::expectedRoundTrip(int bytesSent) const
+{
+    return wireTime(bytesSent + RESPONSE_BYTES) + (m_hasSamples ? m_srtt : TYPICAL_RTT);
+}
+
+double TimeoutEstimator::expectedEraseTime(uint32_t eraseSize) const
+{
+    // The uncalibrated rate is a worst case; typical parts are several times faster
+    double msPerSector = m_eraseMsPerSector > 0.0
+        ? m_eraseMsPerSector
+        : DEFAULT_ERASE_MS_PER_SECTOR / ERASE_SAFETY_FACTOR;
+    return sectorCount(eraseSize) * msPerSector / 1000.0;
+}
+
+double TimeoutEstimator::expectedMd5Time(uint32_t size) const
+{
+    return TYPICAL_MD5_SECONDS_PER_MB * size / (1024.0 * 1024.0);
+}
+
+void TimeoutEstimator::addEraseSample(double elapsed, uint32_t eraseSize, int bytesSent)
+{
+    int sectors = sectorCount(eraseSize);
+    if (sectors < MIN_CALIBRATION_SECTORS) {
+        return;
+    }
+
+    double overhead = wireTime(bytesSent + RESPONSE_BYTES) + (m_hasSamples ? m_srtt : 0.0);
+    double msPerSector = std::max(0.0, elapsed - overhead) * 1000.0 / sectors;
+
+    if (m_eraseMsPerSector <= 0.0) {
+        m_eraseMsPerSector = msPerSector;
+    } else {
+        m_eraseMsPerSector = (1.0 - ERASE_EWMA_WEIGHT) * m_eraseMsPerSector
+                             + ERASE_EWMA_WEIGHT * msPerSector;
+    }
+}
+
+int TimeoutEstimator::sectorCount(uint32_t eraseSize)
+{
+    return static_cast<int>((eraseSize + SECTOR_SIZE - 1) / SECTOR_SIZE);
+}
@@ -0,0 +1,140 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef TIMEOUTESTIMATOR_H
+#define TIMEOUTESTIMATOR_H
+
+#include <cstdint>
+
+/**
+ * Adaptive response timeouts for the ROM loader
+ *
+ * Command round trips are tracked with the TCP retransmission timer
+ * estimator (RFC 6298): a smoothed RTT plus four times its mean deviation.
+ * Samples have the serial wire time of the exchange subtracted first, so
+ * small register commands and full data blocks calibrate the same estimate
+ * and it carries over a baud rate change.
+ *
+ * FLASH_BEGIN erases the whole region before answering, so its timeout
+ * comes from an erase-time model instead: milliseconds per 4 KB sector,
+ * calibrated from observed erases with an exponentially weighted average.
+ */
+class TimeoutEstimator {
+public:
+    TimeoutEstimator() = default;
+
+    /**
+     * Set the current line rate used to compute wire time
+     */
+    void setBaudRate(int baudRate) { m_baudRate = baudRate; }
+
+    /**
+     * Time to transfer bytes at the current baud rate, in seconds
+     */
+    double wireTime(int bytes) const;
+
+    /**
+     * Record a successful round trip
+     * @param elapsed Seconds from write to the matching response
+     * @param bytesSent Encoded bytes written for the command
+     */
+    void addSample(double elapsed, int bytesSent);
+
+    /**
+     * Record a timed-out command; doubles the timeout until the next sample
+     */
+    void backoff();
+
+    /**
+     * Timeout for a command, in seconds
+     * @param bytesSent Encoded bytes written for the command
+     */
+    double responseTimeout(int bytesSent) const;
+
+    /**
+     * Timeout for a FLASH_BEGIN that erases eraseSize bytes, in seconds
+     */
+    double eraseTimeout(uint32_t eraseSize, int bytesSent) const;
+
+    /**
+     * Timeout for an SPI_FLASH_MD5 over size bytes, in seconds
+     */
+    double md5Timeout(uint32_t size, int bytesSent) const;
+
+    /**
+     * Expected (not worst-case) durations, for plan estimates, in seconds
+     */
+    double expectedRoundTrip(int bytesSent) const;
+    double expectedEraseTime(uint32_t eraseSize) const;
+    double expectedMd5Time(uint32_t size) const;
+
+    /**
+     * Calibrate the erase model from a completed FLASH_BEGIN
+     * @param elapsed Seconds from write to the matching response
+     */
+    void addEraseSample(double elapsed, uint32_t eraseSize, int bytesSent);
+
+    /**
+     * Calibrated erase rate (0 = not calibrated yet)
+     */
+    double eraseMsPerSector() const { return m_eraseMsPerSector; }
+
+    /**
+     * Seed the erase model, e.g. from a cached device profile
+     */
+    void setEraseMsPerSector(double msPerSector) { m_eraseMsPerSector = msPerSector; }
+
+    bool hasSamples() const { return m_hasSamples; }
+
+private:
+    static int sectorCount(uint32_t eraseSize);
+
+    int m_baudRate = 115200;
+
+    // RFC 6298 state, in seconds
+    bool m_hasSamples = false;
+    double m_srtt = 0.0;
+    double m_rttvar = 0.0;
+    double m_backoff = 1.0;
+
+    double m_eraseMsPerSector = 0.0;
+
+    // Timeout before any round trip has been measured (the previous
+    // fixed register command timeout)
+    static constexpr double INITIAL_RTO = 1.0;
+
+    // Floor and ceiling for measured timeouts. The floor absorbs USB
+    // scheduling jitter; the ceiling is the previous fixed block timeout.
+    static constexpr double MIN_RTO = 0.2;
+    static constexpr double MAX_RTO = 5.0;
+
+    // Response packet size including SLIP framing
+    static constexpr int RESPONSE_BYTES = 14;
+
+    static constexpr int SECTOR_SIZE = 4096;
+
+    // Uncalibrated erase rate: esptool's 30 s per MB worst case
+    static constexpr double DEFAULT_ERASE_MS_PER_SECTOR = 30000.0 / 256.0;
+
+    // Headroom over the calibrated erase rate, and the weight of a new sample
+    static constexpr double ERASE_SAFETY_FACTOR = 3.0;
+    static constexpr double ERASE_EWMA_WEIGHT = 0.3;
+
+    // The ROM hashes flash at well over 1 MB per 8 s (esptool's allowance)
+    static constexpr double MD5_SECONDS_PER_MB = 8.0;
+
+    // Typical round trip before any has been measured
+    static constexpr double TYPICAL_RTT = 0.01;
+
+    // Typical ROM MD5 throughput
+    static constexpr double TYPICAL_MD5_SECONDS_PER_MB = 1.0;
+
+    // Erases smaller than this are dominated by command overhead
+    static constexpr int MIN_CALIBRATION_SECTORS = 8;
+
+    // A single sector erase can take up to ~400 ms on slow flash parts
+    static constexpr double MIN_ERASE_TIMEOUT = 1.0;
+};
+
+#endif // TIMEOUTESTIMATOR_H
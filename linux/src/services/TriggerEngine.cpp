@@ -0,0 +1,261 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "TriggerEngine.h"
+
+#include <QSettings>
+#include <algorithm>
+#include <deque>
+
+namespace {
+
+// Crashes are always worth failing a test for
+const char* const kDefaultFailures[][2] = {
+    {"panic", "Guru Meditation Error"},
+    {"abort", "abort() was called"},
+    {"brownout", "Brownout detector was triggered"},
+    {"stack overflow", "***ERROR*** A stack overflow"},
+};
+
+} // anonymous namespace
+
+QString triggerActionName(TriggerAction action)
+{
+    switch (action) {
+    case TriggerAction::Pass: return "pass";
+    case TriggerAction::Fail: return "fail";
+    case TriggerAction::Mark: return "mark";
+    case TriggerAction::Reset: return "reset";
+    case TriggerAction::NextJob: return "next-job";
+    }
+    return "mark";
+}
+
+std::optional<TriggerAction> triggerActionFromName(const QString& name)
+{
+    if (name == "pass") return TriggerAction::Pass;
+    if (name == "fail") return TriggerAction::Fail;
+    if (name == "mark") return TriggerAction::Mark;
+    if (name == "reset") return TriggerAction::Reset;
+    if (name == "next-job") return TriggerAction::NextJob;
+    return std::nullopt;
+}
+
+std::vector<Trigger> TriggerEngine::configuredTriggers()
+{
+    std::vector<Trigger> triggers;
+
+    QSettings settings;
+    int count = settings.beginReadArray("Triggers");
+    for (int i = 0; i < count; ++i) {
+        settings.setArrayIndex(i);
+
+        auto action = triggerActionFromName(settings.value("action").toString());
+        QByteArray pattern = settings.value("pattern").toString().toUtf8();
+        if (!action || pattern.isEmpty()) {
+            continue;
+        }
+
+        Trigger trigger;
+        trigger.name = settings.value("name", QString::fromUtf8(pattern)).toString();
+        trigger.pattern = pattern;
+        trigger.regex = settings.value("regex").toString();
+        trigger.action = *action;
+        trigger.step = settings.value("step", trigger.name).toString();
+        triggers.push_back(trigger);
+    }
+    settings.endArray();
+
+    if (triggers.empty()) {
+        for (const auto& failure : kDefaultFailures) {
+            Trigger trigger;
+            trigger.name = failure[0];
+            trigger.pattern = failure[1];
+            trigger.action = TriggerAction::Fail;
+            trigger.step = "no crash";
+            triggers.push_back(trigger);
+        }
+    }
+    return triggers;
+}
+
+TriggerEngine::TriggerEngine(std::vector<Trigger> triggers)
+    : m_triggers(std::move(triggers))
+{
+    for (Trigger& trigger : m_triggers) {
+        if (trigger.step.isEmpty()) {
+            trigger.step = trigger.name;
+        }
+
+        m_regexes.emplace_back();
+        if (!trigger.regex.isEmpty()) {
+            m_regexes.back() = QRegularExpression(trigger.regex);
+            m_hasRegex = true;
+        }
+
+        if (trigger.action == TriggerAction::Pass &&
+            std::find(m_passSteps.begin(), m_passSteps.end(), trigger.step) == m_passSteps.end()) {
+            m_passSteps.push_back(trigger.step);
+        }
+    }
+
+    build();
+}
+
+void TriggerEngine::build()
+{
+    // Columns: one per distinct pattern byte, plus column 0 for the rest
+    for (const Trigger& trigger : m_triggers) {
+        for (char c : trigger.pattern) {
+            uint8_t byte = static_cast<uint8_t>(c);
+            if (m_byteClass[byte] == 0) {
+                m_byteClass[byte] = static_cast<uint16_t>(m_classCount++);
+            }
+        }
+    }
+
+    // 1. Trie of the patterns; -1 is a missing edge
+    const size_t columns = static_cast<size_t>(m_classCount);
+    m_next.assign(columns, -1);
+    std::vector<std::vector<int32_t>> own(1);
+
+    for (size_t i = 0; i < m_triggers.size(); ++i) {
+        const QByteArray& pattern = m_triggers[i].pattern;
+        if (pattern.isEmpty()) {
+            continue;
+        }
+
+        int32_t state = 0;
+        for (char c : pattern) {
+            size_t edge = state * columns + m_byteClass[static_cast<uint8_t>(c)];
+            if (m_next[edge] < 0) {
+                m_next[edge] = static_cast<int32_t>(own.size());
+                own.emplace_back();
+                m_next.resize(m_next.size() + columns, -1);
+            }
+            state = m_next[edge];
+        }
+        own[state].push_back(static_cast<int32_t>(i));
+    }
+
+    // 2. Breadth-first: fill missing edges from the failure state (always
+    // shallower, so already complete) and inherit its matches
+    const size_t stateCount = own.size();
+    std::vector<int32_t> fail(stateCount, 0);
+    std::vector<std::vector<int32_t>> matches(stateCount);
+    std::deque<int32_t> queue;
+
+    for (size_t c = 0; c < columns; ++c) {
+        int32_t child = m_next[c];
+        if (child < 0) {
+            m_next[c] = 0;
+        } else {
+            queue.push_back(child);
+        }
+    }
+    matches[0] = own[0];
+
+    while (!queue.empty()) {
+        int32_t state = queue.front();
+        queue.pop_front();
+
+        matches[state] = own[state];
+        const std::vector<int32_t>& inherited = matches[fail[state]];
+        matches[state].insert(matches[state].end(), inherited.begin(), inherited.end());
+
+        for (size_t c = 0; c < columns; ++c) {
+            size_t edge = state * columns + c;
+            int32_t child = m_next[edge];
+            int32_t fallback = m_next[fail[state] * columns + c];
+            if (child < 0) {
+                m_next[edge] = fallback;
+            } else {
+                fail[child] = fallback;
+                queue.push_back(child);
+            }
+        }
+    }
+
+    // 3. Flatten the match lists
+    m_outputStart.reserve(stateCount + 1);
+    for (const std::vector<int32_t>& list : matches) {
+        m_outputStart.push_back(static_cast<int32_t>(m_outputs.size()));
+        m_outputs.insert(m_outputs.end(), list.begin(), list.end());
+    }
+    m_outputStart.push_back(static_cast<int32_t>(m_outputs.size()));
+}
+
+TriggerScanner::TriggerScanner(std::shared_ptr<const TriggerEngine> engine)
+    : m_engine(std::move(engine))
+{
+}
+
+void TriggerScanner::feed(const char* data, size_t size, int64_t timestampNs,
+                          std::vector<TriggerHit>& hits)
+{
+    if (!m_engine || m_engine->isEmpty()) {
+        return;
+    }
+
+    const TriggerEngine& engine = *m_engine;
+    const bool keepLines = engine.m_hasRegex;
+    const int32_t* outputStart = engine.m_outputStart.data();
+    int state = m_state;
+    size_t lineStart = 0;
+
+    for (size_t i = 0; i < size; ++i) {
+        const uint8_t byte = static_cast<uint8_t>(data[i]);
+        state = engine.next(state, byte);
+
+        for (int32_t k = outputStart[state]; k < outputStart[state + 1]; ++k) {
+            const int trigger = engine.m_outputs[k];
+            if (engine.m_triggers[trigger].regex.isEmpty()) {
+                hits.push_back(TriggerHit{trigger, timestampNs});
+            } else if (std::find(m_pendingRegex.begin(), m_pendingRegex.end(), trigger) ==
+                       m_pendingRegex.end()) {
+                m_pendingRegex.push_back(trigger);
+            }
+        }
+
+        if (keepLines && byte == '\n') {
+            completeLine(data + lineStart, i - lineStart, timestampNs, hits);
+            lineStart = i + 1;
+        }
+    }
+
+    m_state = state;
+
+    if (keepLines && m_line.size() < MAX_LINE_BYTES) {
+        size_t room = MAX_LINE_BYTES - m_line.size();
+        m_line.append(data + lineStart, static_cast<int>(std::min(size - lineStart, room)));
+    }
+}
+
+void TriggerScanner::reset()
+{
+    m_state = 0;
+    m_line.clear();
+    m_pendingRegex.clear();
+}
+
+void TriggerScanner::completeLine(const char* tail, size_t tailSize, int64_t timestampNs,
+                                  std::vector<TriggerHit>& hits)
+{
+    if (!m_pendingRegex.empty()) {
+        size_t room = MAX_LINE_BYTES - std::min<size_t>(m_line.size(), MAX_LINE_BYTES);
+        m_line.append(tail, static_cast<int>(std::min(tailSize, room)));
+        if (m_line.endsWith('\r')) {
+            m_line.chop(1);
+        }
+
+        const QString line = QString::fromUtf8(m_line);
+        for (int trigger : m_pendingRegex) {
+            if (m_engine->m_regexes[trigger].match(line).hasMatch()) {
+                hits.push_back(TriggerHit{trigger, timestampNs});
+            }
+        }
+        m_pendingRegex.clear();
+    }
+    m_line.clear();
+}
@@ -0,0 +1,142 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef TRIGGERENGINE_H
+#define TRIGGERENGINE_H
+
+#include <QByteArray>
+#include <QRegularExpression>
+#include <QString>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+/**
+ * What a trigger does when its pattern shows up
+ */
+enum class TriggerAction {
+    Pass,       // Mark the trigger's test step passed
+    Fail,       // Mark the trigger's test step failed
+    Mark,       // Record when it happened
+    Reset,      // Reset the device
+    NextJob     // Start the next flash job
+};
+
+QString triggerActionName(TriggerAction action);
+std::optional<TriggerAction> triggerActionFromName(const QString& name);
+
+/**
+ * A pattern to look for in device output, and what to do about it
+ */
+struct Trigger {
+    QString name;
+    QByteArray pattern;     // Raw bytes, matched anywhere in the stream
+    QString regex;          // Optional: the whole line must also match this
+    TriggerAction action = TriggerAction::Mark;
+    QString step;           // Test step for Pass/Fail; defaults to name
+};
+
+/**
+ * Matches every trigger pattern in one pass over raw bytes
+ *
+ * The patterns are compiled into an Aho-Corasick automaton, flattened to
+ * a full transition table so each input byte costs one table lookup
+ * whatever the number of patterns. Bytes that appear in no pattern share
+ * one column, which keeps the table small. The engine is immutable once
+ * built and shared by the TriggerScanner of every port.
+ */
+class TriggerEngine {
+public:
+    explicit TriggerEngine(std::vector<Trigger> triggers);
+
+    /**
+     * Triggers from the QSettings array "Triggers" (keys name, pattern,
+     * regex, action, step), or the built-in crash detectors
+     */
+    static std::vector<Trigger> configuredTriggers();
+
+    const std::vector<Trigger>& triggers() const { return m_triggers; }
+    bool isEmpty() const { return m_triggers.empty(); }
+
+    /**
+     * Steps some Pass trigger can complete; all of them passing is a pass
+     */
+    const std::vector<QString>& passSteps() const { return m_passSteps; }
+
+    int stateCount() const { return static_cast<int>(m_outputStart.size()) - 1; }
+
+private:
+    friend class TriggerScanner;
+
+    int next(int state, uint8_t byte) const {
+        return m_next[static_cast<size_t>(state) * m_classCount + m_byteClass[byte]];
+    }
+
+    void build();
+
+    std::vector<Trigger> m_triggers;
+    std::vector<QRegularExpression> m_regexes;     // Per trigger; empty if none
+    std::vector<QString> m_passSteps;
+    bool m_hasRegex = false;
+
+    // Byte -> column; column 0 is every byte no pattern uses
+    std::array<uint16_t, 256> m_byteClass{};
+    int m_classCount = 1;
+
+    // Transition table, states x columns
+    std::vector<int32_t> m_next;
+
+    // Triggers matched on entering a state: m_outputs[m_outputStart[s] ..
+    // m_outputStart[s + 1]), including those of its suffix states
+    std::vector<int32_t> m_outputStart;
+    std::vector<int32_t> m_outputs;
+};
+
+/**
+ * A trigger that fired
+ */
+struct TriggerHit {
+    int trigger;            // Index into TriggerEngine::triggers()
+    int64_t timestampNs;    // Arrival of the bytes that completed it
+};
+
+/**
+ * One stream's position in a shared TriggerEngine
+ *
+ * Keeps the automaton state between chunks, so patterns split across
+ * reads still match. Triggers with a regex are held until their line is
+ * complete and fire only if the line matches.
+ */
+class TriggerScanner {
+public:
+    /// Longest line kept for regex post-filters
+    static constexpr int MAX_LINE_BYTES = 4096;
+
+    TriggerScanner() = default;
+    explicit TriggerScanner(std::shared_ptr<const TriggerEngine> engine);
+
+    const TriggerEngine* engine() const { return m_engine.get(); }
+
+    /**
+     * Scan bytes that arrived at timestampNs; fired triggers are appended
+     */
+    void feed(const char* data, size_t size, int64_t timestampNs, std::vector<TriggerHit>& hits);
+
+    void reset();
+
+private:
+    void completeLine(const char* tail, size_t tailSize, int64_t timestampNs,
+                      std::vector<TriggerHit>& hits);
+
+    std::shared_ptr<const TriggerEngine> m_engine;
+    int m_state = 0;
+
+    // Only kept when some trigger has a regex
+    QByteArray m_line;
+    std::vector<int> m_pendingRegex;
+};
+
+#endif // TRIGGERENGINE_H
@@ -27,6 +27,9 @@ FlasherWidget::FlasherWidget(QWidget* parent)
     connect(m_flashingService, &FlashingService::stateChanged,
             this, &FlasherWidget::onFlashingStateChanged);
 
+    connect(m_flashingService, &FlashingService::reportReady,
+            this, &FlasherWidget::onFlashReport);
+
     // Start port monitoring
     m_portManager->startObserving();
 
@@ -182,14 +185,8 @@ void FlasherWidget::refreshPorts()
 {
     m_portComboBox->blockSignals(true);
 
-    // Remember current selection path, or use last selected path for auto-reconnect
-    QString targetPath;
-    if (m_selectedPort) {
-        targetPath = m_selectedPort->path;
-    } else if (!m_lastSelectedPortPath.isEmpty()) {
-        // Try to reconnect to the last selected port
-        targetPath = m_lastSelectedPortPath;
-    }
+    // Remember current selection, or use last selected port for auto-reconnect
+    std::optional<SerialPort> target = m_selectedPort ? m_selectedPort : m_lastSelectedPort;
 
     m_portComboBox->clear();
     m_portComboBox->addItem("Select port...", QVariant());
@@ -205,7 +202,7 @@ void FlasherWidget::refreshPorts()
         }
         m_portComboBox->addItem(displayText, port.path);
 
-        if (port.path == targetPath) {
+        if (newIndex == 0 && target && port.isSameDevice(*target)) {
             newIndex = static_cast<int>(i) + 1;
         }
     }
@@ -215,11 +212,11 @@ void FlasherWidget::refreshPorts()
 
     // Update selected port
     if (newIndex > 0 && static_cast<size_t>(newIndex - 1) < ports.size()) {
+        // Follow the device to the node it is on now
         m_selectedPort = ports[newIndex - 1];
+        m_lastSelectedPort = m_selectedPort;
         // Emit portChanged if we auto-reconnected to a previously disconnected port
-        if (!targetPath.isEmpty() && m_selectedPort->path == targetPath) {
-            emit portChanged(*m_selectedPort);
-        }
+        emit portChanged(*m_selectedPort);
     } else {
         m_selectedPort.reset();
     }
@@ -233,10 +230,10 @@ void FlasherWidget::onPortSelectionChanged(int index)
 
     if (index <= 0 || static_cast<size_t>(index - 1) >= ports.size()) {
         m_selectedPort.reset();
-        // Don't clear m_lastSelectedPortPath - keep it for auto-reconnect
+        // Don't clear m_lastSelectedPort - keep it for auto-reconnect
     } else {
         m_selectedPort = ports[index - 1];
-        m_lastSelectedPortPath = m_selectedPort->path;  // Save for auto-reconnect
+        m_lastSelectedPort = m_selectedPort;  // Save for auto-reconnect
         emit portChanged(*m_selectedPort);
     }
 
@@ -317,6 +314,15 @@ void FlasherWidget::startFlashing()
     m_flashingService->flash(*m_firmwareFile, *m_selectedPort, m_selectedBaudRate);
 }
 
+void FlasherWidget::startNextJob(const SerialPort& port)
+{
+    if (!m_selectedPort || !m_selectedPort->isSameDevice(port) || m_flashingService->isFlashing()) {
+        return;
+    }
+
+    startFlashing();
+}
+
 void FlasherWidget::cancelFlashing()
 {
     m_flashingService->cancel();
@@ -340,6 +346,9 @@ void FlasherWidget::onFlashingStateChanged(FlashingState state)
     } else if (state.type == FlashingStateType::Complete) {
         m_progressBar->setValue(100);
         m_percentLabel->setText("100%");
+        if (m_selectedPort && m_firmwareFile) {
+            emit firmwareFlashed(*m_selectedPort, m_firmwareFile->elfPath());
+        }
         emit flashingFinished();
     } else if (state.type == FlashingStateType::Idle) {
         m_progressBar->setValue(0);
@@ -349,6 +358,13 @@ void FlasherWidget::onFlashingStateChanged(FlashingState state)
     }
 }
 
+void FlasherWidget::onFlashReport(const FlashReport& report)
+{
+    // Retries don't change the outcome, but show up on hover so that
+    // marginal cables and fixtures can be spotted
+    m_statusWidget->setToolTip(report.summary());
+}
+
 void FlasherWidget::onSerialMonitorToggled(bool checked)
 {
     emit serialMonitorToggled(checked);
@@ -8,6 +8,7 @@
 #include "models/SerialPort.h"
 #include "models/FirmwareFile.h"
 #include "models/FlashingState.h"
+#include "models/FlashReport.h"
 #include "serial/SerialPortManager.h"
 #include "services/FlashingService.h"
 
@@ -31,12 +32,27 @@ public:
     explicit FlasherWidget(QWidget* parent = nullptr);
     ~FlasherWidget();
 
+    SerialPortManager* portManager() const { return m_portManager; }
+    FlashingService* flashingService() const { return m_flashingService; }
+
+public slots:
+    /**
+     * Flash the selected firmware again, if port is the selected port and
+     * nothing is being flashed (next board on the same fixture)
+     */
+    void startNextJob(const SerialPort& port);
+
 signals:
     void serialMonitorToggled(bool enabled);
     void portChanged(const SerialPort& port);
     void flashingStarted();
     void flashingFinished();
 
+    /**
+     * Firmware was written to port; elfPath is its ELF, if one was found
+     */
+    void firmwareFlashed(const SerialPort& port, const QString& elfPath);
+
 private slots:
     void refreshPorts();
     void onPortSelectionChanged(int index);
@@ -45,6 +61,7 @@ private slots:
     void startFlashing();
     void cancelFlashing();
     void onFlashingStateChanged(FlashingState state);
+    void onFlashReport(const FlashReport& report);
     void onSerialMonitorToggled(bool checked);
 
 private:
@@ -75,8 +92,9 @@ private:
     std::optional<FirmwareFile> m_firmwareFile;
     FlashingState m_currentState;
 
-    // Auto-reconnect: remember last selected port path to reconnect after reset
-    QString m_lastSelectedPortPath;
+    // Auto-reconnect: remember last selected port to reconnect after reset;
+    // matched by device, as it may come back on another node
+    std::optional<SerialPort> m_lastSelectedPort;
 };
 
 #endif // FLASHERWIDGET_H
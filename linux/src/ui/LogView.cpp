@@ -0,0 +1,406 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "LogView.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QFontMetrics>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+
+#include <algorithm>
+
+LogView::LogView(QWidget* parent)
+    : QAbstractScrollArea(parent)
+{
+    setFocusPolicy(Qt::StrongFocus);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    viewport()->setCursor(Qt::IBeamCursor);
+    m_lines.setLineCompleteHandler([this](int64_t lineNumber, const QString& line) {
+        onLineComplete(lineNumber, line);
+    });
+    updateScrollBars();
+}
+
+void LogView::appendText(const QString& text)
+{
+    if (text.isEmpty()) {
+        return;
+    }
+
+    QScrollBar* vbar = verticalScrollBar();
+    bool atBottom = vbar->value() >= vbar->maximum();
+    int firstVisible = vbar->value();
+
+    int dropped = m_lines.append(text);
+    if (dropped > 0) {
+        m_info.erase(m_info.begin(), m_info.begin() + std::min<size_t>(dropped, m_info.size()));
+        if (m_filtered) {
+            const size_t rows = m_rows.size();
+            while (!m_rows.empty() && m_rows.front() < m_lines.firstLineNumber()) {
+                m_rows.pop_front();
+            }
+            dropped = static_cast<int>(rows - m_rows.size());
+        }
+    }
+    updateScrollBars();
+
+    // Follow the tail, or keep the same lines on screen while the head shrinks
+    vbar->setValue(atBottom ? vbar->maximum() : std::max(0, firstVisible - dropped));
+    viewport()->update();
+}
+
+void LogView::clear()
+{
+    m_lines.clear();
+    m_info.clear();
+    m_rows.clear();
+    m_stats.clear();
+    m_tagFilterId = LogStats::NO_TAG;
+    m_anchor = m_cursor = TextPos{m_lines.firstLineNumber(), 0};
+    updateScrollBars();
+    viewport()->update();
+}
+
+void LogView::setPlaceholderText(const QString& text)
+{
+    m_placeholder = text;
+    viewport()->update();
+}
+
+QString LogView::selectedText() const
+{
+    if (!hasSelection()) {
+        return QString();
+    }
+
+    TextPos start = std::min(m_anchor, m_cursor);
+    TextPos end = std::max(m_anchor, m_cursor);
+
+    // Part of the selection may have been trimmed away already
+    const int64_t first = m_lines.firstLineNumber();
+    if (start.line < first) {
+        start = TextPos{first, 0};
+    }
+    end.line = std::min(end.line, first + m_lines.lineCount() - 1);
+
+    // Lines the filter hides aren't copied
+    QString text;
+    bool firstLine = true;
+    for (int64_t line = start.line; line <= end.line; ++line) {
+        const size_t index = static_cast<size_t>(line - first);
+        if (m_filtered && (index >= m_info.size() || !matches(m_info[index]))) {
+            continue;
+        }
+        if (!firstLine) {
+            text += '\n';
+        }
+        firstLine = false;
+
+        const QString& content = m_lines.line(static_cast<int>(index));
+        int from = line == start.line ? start.column : 0;
+        int to = line == end.line ? end.column : static_cast<int>(content.size());
+        text += content.mid(from, to - from);
+    }
+    return text;
+}
+
+void LogView::copy() const
+{
+    if (hasSelection()) {
+        QApplication::clipboard()->setText(selectedText());
+    }
+}
+
+void LogView::selectAll()
+{
+    if (rowCount() == 0) {
+        return;
+    }
+
+    int first = lineIndex(0);
+    int last = lineIndex(rowCount() - 1);
+    m_anchor = TextPos{m_lines.firstLineNumber() + first, 0};
+    m_cursor = TextPos{m_lines.firstLineNumber() + last, static_cast<int>(m_lines.line(last).size())};
+    viewport()->update();
+}
+
+bool LogView::revealLine(int64_t lineNumber)
+{
+    const int row = rowOf(lineNumber);
+    if (row < 0) {
+        return false;
+    }
+
+    const int line = lineIndex(row);
+    m_anchor = TextPos{lineNumber, 0};
+    m_cursor = TextPos{lineNumber, static_cast<int>(m_lines.line(line).size())};
+
+    // Center it, which also stops following the tail
+    verticalScrollBar()->setValue(std::max(0, row - visibleLineCount() / 2));
+    horizontalScrollBar()->setValue(0);
+    viewport()->update();
+    return true;
+}
+
+void LogView::setFilter(uint8_t levels, const QString& tag)
+{
+    m_levelFilter = levels;
+    m_tagFilter = tag;
+    m_tagFilterId = tag.isEmpty() ? LogStats::NO_TAG : m_stats.tagId(tag);
+    m_filtered = levels != ALL_LOG_LEVELS || !tag.isEmpty();
+    rebuildRows();
+
+    updateScrollBars();
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    viewport()->update();
+}
+
+void LogView::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(viewport());
+    QPalette pal = palette();
+    painter.fillRect(viewport()->rect(), pal.color(QPalette::Base));
+    painter.setFont(font());
+
+    QFontMetrics metrics(font());
+    const int ascent = metrics.ascent();
+
+    if (rowCount() == 0) {
+        painter.setPen(pal.color(QPalette::PlaceholderText));
+        painter.drawText(MARGIN, MARGIN + ascent,
+                         m_filtered && m_lines.lineCount() > 0 ? "No lines match the filter" : m_placeholder);
+        return;
+    }
+
+    const int first = verticalScrollBar()->value();
+    const int last = std::min(first + visibleLineCount() + 1, rowCount());
+    const int x = MARGIN - horizontalScrollBar()->value();
+    const int width = viewport()->width();
+
+    TextPos selStart = std::min(m_anchor, m_cursor);
+    TextPos selEnd = std::max(m_anchor, m_cursor);
+    const bool selection = hasSelection();
+
+    for (int row = first; row < last; ++row) {
+        const int index = lineIndex(row);
+        const QString& text = m_lines.line(index);
+        const int64_t lineNumber = m_lines.firstLineNumber() + index;
+        const int y = (row - first) * m_lineHeight;
+
+        painter.setPen(pal.color(QPalette::Text));
+        painter.drawText(x, y + ascent, text);
+
+        if (!selection || lineNumber < selStart.line || lineNumber > selEnd.line) {
+            continue;
+        }
+
+        // Repaint the selected columns on top, clipped to the highlight
+        int from = lineNumber == selStart.line ? selStart.column : 0;
+        int to = lineNumber == selEnd.line ? selEnd.column : static_cast<int>(text.size()) + 1;
+        int left = x + from * m_charWidth;
+        int right = lineNumber == selEnd.line ? x + to * m_charWidth : width;
+        if (right <= left) {
+            continue;
+        }
+
+        QRect highlight(left, y, right - left, m_lineHeight);
+        painter.save();
+        painter.setClipRect(highlight);
+        painter.fillRect(highlight, pal.color(QPalette::Highlight));
+        painter.setPen(pal.color(QPalette::HighlightedText));
+        painter.drawText(x, y + ascent, text);
+        painter.restore();
+    }
+}
+
+void LogView::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+
+    QScrollBar* vbar = verticalScrollBar();
+    bool atBottom = vbar->value() >= vbar->maximum();
+    updateScrollBars();
+    if (atBottom) {
+        vbar->setValue(vbar->maximum());
+    }
+}
+
+void LogView::keyPressEvent(QKeyEvent* event)
+{
+    if (event->matches(QKeySequence::Copy)) {
+        copy();
+        return;
+    }
+    if (event->matches(QKeySequence::SelectAll)) {
+        selectAll();
+        return;
+    }
+
+    QScrollBar* vbar = verticalScrollBar();
+    switch (event->key()) {
+    case Qt::Key_Home:
+        vbar->setValue(0);
+        return;
+    case Qt::Key_End:
+        vbar->setValue(vbar->maximum());
+        return;
+    default:
+        QAbstractScrollArea::keyPressEvent(event);
+    }
+}
+
+void LogView::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton) {
+        QAbstractScrollArea::mousePressEvent(event);
+        return;
+    }
+
+    m_anchor = m_cursor = posAt(event->pos());
+    m_selecting = true;
+    viewport()->update();
+}
+
+void LogView::mouseMoveEvent(QMouseEvent* event)
+{
+    if (!m_selecting) {
+        return;
+    }
+
+    m_cursor = posAt(event->pos());
+    viewport()->update();
+}
+
+void LogView::mouseReleaseEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton) {
+        m_selecting = false;
+    }
+}
+
+void LogView::mouseDoubleClickEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton || rowCount() == 0) {
+        return;
+    }
+
+    // Select the whole line
+    TextPos pos = posAt(event->pos());
+    const QString& text = m_lines.line(static_cast<int>(pos.line - m_lines.firstLineNumber()));
+    m_anchor = TextPos{pos.line, 0};
+    m_cursor = TextPos{pos.line, static_cast<int>(text.size())};
+    viewport()->update();
+}
+
+void LogView::onLineComplete(int64_t lineNumber, const QString& line)
+{
+    // Parsed where it's stored; the record is only spans of the line
+    const LogRecord record = LogLineParser::parse(line);
+    const int tag = m_stats.count(line, record);
+    m_info.push_back(LineInfo{record.level, tag});
+
+    if (m_filtered) {
+        if (!m_tagFilter.isEmpty() && m_tagFilterId == LogStats::NO_TAG) {
+            m_tagFilterId = m_stats.tagId(m_tagFilter);
+        }
+        if (matches(m_info.back())) {
+            m_rows.push_back(lineNumber);
+        }
+    }
+
+    if (m_onLineComplete) {
+        m_onLineComplete(lineNumber, line);
+    }
+}
+
+bool LogView::matches(const LineInfo& info) const
+{
+    if (!(logLevelBit(info.level) & m_levelFilter)) {
+        return false;
+    }
+    return m_tagFilter.isEmpty() || (m_tagFilterId != LogStats::NO_TAG && info.tag == m_tagFilterId);
+}
+
+void LogView::rebuildRows()
+{
+    m_rows.clear();
+    if (!m_filtered) {
+        return;
+    }
+
+    const int64_t first = m_lines.firstLineNumber();
+    for (size_t i = 0; i < m_info.size(); ++i) {
+        if (matches(m_info[i])) {
+            m_rows.push_back(first + static_cast<int64_t>(i));
+        }
+    }
+}
+
+int LogView::rowCount() const
+{
+    return m_filtered ? static_cast<int>(m_rows.size()) : m_lines.lineCount();
+}
+
+int LogView::lineIndex(int row) const
+{
+    return m_filtered ? static_cast<int>(m_rows[row] - m_lines.firstLineNumber()) : row;
+}
+
+int LogView::rowOf(int64_t lineNumber) const
+{
+    if (m_filtered) {
+        auto it = std::lower_bound(m_rows.begin(), m_rows.end(), lineNumber);
+        return it != m_rows.end() && *it == lineNumber ? static_cast<int>(it - m_rows.begin()) : -1;
+    }
+
+    const int64_t index = lineNumber - m_lines.firstLineNumber();
+    return index >= 0 && index < m_lines.lineCount() ? static_cast<int>(index) : -1;
+}
+
+void LogView::updateScrollBars()
+{
+    QFontMetrics metrics(font());
+    m_lineHeight = std::max(1, metrics.lineSpacing());
+    m_charWidth = std::max(1, metrics.horizontalAdvance(QChar('M')));
+
+    const int visible = visibleLineCount();
+    QScrollBar* vbar = verticalScrollBar();
+    vbar->setRange(0, std::max(0, rowCount() - visible));
+    vbar->setPageStep(visible);
+    vbar->setSingleStep(1);
+
+    // The monitor uses a fixed-pitch font, so width is columns x advance
+    QScrollBar* hbar = horizontalScrollBar();
+    const int contentWidth = m_lines.longestLine() * m_charWidth + 2 * MARGIN;
+    hbar->setRange(0, std::max(0, contentWidth - viewport()->width()));
+    hbar->setPageStep(viewport()->width());
+    hbar->setSingleStep(m_charWidth);
+}
+
+int LogView::visibleLineCount() const
+{
+    return std::max(1, viewport()->height() / m_lineHeight);
+}
+
+LogView::TextPos LogView::posAt(const QPoint& point) const
+{
+    if (rowCount() == 0) {
+        return TextPos{m_lines.firstLineNumber(), 0};
+    }
+
+    int row = verticalScrollBar()->value() + std::max(0, point.y()) / m_lineHeight;
+    const int index = lineIndex(std::clamp(row, 0, rowCount() - 1));
+
+    int column = (point.x() + horizontalScrollBar()->value() - MARGIN + m_charWidth / 2) / m_charWidth;
+    column = std::clamp(column, 0, static_cast<int>(m_lines.line(index).size()));
+
+    return TextPos{m_lines.firstLineNumber() + index, column};
+}
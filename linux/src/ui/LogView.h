@@ -0,0 +1,149 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef LOGVIEW_H
+#define LOGVIEW_H
+
+#include "models/LineStore.h"
+#include "models/LogLevel.h"
+#include "services/LogLineParser.h"
+
+#include <QAbstractScrollArea>
+#include <QString>
+#include <cstdint>
+#include <deque>
+
+/**
+ * Read-only, append-only text view for device output
+ *
+ * Only the lines inside the viewport are painted, one drawText per line,
+ * so appending and scrolling cost the same with 10 lines or 100000.
+ * Follows the tail while scrolled to the bottom; otherwise the visible
+ * text and the selection stay put as lines arrive and the head is trimmed.
+ *
+ * Every completed line is parsed as an ESP-IDF log line once, leaving a
+ * level and tag id per line and counts per tag, so filtering on them is a
+ * scan over small integers rather than over the text.
+ */
+class LogView : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    explicit LogView(QWidget* parent = nullptr);
+
+    void appendText(const QString& text);
+    void clear();
+
+    void setPlaceholderText(const QString& text);
+
+    /**
+     * Selected text, lines joined with '\n'
+     */
+    QString selectedText() const;
+
+    void copy() const;
+    void selectAll();
+
+    const LineStore& lines() const { return m_lines; }
+
+    void setLineCompleteHandler(LineStore::LineHandler handler) {
+        m_onLineComplete = std::move(handler);
+    }
+
+    /**
+     * Scroll to and select a line by absolute number
+     * @return false if the line is no longer (or not yet) in the view, or
+     *         is hidden by the filter
+     */
+    bool revealLine(int64_t lineNumber);
+
+    /**
+     * Show only completed lines of the given levels (LogLevel bits) and,
+     * unless tag is empty, with that tag
+     */
+    void setFilter(uint8_t levels, const QString& tag = QString());
+
+    uint8_t levelFilter() const { return m_levelFilter; }
+    const QString& tagFilter() const { return m_tagFilter; }
+    bool isFiltered() const { return m_filtered; }
+
+    /**
+     * Lines per level and tag since the last clear()
+     */
+    const LogStats& stats() const { return m_stats; }
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+
+private:
+    /**
+     * Position in the text by absolute line number, so it survives trims
+     */
+    struct TextPos {
+        int64_t line = 0;
+        int column = 0;
+
+        bool operator<(const TextPos& other) const {
+            return line < other.line || (line == other.line && column < other.column);
+        }
+        bool operator==(const TextPos& other) const {
+            return line == other.line && column == other.column;
+        }
+    };
+
+    /**
+     * What the filter needs of a completed line
+     */
+    struct LineInfo {
+        LogLevel level;
+        int tag;
+    };
+
+    void onLineComplete(int64_t lineNumber, const QString& line);
+    bool matches(const LineInfo& info) const;
+    void rebuildRows();
+
+    // Rows are what is on screen: every line, or the matching ones
+    int rowCount() const;
+    int lineIndex(int row) const;
+    int rowOf(int64_t lineNumber) const;
+
+    void updateScrollBars();
+    int visibleLineCount() const;
+    TextPos posAt(const QPoint& point) const;
+    bool hasSelection() const { return !(m_anchor == m_cursor); }
+
+    LineStore m_lines;
+    QString m_placeholder;
+    LineStore::LineHandler m_onLineComplete;
+
+    // One per completed line, from m_lines.firstLineNumber()
+    std::deque<LineInfo> m_info;
+    LogStats m_stats;
+
+    uint8_t m_levelFilter = ALL_LOG_LEVELS;
+    QString m_tagFilter;
+    int m_tagFilterId = LogStats::NO_TAG;   // NO_TAG until the tag is seen
+    bool m_filtered = false;
+
+    // Line numbers of the matching lines while filtered
+    std::deque<int64_t> m_rows;
+
+    int m_lineHeight = 1;
+    int m_charWidth = 1;
+
+    TextPos m_anchor;
+    TextPos m_cursor;
+    bool m_selecting = false;
+
+    static constexpr int MARGIN = 4;
+};
+
+#endif // LOGVIEW_H
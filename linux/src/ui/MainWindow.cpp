@@ -47,6 +47,8 @@ void MainWindow::setupUi()
 
     // Serial monitor widget (initially hidden)
     m_serialMonitorWidget = new SerialMonitorWidget(m_splitter);
+    m_serialMonitorWidget->setPortManager(m_flasherWidget->portManager());
+    m_serialMonitorWidget->setFlashingService(m_flasherWidget->flashingService());
     m_serialMonitorWidget->hide();
     m_splitter->addWidget(m_serialMonitorWidget);
 
@@ -63,6 +65,13 @@ void MainWindow::setupUi()
             m_serialMonitorWidget, &SerialMonitorWidget::onFlashingStarted);
     connect(m_flasherWidget, &FlasherWidget::flashingFinished,
             m_serialMonitorWidget, &SerialMonitorWidget::onFlashingFinished);
+    connect(m_flasherWidget, &FlasherWidget::firmwareFlashed,
+            m_serialMonitorWidget, &SerialMonitorWidget::onFirmwareFlashed);
+
+    // Triggers on the monitor stream can start the next job; queued so
+    // the monitor has finished with the line that fired it
+    connect(m_serialMonitorWidget, &SerialMonitorWidget::nextJobRequested,
+            m_flasherWidget, &FlasherWidget::startNextJob, Qt::QueuedConnection);
 
     // Set initial splitter sizes
     m_splitter->setStretchFactor(0, 1);
@@ -0,0 +1,621 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#include "PortMonitor.h"
+
+#include <QDateTime>
+#include <QFile>
+
+PortMonitor::PortMonitor(const SerialPort& port, SerialReader& reader, QWidget* viewParent)
+    : m_port(port)
+    , m_reader(reader)
+    , m_coreDumps(port.serialNumber.isEmpty() ? port.name : port.serialNumber)
+{
+    m_view = new LogView(viewParent);
+    m_view->setFont(QFont("Monospace", 9));
+    m_view->setStyleSheet(
+        "background-color: white; color: #333333; border: none;"
+    );
+    m_view->setPlaceholderText("No output yet...");
+
+    // Every completed line also goes to the searchable history and on to
+    // the merged view
+    m_view->setLineCompleteHandler([this](int64_t lineNumber, const QString& line) {
+        m_scrollback.append(lineNumber, line, wallClockMs(m_appendTimestampNs));
+        m_bootProfiler.feedLine(m_appendTimestampNs, line);
+        if (m_symbolizer && !m_annotating) {
+            annotateLine(line);
+        }
+        if (m_lineHandler) {
+            m_lineHandler(m_appendTimestampNs, line);
+        }
+    });
+
+    // Retries an open that failed on a node that is there (busy, not yet
+    // accessible); a node that is gone is left to udev
+    m_retryTimer = new QTimer(this);
+    m_retryTimer->setSingleShot(true);
+    m_retryTimer->setInterval(OPEN_RETRY_MS);
+    connect(m_retryTimer, &QTimer::timeout, this, &PortMonitor::openPort);
+}
+
+PortMonitor::~PortMonitor()
+{
+    m_retryTimer->stop();
+    stopReading();
+    stopCapture();
+
+    // The view calls back into this object
+    delete m_view;
+}
+
+QString PortMonitor::tag() const
+{
+    return m_port.serialNumber.isEmpty()
+        ? m_port.displayName()
+        : QString("%1 %2").arg(m_port.displayName(), m_port.serialNumber);
+}
+
+int64_t PortMonitor::wallClockMs(int64_t timestampNs)
+{
+    // steady_clock has no fixed epoch; pin it to the wall clock once so
+    // timestamps stay monotonic even if the system time is changed
+    static const int64_t offsetMs =
+        QDateTime::currentMSecsSinceEpoch() - SerialReader::now() / 1000000;
+    return offsetMs + timestampNs / 1000000;
+}
+
+void PortMonitor::connectToPort()
+{
+    m_openAttempts = 0;
+    openPort();
+}
+
+void PortMonitor::openPort()
+{
+    if (m_isFlashing) {
+        return;
+    }
+
+    stopReading();
+    m_retryTimer->stop();
+    m_waitingForPort = false;
+    ++m_openAttempts;
+
+    m_connection = std::make_unique<SerialConnection>();
+    m_connection->setFlowControl(PortSettings::forPort(m_port).effectiveFlowControl());
+
+    try {
+        m_connection->open(m_port.path);
+        applyBaudRate();
+
+        appendNote(QString("[Connected to %1]\n").arg(m_port.name));
+        startReading();
+    } catch (const SerialError& e) {
+        appendNote(QString("[Connection failed: %1]\n")
+                       .arg(QString::fromStdString(e.what())));
+        stopReading();
+        emit connectionChanged(false);
+
+        // A replug is announced by udev whatever happens here
+        m_waitingForPort = true;
+        if (!QFile::exists(m_port.path)) {
+            appendNote(QString("[Waiting for %1 to come back...]\n").arg(m_port.name));
+        } else if (m_openAttempts < MAX_OPEN_ATTEMPTS) {
+            appendNote(QString("[Retrying (%1 of %2)...]\n").arg(m_openAttempts).arg(MAX_OPEN_ATTEMPTS - 1));
+            m_retryTimer->start();
+        }
+    }
+}
+
+void PortMonitor::disconnectFromPort()
+{
+    stopReading();
+    m_retryTimer->stop();
+    m_waitingForPort = false;
+    m_connection.reset();
+    emit connectionChanged(false);
+}
+
+std::unique_ptr<SerialConnection> PortMonitor::releaseForFlash()
+{
+    m_isFlashing = true;
+    m_wasConnectedBeforeFlash = isConnected();
+    m_retryTimer->stop();
+    m_waitingForPort = false;
+
+    if (!m_wasConnectedBeforeFlash) {
+        return nullptr;
+    }
+
+    // Stop reading but leave the port open for the flasher
+    m_reader.removePort(m_portId);
+    m_portId = 0;
+    appendNote(m_decoder.flush());
+    appendNote("[Port handed to the flasher]\n");
+    emit connectionChanged(false);
+
+    return std::move(m_connection);
+}
+
+void PortMonitor::resumeAfterFlash(std::unique_ptr<SerialConnection> connection)
+{
+    m_isFlashing = false;
+
+    if (!m_wasConnectedBeforeFlash) {
+        return;
+    }
+
+    // Same fd, so nothing printed since the reset is lost
+    if (connection && connection->isConnected()) {
+        m_connection = std::move(connection);
+        try {
+            appendNote(QString("[Port back from the flasher]\n"));
+            applyBaudRate();
+            startReading();
+            return;
+        } catch (const SerialError& e) {
+            appendNote(QString("[Connection failed: %1]\n")
+                           .arg(QString::fromStdString(e.what())));
+            stopReading();
+        }
+    }
+
+    // The device re-enumerated; its udev event brings it back
+    reconnectWhenPresent();
+}
+
+void PortMonitor::onPortAdded(const SerialPort& port)
+{
+    if (!m_port.isSameDevice(port)) {
+        return;
+    }
+
+    // Came back while the flasher still held the old node; remember
+    // where, so the handback finds it
+    if (m_isFlashing) {
+        m_port = port;
+        return;
+    }
+
+    if (m_waitingForPort && !isConnected()) {
+        m_port = port;
+        connectToPort();
+    }
+}
+
+bool PortMonitor::startCapture()
+{
+    QString deviceId = m_port.serialNumber.isEmpty() ? m_port.name : m_port.serialNumber;
+    auto compression = LogCapture::zstdAvailable() ? LogCapture::Compression::Zstd
+                                                   : LogCapture::Compression::None;
+
+    if (!m_capture.start(deviceId, compression)) {
+        appendNote(QString("[Capture failed: %1]\n").arg(m_capture.errorString()));
+        return false;
+    }
+
+    if (m_portId != 0) {
+        m_reader.addSink(m_portId, &m_capture);
+    }
+    appendNote(QString("[Capturing to %1]\n").arg(m_capture.currentFile()));
+    return true;
+}
+
+void PortMonitor::stopCapture()
+{
+    if (!m_capture.isRunning()) {
+        return;
+    }
+
+    if (m_portId != 0) {
+        m_reader.removeSink(m_portId, &m_capture);
+    }
+    m_capture.stop();
+
+    QString error = m_capture.errorString();
+    appendNote(error.isEmpty()
+        ? QString("[Capture stopped: %1 bytes]\n").arg(m_capture.bytesCaptured())
+        : QString("[Capture stopped: %1]\n").arg(error));
+}
+
+void PortMonitor::appendNote(const QString& text)
+{
+    appendAt(SerialReader::now(), text);
+}
+
+void PortMonitor::clear()
+{
+    m_view->clear();
+    m_scrollback.clear();
+    clearVerdict();
+}
+
+void PortMonitor::drain()
+{
+    if (m_portId == 0) {
+        return;
+    }
+
+    // Characters and color codes split across reads are completed by the
+    // next chunk; triggers see the raw bytes
+    for (const SerialReader::Chunk& chunk : m_reader.take(m_portId)) {
+        if (m_baudRate == AUTO_BAUD && !m_autoBaud.feed(chunk.timestampNs, chunk.data)) {
+            continue;
+        }
+        m_bootProfiler.feedBytes(chunk.timestampNs);
+        m_triggers.feed(chunk.data.constData(), static_cast<size_t>(chunk.data.size()),
+                        chunk.timestampNs, m_hits);
+        appendAt(chunk.timestampNs, m_decoder.decode(m_ansi.strip(chunk.data)));
+    }
+
+    if (m_baudRate == AUTO_BAUD) {
+        pollAutoBaud();
+    }
+    annotateHeldLines();
+
+    // After the text, so a note follows the line that fired it
+    for (const TriggerHit& hit : m_hits) {
+        handleTrigger(hit);
+    }
+    m_hits.clear();
+
+    m_bootProfiler.poll(SerialReader::now());
+    reportBoots();
+    reportCoreDumps();
+    reportLineErrors();
+
+    uint64_t dropped = m_reader.droppedBytes(m_portId);
+    if (dropped > m_reportedDrops) {
+        appendNote(QString("\n[%1 bytes dropped]\n").arg(dropped - m_reportedDrops));
+        m_reportedDrops = dropped;
+    }
+
+    if (m_reader.hasFailed(m_portId)) {
+        int error = m_reader.errorCode(m_portId);
+        appendNote(m_decoder.flush());
+        appendNote(QString("[Disconnected: %1]\n")
+                       .arg(SerialError::errorDescription(SerialError::ReadFailed, error)));
+        stopReading();
+        emit connectionChanged(false);
+
+        if (!m_isFlashing) {
+            reconnectWhenPresent();
+        }
+    }
+}
+
+void PortMonitor::setTriggerEngine(std::shared_ptr<const TriggerEngine> engine)
+{
+    m_triggers = TriggerScanner(std::move(engine));
+    clearVerdict();
+}
+
+PortMonitor::Verdict PortMonitor::verdict() const
+{
+    bool allPassed = !m_steps.empty();
+    for (const auto& step : m_steps) {
+        if (!step.second) {
+            return Verdict::Fail;
+        }
+    }
+
+    // Every step a Pass trigger exists for has to have passed
+    if (const TriggerEngine* engine = m_triggers.engine()) {
+        for (const QString& step : engine->passSteps()) {
+            if (m_steps.find(step) == m_steps.end()) {
+                allPassed = false;
+            }
+        }
+        allPassed = allPassed && !engine->passSteps().empty();
+    }
+    return allPassed ? Verdict::Pass : Verdict::Running;
+}
+
+void PortMonitor::clearVerdict()
+{
+    m_steps.clear();
+    m_runStartNs = SerialReader::now();
+    emit verdictChanged();
+}
+
+void PortMonitor::markReset(int64_t timestampNs, bool newRun)
+{
+    m_bootProfiler.markReset(timestampNs);
+    if (newRun) {
+        clearVerdict();
+        m_runStartNs = timestampNs;
+    }
+
+    // The ROM and the app may well print at different rates
+    if (m_baudRate == AUTO_BAUD && m_portId != 0) {
+        applyBaudRate();
+    }
+}
+
+void PortMonitor::handleTrigger(const TriggerHit& hit)
+{
+    const Trigger& trigger = m_triggers.engine()->triggers()[hit.trigger];
+    const qint64 sinceMs = (hit.timestampNs - m_runStartNs) / 1000000;
+
+    switch (trigger.action) {
+    case TriggerAction::Pass:
+    case TriggerAction::Fail: {
+        // A failed step stays failed for the rest of the run
+        bool passed = trigger.action == TriggerAction::Pass;
+        auto it = m_steps.find(trigger.step);
+        if (it != m_steps.end() && (!it->second || passed == it->second)) {
+            return;
+        }
+        m_steps[trigger.step] = passed;
+        appendNote(QString("[Step '%1' %2 at +%3 ms]\n")
+                       .arg(trigger.step, passed ? "PASSED" : "FAILED")
+                       .arg(sinceMs));
+        emit verdictChanged();
+        break;
+    }
+
+    case TriggerAction::Mark:
+        appendNote(QString("[Mark '%1' at %2, +%3 ms]\n")
+                       .arg(trigger.name,
+                            QDateTime::fromMSecsSinceEpoch(wallClockMs(hit.timestampNs))
+                                .toString("HH:mm:ss.zzz"))
+                       .arg(sinceMs));
+        break;
+
+    case TriggerAction::Reset:
+        // The fixture owns reset when RTS is the flow control line
+        if (m_connection && m_connection->flowControl() == FlowControl::RtsCts) {
+            appendNote(QString("[Trigger '%1': not resetting, RTS is used for flow control]\n")
+                           .arg(trigger.name));
+            break;
+        }
+        appendNote(QString("[Trigger '%1': resetting device]\n").arg(trigger.name));
+        resetDevice();
+        break;
+
+    case TriggerAction::NextJob:
+        appendNote(QString("[Trigger '%1': next job]\n").arg(trigger.name));
+        emit nextJobRequested();
+        break;
+    }
+}
+
+void PortMonitor::resetDevice()
+{
+    if (!m_connection || !m_connection->isConnected()) {
+        return;
+    }
+
+    if (m_connection->flowControl() == FlowControl::RtsCts) {
+        return;
+    }
+
+    try {
+        m_connection->hardReset();
+        markReset(SerialReader::now(), false);
+    } catch (const SerialError& e) {
+        appendNote(QString("[Reset failed: %1]\n").arg(QString::fromStdString(e.what())));
+    }
+}
+
+void PortMonitor::reportBoots()
+{
+    for (const BootProfiler::Boot& boot : m_bootProfiler.takeFinished()) {
+        appendNote(QString("[Boot: %1]\n").arg(boot.summary(m_bootProfiler.milestones())));
+    }
+}
+
+void PortMonitor::setBaudRate(int rate)
+{
+    if (rate == m_baudRate) {
+        return;
+    }
+    m_baudRate = rate;
+
+    if (m_connection && m_connection->isConnected() && !m_isFlashing) {
+        applyBaudRate();
+    }
+}
+
+void PortMonitor::applyBaudRate()
+{
+    try {
+        if (m_baudRate == AUTO_BAUD) {
+            m_autoBaud.start();
+            switchBaudRate();
+            appendNote("[Detecting baud rate...]\n");
+        } else {
+            m_connection->setBaudRate(m_baudRate);
+            m_lineErrorBase.reset();
+        }
+    } catch (const SerialError& e) {
+        appendNote(QString("[Cannot set %1 baud: %2]\n")
+                       .arg(m_baudRate == AUTO_BAUD ? m_autoBaud.rate() : m_baudRate)
+                       .arg(QString::fromStdString(e.what())));
+    }
+}
+
+void PortMonitor::switchBaudRate()
+{
+    // Anything read before this is from the old rate; the detector drops it
+    m_connection->setBaudRate(m_autoBaud.rate());
+    m_lineErrorBase.reset();
+    m_autoBaud.beginWindow(SerialReader::now(), m_connection->errorCounters());
+}
+
+void PortMonitor::pollAutoBaud()
+{
+    const bool wasDetecting = m_autoBaud.isDetecting();
+    try {
+        if (m_autoBaud.poll(SerialReader::now(), m_connection->errorCounters())) {
+            switchBaudRate();
+        }
+    } catch (const SerialError& e) {
+        appendNote(QString("[Cannot set %1 baud: %2]\n")
+                       .arg(m_autoBaud.rate()).arg(QString::fromStdString(e.what())));
+    }
+
+    if (wasDetecting && !m_autoBaud.isDetecting()) {
+        appendNote(QString("[Baud rate %1: %2]\n")
+                       .arg(m_autoBaud.rate()).arg(m_autoBaud.describeLastDetection()));
+
+        // What the winning window heard, so the lines that settled it show
+        const QByteArray bytes = m_autoBaud.takeWinningBytes();
+        const int64_t now = SerialReader::now();
+        if (!bytes.isEmpty()) {
+            m_bootProfiler.feedBytes(now);
+        }
+        m_triggers.feed(bytes.constData(), static_cast<size_t>(bytes.size()), now, m_hits);
+        appendAt(now, m_decoder.decode(m_ansi.strip(bytes)));
+    } else if (!wasDetecting && m_autoBaud.isDetecting()) {
+        appendNote(m_decoder.flush());
+        appendNote("\n[Output garbled; detecting baud rate...]\n");
+    }
+}
+
+void PortMonitor::reportCoreDumps()
+{
+    const uint64_t started = m_coreDumps.dumpsStarted();
+    if (started > m_reportedDumpStarts) {
+        m_reportedDumpStarts = started;
+        appendNote("[Receiving core dump...]\n");
+    }
+
+    for (const CoreDump& dump : m_coreDumps.takeFinished()) {
+        appendNote(dump.summary().join('\n') + '\n');
+    }
+}
+
+void PortMonitor::reportLineErrors()
+{
+    // Framing errors are how detection rules a rate out; they're not news
+    if (!m_connection || (m_baudRate == AUTO_BAUD && m_autoBaud.isDetecting())) {
+        m_lineErrorBase.reset();
+        return;
+    }
+
+    const int64_t now = SerialReader::now();
+    if (now - m_lineErrorCheckNs < LINE_ERROR_CHECK_NS) {
+        return;
+    }
+    m_lineErrorCheckNs = now;
+
+    std::optional<SerialErrorCounters> counters = m_connection->errorCounters();
+    if (!counters) {
+        return;
+    }
+    if (m_lineErrorBase) {
+        const QString errors = counters->since(*m_lineErrorBase).describe();
+        if (!errors.isEmpty()) {
+            appendNote(QString("[UART errors: %1]\n").arg(errors));
+        }
+    }
+    m_lineErrorBase = counters;
+}
+
+void PortMonitor::appendAt(int64_t timestampNs, const QString& text)
+{
+    // Only the new text is laid out; the view trims its own head
+    m_appendTimestampNs = timestampNs;
+    m_view->appendText(text);
+
+    // Not from inside the view's line callback, and only between lines
+    if (!m_annotations.isEmpty() && text.endsWith('\n')) {
+        appendAnnotations();
+    }
+}
+
+void PortMonitor::setSymbolizer(std::shared_ptr<ElfSymbolizer> symbolizer)
+{
+    m_symbolizer = std::move(symbolizer);
+    m_annotations.clear();
+    m_unannotated.clear();
+    m_symbolErrorReported = false;
+    if (m_symbolizer) {
+        m_symbolizer->loadInBackground();
+    }
+}
+
+void PortMonitor::annotateLine(const QString& line)
+{
+    // Lines that may hold addresses wait while the index is built
+    if (!m_symbolizer->isReady()) {
+        if (m_unannotated.size() < MAX_UNANNOTATED_LINES && line.contains(QLatin1String("0x"))) {
+            m_unannotated.append(line);
+        }
+        return;
+    }
+
+    m_annotations.append(m_symbolizer->annotate(line));
+    if (!m_symbolErrorReported && !m_symbolizer->errorString().isEmpty()) {
+        m_annotations.append(QString("[No symbols: %1]").arg(m_symbolizer->errorString()));
+        m_symbolErrorReported = true;
+    }
+}
+
+void PortMonitor::annotateHeldLines()
+{
+    if (!m_symbolizer || m_unannotated.isEmpty() || !m_symbolizer->isReady()) {
+        return;
+    }
+
+    // Their annotations follow the next complete line
+    const QStringList lines = std::move(m_unannotated);
+    m_unannotated.clear();
+    for (const QString& line : lines) {
+        annotateLine(line);
+    }
+}
+
+void PortMonitor::appendAnnotations()
+{
+    QString text;
+    for (const QString& annotation : m_annotations) {
+        text += "  " + annotation + '\n';
+    }
+    m_annotations.clear();
+
+    m_annotating = true;
+    m_view->appendText(text);
+    m_annotating = false;
+}
+
+void PortMonitor::startReading()
+{
+    m_reportedDrops = 0;
+    m_ansi.reset();
+    m_decoder.reset();
+    m_lineErrorBase.reset();
+    m_portId = m_reader.addPort(m_connection->fileDescriptor());
+    m_reader.addSink(m_portId, &m_coreDumps);
+    if (m_capture.isRunning()) {
+        m_reader.addSink(m_portId, &m_capture);
+    }
+    emit connectionChanged(true);
+}
+
+void PortMonitor::reconnectWhenPresent()
+{
+    if (QFile::exists(m_port.path)) {
+        connectToPort();
+        return;
+    }
+
+    appendNote(QString("[Waiting for %1 to come back...]\n").arg(m_port.name));
+    m_waitingForPort = true;
+}
+
+void PortMonitor::stopReading()
+{
+    // The reader must let go of the fd before the port is closed
+    if (m_portId != 0) {
+        m_reader.removePort(m_portId);
+        m_portId = 0;
+    }
+
+    if (m_connection) {
+        m_connection->close();
+    }
+}
@@ -0,0 +1,250 @@
+// FAME Smart Flasher - Linux Qt Port
+// Copyright 2025 Fyrby Additive Manufacturing & Engineering
+// SPDX-License-Identifier: Proprietary
+
+#ifndef PORTMONITOR_H
+#define PORTMONITOR_H
+
+#include "models/SerialPort.h"
+#include "serial/AutoBaudDetector.h"
+#include "serial/PortSettings.h"
+#include "serial/SerialConnection.h"
+#include "serial/SerialReader.h"
+#include "serial/Utf8StreamDecoder.h"
+#include "services/BootProfiler.h"
+#include "services/CoreDumpCapture.h"
+#include "services/ElfSymbolizer.h"
+#include "services/LogCapture.h"
+#include "services/LogLineParser.h"
+#include "services/ScrollbackStore.h"
+#include "services/TriggerEngine.h"
+#include "ui/LogView.h"
+
+#include <QObject>
+#include <QTimer>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+
+/**
+ * One monitored port: its connection, its tab and its history
+ *
+ * Reading is done by the SerialReader shared by every port; drain() moves
+ * this port's share of it into the view once per frame. Each completed
+ * line is also handed to the line handler with the monotonic time it
+ * arrived, which is how the merged view orders output across ports.
+ */
+class PortMonitor : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * Outcome of the test steps the triggers have seen so far
+     */
+    enum class Verdict {
+        Running,    // Nothing failed, not every step has passed yet
+        Pass,
+        Fail
+    };
+
+    /// Called with each completed line and when its last byte arrived
+    using LineHandler = std::function<void(int64_t timestampNs, const QString& line)>;
+
+    PortMonitor(const SerialPort& port, SerialReader& reader, QWidget* viewParent);
+    ~PortMonitor();
+
+    const SerialPort& port() const { return m_port; }
+
+    /**
+     * Port and device identity, e.g. "ttyUSB0 A50285BI"
+     */
+    QString tag() const;
+
+    LogView* view() const { return m_view; }
+    ScrollbackStore& scrollback() { return m_scrollback; }
+    LogCapture& capture() { return m_capture; }
+    BootProfiler& bootProfiler() { return m_bootProfiler; }
+
+    void setLineHandler(LineHandler handler) { m_lineHandler = std::move(handler); }
+
+    /**
+     * Watch this port's output for the engine's triggers
+     */
+    void setTriggerEngine(std::shared_ptr<const TriggerEngine> engine);
+
+    /**
+     * Annotate code addresses in this port's output (backtraces, register
+     * dumps) with function and source line; nullptr turns it off
+     */
+    void setSymbolizer(std::shared_ptr<ElfSymbolizer> symbolizer);
+
+    Verdict verdict() const;
+
+    /**
+     * Forget step results and marks; a new test run starts now
+     */
+    void clearVerdict();
+
+    /**
+     * The device was reset at timestampNs; starts boot timing, and a new
+     * test run if it was reflashed
+     */
+    void markReset(int64_t timestampNs, bool newRun);
+
+    bool isConnected() const { return m_portId != 0; }
+
+    /// setBaudRate() value that detects the rate
+    static constexpr int AUTO_BAUD = 0;
+
+    /**
+     * Rate to read at, or AUTO_BAUD; applied at once if connected
+     */
+    void setBaudRate(int rate);
+    int baudRate() const { return m_baudRate; }
+
+    /**
+     * Opened by the user rather than following the flasher's selection
+     */
+    bool isPinned() const { return m_pinned; }
+    void setPinned(bool pinned) { m_pinned = pinned; }
+
+    void connectToPort();
+    void disconnectFromPort();
+
+    /**
+     * Stop reading and hand the open port over for flashing
+     * @return The connection (nullptr if not connected)
+     */
+    std::unique_ptr<SerialConnection> releaseForFlash();
+
+    /**
+     * Take the port back after flashing
+     * Keeps reading on the returned connection without a reopen; if the
+     * port was lost (USB re-enumeration), reconnects when it reappears.
+     */
+    void resumeAfterFlash(std::unique_ptr<SerialConnection> connection);
+
+    /**
+     * A port appeared; reconnects if it is this one and we are waiting
+     */
+    void onPortAdded(const SerialPort& port);
+
+    bool startCapture();
+    void stopCapture();
+
+    /**
+     * Status line in this port's output, e.g. "[Connected to ttyUSB0]"
+     */
+    void appendNote(const QString& text);
+
+    void clear();
+
+    /**
+     * Move what the reader has buffered for this port into the view
+     */
+    void drain();
+
+    /**
+     * Wall-clock milliseconds for a SerialReader timestamp
+     */
+    static int64_t wallClockMs(int64_t timestampNs);
+
+signals:
+    void connectionChanged(bool connected);
+    void verdictChanged();
+
+    /**
+     * A NextJob trigger fired
+     */
+    void nextJobRequested();
+
+private:
+    void appendAt(int64_t timestampNs, const QString& text);
+    void reportBoots();
+    void reportCoreDumps();
+    void reportLineErrors();
+    void appendAnnotations();
+    void annotateLine(const QString& line);
+    void annotateHeldLines();
+    void handleTrigger(const TriggerHit& hit);
+    void resetDevice();
+    void applyBaudRate();
+    void switchBaudRate();
+    void pollAutoBaud();
+    void startReading();
+    void stopReading();
+
+    /**
+     * Reconnect now if the device node is there, else wait for udev
+     */
+    void reconnectWhenPresent();
+
+    /**
+     * One open attempt; connectToPort() starts a fresh series
+     */
+    void openPort();
+
+    SerialPort m_port;
+    SerialReader& m_reader;
+
+    LogView* m_view = nullptr;
+    ScrollbackStore m_scrollback;
+    LineHandler m_lineHandler;
+
+    // When the bytes being appended arrived; stamps completed lines
+    int64_t m_appendTimestampNs = 0;
+
+    BootProfiler m_bootProfiler;
+
+    // Symbolized addresses wait for the line they belong to to finish
+    std::shared_ptr<ElfSymbolizer> m_symbolizer;
+    QStringList m_annotations;
+    bool m_annotating = false;
+
+    // Lines seen while the symbol index was still being built
+    QStringList m_unannotated;
+    static constexpr int MAX_UNANNOTATED_LINES = 256;
+    bool m_symbolErrorReported = false;
+
+    TriggerScanner m_triggers;
+    std::vector<TriggerHit> m_hits;
+
+    // Test step results (true = passed) since the run started
+    std::map<QString, bool> m_steps;
+    int64_t m_runStartNs = 0;
+
+    // Raw capture to disk; must outlive its registration with the reader
+    LogCapture m_capture;
+
+    // Core dumps are picked out and decoded off the GUI thread
+    CoreDumpCapture m_coreDumps;
+    uint64_t m_reportedDumpStarts = 0;
+
+    std::unique_ptr<SerialConnection> m_connection;
+    int m_baudRate = 115200;
+    AutoBaudDetector m_autoBaud;
+    int m_portId = 0;
+    AnsiStripper m_ansi;
+
+    // Driver line error counts as of the last check; reset when the rate
+    // changes, since switching garbles a few bytes by itself
+    std::optional<SerialErrorCounters> m_lineErrorBase;
+    int64_t m_lineErrorCheckNs = 0;
+    static constexpr int64_t LINE_ERROR_CHECK_NS = 1000LL * 1000 * 1000;
+
+    Utf8StreamDecoder m_decoder;
+    uint64_t m_reportedDrops = 0;
+
+    bool m_waitingForPort = false;
+
+    QTimer* m_retryTimer = nullptr;
+    int m_openAttempts = 0;
+    static constexpr int OPEN_RETRY_MS = 1000;
+    static constexpr int MAX_OPEN_ATTEMPTS = 5;
+    bool m_isFlashing = false;
+    bool m_wasConnectedBeforeFlash = false;
+    bool m_pinned = false;
+};
+
+#endif // PORTMONITOR_H
@@ -5,55 +5,41 @@
 #include "SerialMonitorWidget.h"
 
 #include <QVBoxLayout>
+#include <QDialog>
+#include <QPlainTextEdit>
+#include <QSettings>
 #include <QHBoxLayout>
-#include <QScrollBar>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QShortcut>
+#include <QTabBar>
+
+#include <algorithm>
+#include <cmath>
 
 SerialMonitorWidget::SerialMonitorWidget(QWidget* parent)
     : QWidget(parent)
+    , m_triggerEngine(std::make_shared<TriggerEngine>(TriggerEngine::configuredTriggers()))
 {
     setupUi();
 
-    // Timer for batching text updates (100ms)
-    m_updateTimer = new QTimer(this);
-    m_updateTimer->setInterval(100);
-    connect(m_updateTimer, &QTimer::timeout, this, [this]() {
-        if (!m_pendingText.isEmpty()) {
-            QString text = m_pendingText;
-            m_pendingText.clear();
-
-            QString currentText = m_outputText->toPlainText();
-            currentText += text;
-
-            // Limit buffer size
-            if (currentText.size() > MAX_OUTPUT_SIZE) {
-                currentText = currentText.right(TRIM_TO_SIZE);
-            }
-
-            m_outputText->setPlainText(currentText);
-
-            // Scroll to bottom
-            QScrollBar* scrollBar = m_outputText->verticalScrollBar();
-            scrollBar->setValue(scrollBar->maximum());
-        }
-    });
-    m_updateTimer->start();
-
-    // Timer for reading serial data
-    m_readTimer = new QTimer(this);
-    m_readTimer->setInterval(50);
-    connect(m_readTimer, &QTimer::timeout, this, &SerialMonitorWidget::processIncomingData);
-
-    // Timer for reconnection attempts
-    m_reconnectTimer = new QTimer(this);
-    m_reconnectTimer->setInterval(2000);
-    connect(m_reconnectTimer, &QTimer::timeout, this, &SerialMonitorWidget::onReconnectTimer);
+    // Reads happen on the reader thread; the GUI only picks up the
+    // buffered output once per frame
+    m_drainTimer = new QTimer(this);
+    m_drainTimer->setInterval(FRAME_INTERVAL_MS);
+    connect(m_drainTimer, &QTimer::timeout, this, &SerialMonitorWidget::drainIncomingData);
+    m_drainTimer->start();
 }
 
 SerialMonitorWidget::~SerialMonitorWidget()
 {
-    stopReading();
-    m_updateTimer->stop();
-    m_reconnectTimer->stop();
+    m_drainTimer->stop();
+
+    // Their views live in the tab widget, which goes before the members
+    m_primary = nullptr;
+    m_monitors.clear();
+    m_reader.stop();
 }
 
 void SerialMonitorWidget::setupUi()
@@ -73,8 +59,38 @@ void SerialMonitorWidget::setupUi()
     m_titleLabel->setStyleSheet("font-weight: bold; font-size: 11px;");
     headerLayout->addWidget(m_titleLabel);
 
+    headerLayout->addSpacing(8);
+
+    // Lines per level so far, e.g. "E 3  W 12  I 480"
+    m_countsLabel = new QLabel(this);
+    m_countsLabel->setStyleSheet("color: #666666; font-size: 11px;");
+    headerLayout->addWidget(m_countsLabel);
+
     headerLayout->addStretch();
 
+    // What the current tab shows
+    m_viewLevelCombo = new QComboBox(this);
+    m_viewLevelCombo->setToolTip("Show lines of these levels");
+    m_viewLevelCombo->addItem("All lines", ALL_LOG_LEVELS);
+    m_viewLevelCombo->addItem("Errors", logLevelBit(LogLevel::Error));
+    m_viewLevelCombo->addItem("Warnings+", logLevelBit(LogLevel::Error) | logLevelBit(LogLevel::Warning));
+    m_viewLevelCombo->addItem("Info+", logLevelBit(LogLevel::Error) | logLevelBit(LogLevel::Warning) |
+                                       logLevelBit(LogLevel::Info));
+    m_viewLevelCombo->addItem("Debug+", ALL_LOG_LEVELS & ~logLevelBit(LogLevel::None) &
+                                        ~logLevelBit(LogLevel::Verbose));
+    connect(m_viewLevelCombo, QOverload<int>::of(&QComboBox::activated),
+            this, &SerialMonitorWidget::onViewFilterChanged);
+    headerLayout->addWidget(m_viewLevelCombo);
+
+    m_tagCombo = new QComboBox(this);
+    m_tagCombo->setToolTip("Show lines with this tag");
+    m_tagCombo->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    connect(m_tagCombo, QOverload<int>::of(&QComboBox::activated),
+            this, &SerialMonitorWidget::onViewFilterChanged);
+    headerLayout->addWidget(m_tagCombo);
+
+    headerLayout->addSpacing(8);
+
     // Connection status indicator
     m_statusIndicator = new QLabel(this);
     m_statusIndicator->setFixedSize(8, 8);
@@ -85,6 +101,61 @@ void SerialMonitorWidget::setupUi()
 
     headerLayout->addSpacing(8);
 
+    // Add another port to watch
+    m_addPortMenu = new QMenu(this);
+    connect(m_addPortMenu, &QMenu::aboutToShow, this, &SerialMonitorWidget::populateAddPortMenu);
+
+    m_addPortButton = new QToolButton(this);
+    m_addPortButton->setText("+");
+    m_addPortButton->setToolTip("Monitor another port");
+    m_addPortButton->setFixedSize(24, 24);
+    m_addPortButton->setAutoRaise(true);
+    m_addPortButton->setMenu(m_addPortMenu);
+    m_addPortButton->setPopupMode(QToolButton::InstantPopup);
+    headerLayout->addWidget(m_addPortButton);
+
+    // Rate for the current tab's port
+    m_baudRateCombo = new QComboBox(this);
+    m_baudRateCombo->setToolTip("Baud rate (Auto detects it, again after each reset)");
+    m_baudRateCombo->addItem("Auto", PortMonitor::AUTO_BAUD);
+    for (int rate : SerialConnection::supportedBaudRates()) {
+        m_baudRateCombo->addItem(QString::number(rate), rate);
+    }
+    connect(m_baudRateCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &SerialMonitorWidget::onBaudRateChanged);
+    headerLayout->addWidget(m_baudRateCombo);
+
+    // Capture-to-disk button
+    m_captureButton = new QPushButton(this);
+    m_captureButton->setText("\u23FA"); // Record symbol
+    m_captureButton->setToolTip("Capture raw output to disk");
+    m_captureButton->setFixedSize(24, 24);
+    m_captureButton->setFlat(true);
+    m_captureButton->setCheckable(true);
+    connect(m_captureButton, &QPushButton::toggled, this, &SerialMonitorWidget::onCaptureToggled);
+    headerLayout->addWidget(m_captureButton);
+
+    // Search button
+    m_searchButton = new QPushButton(this);
+    m_searchButton->setText("\U0001F50D"); // Magnifier
+    m_searchButton->setToolTip("Search history (Ctrl+F)");
+    m_searchButton->setFixedSize(24, 24);
+    m_searchButton->setFlat(true);
+    connect(m_searchButton, &QPushButton::clicked, this, &SerialMonitorWidget::showSearch);
+    headerLayout->addWidget(m_searchButton);
+
+    // Boot timing button
+    m_bootTimingButton = new QPushButton(this);
+    m_bootTimingButton->setText("\u23F1"); // Stopwatch
+    m_bootTimingButton->setToolTip("Boot timing");
+    m_bootTimingButton->setFixedSize(24, 24);
+    m_bootTimingButton->setFlat(true);
+    connect(m_bootTimingButton, &QPushButton::clicked, this, &SerialMonitorWidget::showBootTiming);
+    headerLayout->addWidget(m_bootTimingButton);
+
+    QShortcut* findShortcut = new QShortcut(QKeySequence::Find, this);
+    connect(findShortcut, &QShortcut::activated, this, &SerialMonitorWidget::showSearch);
+
     // Clear button
     m_clearButton = new QPushButton(this);
     m_clearButton->setText("\u2716"); // X mark
@@ -96,155 +167,520 @@ void SerialMonitorWidget::setupUi()
 
     mainLayout->addWidget(headerWidget);
 
-    // Output text area
-    m_outputText = new QTextEdit(this);
-    m_outputText->setReadOnly(true);
-    m_outputText->setFont(QFont("Monospace", 9));
-    m_outputText->setStyleSheet(
+    // Search bar (hidden until needed)
+    m_searchBar = new QWidget(this);
+    QHBoxLayout* searchLayout = new QHBoxLayout(m_searchBar);
+    searchLayout->setContentsMargins(8, 4, 8, 4);
+
+    m_searchEdit = new QLineEdit(this);
+    m_searchEdit->setPlaceholderText("Search history...");
+    m_searchEdit->setClearButtonEnabled(true);
+    connect(m_searchEdit, &QLineEdit::returnPressed, this, &SerialMonitorWidget::runSearch);
+    searchLayout->addWidget(m_searchEdit, 1);
+
+    m_levelFilter = new QComboBox(this);
+    m_levelFilter->addItem("All lines", ALL_LOG_LEVELS);
+    m_levelFilter->addItem("Errors", logLevelBit(LogLevel::Error));
+    m_levelFilter->addItem("Warnings+", logLevelBit(LogLevel::Error) | logLevelBit(LogLevel::Warning));
+    m_levelFilter->addItem("Info+", logLevelBit(LogLevel::Error) | logLevelBit(LogLevel::Warning) |
+                                    logLevelBit(LogLevel::Info));
+    searchLayout->addWidget(m_levelFilter);
+
+    m_regexCheck = new QCheckBox("Regex", this);
+    searchLayout->addWidget(m_regexCheck);
+
+    m_caseCheck = new QCheckBox("Aa", this);
+    m_caseCheck->setToolTip("Match case");
+    searchLayout->addWidget(m_caseCheck);
+
+    m_searchStatus = new QLabel(this);
+    m_searchStatus->setStyleSheet("color: #666666; font-size: 11px;");
+    searchLayout->addWidget(m_searchStatus);
+
+    m_searchBar->setVisible(false);
+    mainLayout->addWidget(m_searchBar);
+
+    // One tab per port, plus every port merged
+    m_tabs = new QTabWidget(this);
+    m_tabs->setDocumentMode(true);
+    m_tabs->setTabsClosable(true);
+
+    m_mergedView = new LogView(m_tabs);
+    m_mergedView->setFont(QFont("Monospace", 9));
+    m_mergedView->setStyleSheet(
         "background-color: white; color: #333333; border: none;"
     );
-    m_outputText->setPlaceholderText("No output yet...");
-
-    mainLayout->addWidget(m_outputText);
+    m_mergedView->setPlaceholderText("No output yet...");
+    m_mergedView->setLineCompleteHandler([this](int64_t lineNumber, const QString& line) {
+        m_mergedScrollback.append(lineNumber, line, PortMonitor::wallClockMs(m_mergedTimestampNs));
+    });
+    m_tabs->addTab(m_mergedView, "All");
+    m_tabs->tabBar()->setTabButton(0, QTabBar::RightSide, nullptr);
+
+    mainLayout->addWidget(m_tabs);
+
+    m_searchResults = new QListWidget(this);
+    m_searchResults->setFont(QFont("Monospace", 9));
+    m_searchResults->setMaximumHeight(160);
+    m_searchResults->setVisible(false);
+    connect(m_searchResults, &QListWidget::itemActivated,
+            this, &SerialMonitorWidget::onSearchResultActivated);
+    mainLayout->addWidget(m_searchResults);
+
+    // Connected last: adding the first tab already changes the current one
+    connect(m_tabs, &QTabWidget::currentChanged, this, &SerialMonitorWidget::onCurrentTabChanged);
+    connect(m_tabs, &QTabWidget::tabCloseRequested, this, &SerialMonitorWidget::onTabCloseRequested);
+    updateCaptureButton();
+    updateBaudRateCombo();
+    updateViewFilter();
 }
 
 void SerialMonitorWidget::setPort(const SerialPort& port)
 {
-    // Disconnect from current port
-    stopReading();
+    PortMonitor* monitor = findPort(port);
 
-    m_currentPort = port;
+    // A port that was only open because the flasher had it selected goes
+    // with the selection, and so does its capture
+    if (m_primary && m_primary != monitor && !m_primary->isPinned()) {
+        removePort(m_primary);
+    }
 
-    // Connect to new port if not flashing
-    if (!m_isFlashing) {
-        connectToPort();
+    if (!monitor) {
+        monitor = addPort(port);
+    } else if (!monitor->isConnected()) {
+        monitor->connectToPort();
+    }
+
+    m_primary = monitor;
+    m_tabs->setCurrentIndex(m_tabs->indexOf(monitor->view()));
+}
+
+void SerialMonitorWidget::setPortManager(SerialPortManager* portManager)
+{
+    if (m_portManager == portManager) {
+        return;
+    }
+    if (m_portManager) {
+        disconnect(m_portManager, nullptr, this, nullptr);
+    }
+
+    m_portManager = portManager;
+    if (m_portManager) {
+        connect(m_portManager, &SerialPortManager::portAdded, this, &SerialMonitorWidget::onPortAdded);
+    }
+}
+
+void SerialMonitorWidget::setFlashingService(FlashingService* flashingService)
+{
+    if (m_flashingService == flashingService) {
+        return;
+    }
+    if (m_flashingService) {
+        disconnect(m_flashingService, nullptr, this, nullptr);
+    }
+
+    m_flashingService = flashingService;
+    if (m_flashingService) {
+        connect(m_flashingService, &FlashingService::deviceRebooted,
+                this, &SerialMonitorWidget::onDeviceRebooted);
     }
 }
 
 void SerialMonitorWidget::onFlashingStarted()
 {
-    m_isFlashing = true;
-    m_wasConnectedBeforeFlash = m_connection && m_connection->isConnected();
+    if (!m_primary) {
+        return;
+    }
 
-    appendText("[Disconnecting for flash...]\n");
-    stopReading();
+    // The flasher runs on our open port rather than closing and reopening
+    // it, so the first boot output after the reset is not missed
+    std::unique_ptr<SerialConnection> connection = m_primary->releaseForFlash();
+    if (connection && m_flashingService) {
+        m_flashingService->adoptConnection(std::move(connection));
+    }
 }
 
 void SerialMonitorWidget::onFlashingFinished()
 {
-    m_isFlashing = false;
+    if (m_primary) {
+        m_primary->resumeAfterFlash(m_flashingService ? m_flashingService->releaseConnection()
+                                                      : nullptr);
+    }
+}
 
-    // Reconnect if we were connected before
-    if (m_wasConnectedBeforeFlash && m_currentPort) {
-        // Wait a bit for the device to restart
-        QTimer::singleShot(1000, this, &SerialMonitorWidget::connectToPort);
+void SerialMonitorWidget::onPortAdded(const SerialPort& port)
+{
+    for (const auto& monitor : m_monitors) {
+        monitor->onPortAdded(port);
     }
 }
 
 void SerialMonitorWidget::clearOutput()
 {
-    m_outputText->clear();
-    m_pendingText.clear();
+    if (PortMonitor* monitor = currentPort()) {
+        monitor->clear();
+    } else {
+        m_mergedView->clear();
+        m_mergedScrollback.clear();
+    }
+    m_searchResults->clear();
+}
+
+void SerialMonitorWidget::onCaptureToggled(bool enabled)
+{
+    PortMonitor* monitor = currentPort();
+    if (monitor) {
+        if (!enabled) {
+            monitor->stopCapture();
+        } else if (!monitor->capture().isRunning()) {
+            monitor->startCapture();
+        }
+    }
+    updateCaptureButton();
+}
+
+void SerialMonitorWidget::showSearch()
+{
+    m_searchBar->setVisible(true);
+    m_searchEdit->setFocus();
 }
 
-void SerialMonitorWidget::connectToPort()
+void SerialMonitorWidget::runSearch()
 {
-    if (!m_currentPort || m_isFlashing) {
+    ScrollbackStore::Query query;
+    query.text = m_searchEdit->text();
+    query.regex = m_regexCheck->isChecked();
+    query.caseSensitive = m_caseCheck->isChecked();
+    query.levels = static_cast<uint8_t>(m_levelFilter->currentData().toUInt());
+
+    if (query.text.isEmpty() && query.levels == ALL_LOG_LEVELS) {
+        m_searchResults->clear();
+        m_searchResults->setVisible(false);
+        m_searchStatus->clear();
         return;
     }
 
-    stopReading();
-    m_reconnectTimer->stop();
+    QElapsedTimer timer;
+    timer.start();
+    ScrollbackStore::SearchResult result = currentScrollback().search(query);
+    qint64 elapsed = timer.elapsed();
 
-    m_connection = std::make_unique<SerialConnection>();
+    if (!result.error.isEmpty()) {
+        m_searchStatus->setText(result.error);
+        return;
+    }
 
-    try {
-        m_connection->open(m_currentPort->path);
-        m_connection->setBaudRate(BaudRate::Baud115200);
+    m_searchResults->clear();
+    for (const auto& match : result.matches) {
+        QString time = QDateTime::fromMSecsSinceEpoch(match.timestampMs).toString("HH:mm:ss.zzz");
+        QListWidgetItem* item = new QListWidgetItem(QString("%1  %2").arg(time, match.text));
+        item->setData(Qt::UserRole, QVariant::fromValue<qint64>(match.lineNumber));
+        m_searchResults->addItem(item);
+    }
+    m_searchResults->setVisible(true);
+    m_searchResults->scrollToBottom();
 
-        appendText(QString("[Connected to %1]\n").arg(m_currentPort->name));
-        updateConnectionStatus(true);
+    m_searchStatus->setText(QString("%1%2 matches, %3 ms")
+                                .arg(result.truncated ? "last " : "")
+                                .arg(result.matches.size())
+                                .arg(elapsed));
+}
 
-        startReading();
-    } catch (const SerialError& e) {
-        appendText(QString("[Connection failed: %1]\n")
-                       .arg(QString::fromStdString(e.what())));
-        updateConnectionStatus(false);
+void SerialMonitorWidget::onSearchResultActivated(QListWidgetItem* item)
+{
+    qint64 lineNumber = item->data(Qt::UserRole).toLongLong();
+    if (!currentView()->revealLine(lineNumber)) {
+        m_searchStatus->setText("Line is older than the visible output");
+    }
+}
 
-        // Start reconnection attempts
-        if (!m_isFlashing) {
-            m_reconnectTimer->start();
+void SerialMonitorWidget::populateAddPortMenu()
+{
+    m_addPortMenu->clear();
+
+    if (m_portManager) {
+        for (const SerialPort& port : m_portManager->availablePorts()) {
+            if (findPort(port)) {
+                continue;
+            }
+            m_addPortMenu->addAction(port.displayName(), this, [this, port]() {
+                PortMonitor* monitor = addPort(port);
+                monitor->setPinned(true);
+                m_tabs->setCurrentIndex(m_tabs->indexOf(monitor->view()));
+            });
         }
     }
+
+    if (m_addPortMenu->isEmpty()) {
+        m_addPortMenu->addAction("No other ports")->setEnabled(false);
+    }
 }
 
-void SerialMonitorWidget::disconnectFromPort()
+void SerialMonitorWidget::onCurrentTabChanged(int index)
 {
-    stopReading();
-    m_reconnectTimer->stop();
+    Q_UNUSED(index);
+
+    // Results belong to the tab they were searched in
+    m_searchResults->clear();
+    m_searchResults->setVisible(false);
+    m_searchStatus->clear();
 
-    if (m_connection) {
-        m_connection->close();
-        m_connection.reset();
+    updateConnectionStatus();
+    updateCaptureButton();
+    updateBaudRateCombo();
+    updateViewFilter();
+}
+
+void SerialMonitorWidget::onTabCloseRequested(int index)
+{
+    // The merged tab and the flasher's port stay
+    QWidget* view = m_tabs->widget(index);
+    for (const auto& monitor : m_monitors) {
+        if (monitor->view() == view && monitor.get() != m_primary) {
+            removePort(monitor.get());
+            return;
+        }
     }
+}
 
-    updateConnectionStatus(false);
+void SerialMonitorWidget::onDeviceRebooted(const SerialPort& port, qint64 timestampNs)
+{
+    // Boot timing runs from the reset itself, not from when output shows
+    // up; freshly flashed firmware is a new test run
+    if (PortMonitor* monitor = findPort(port)) {
+        monitor->markReset(timestampNs, true);
+    }
 }
 
-void SerialMonitorWidget::processIncomingData()
+void SerialMonitorWidget::onFirmwareFlashed(const SerialPort& port, const QString& elfPath)
 {
-    if (!m_connection || !m_connection->isConnected() || m_isFlashing) {
+    PortMonitor* monitor = findPort(port);
+    if (!monitor) {
         return;
     }
 
-    try {
-        QByteArray data = m_connection->read(0.05);
-        if (!data.isEmpty()) {
-            // Try UTF-8 first, fall back to Latin1
-            QString text = QString::fromUtf8(data);
-            if (text.contains(QChar::ReplacementCharacter)) {
-                text = QString::fromLatin1(data);
-            }
-            m_pendingText += text;
+    // Old symbols would name the wrong functions
+    if (elfPath.isEmpty()) {
+        monitor->setSymbolizer(nullptr);
+        return;
+    }
+
+    // The monitor starts building the index off the GUI thread, so it is
+    // usually ready before the first crash; a rebuilt ELF gets a fresh one
+    if (!m_symbolizer || m_symbolizer->elfPath() != elfPath || !m_symbolizer->isCurrent()) {
+        m_symbolizer = std::make_shared<ElfSymbolizer>(elfPath);
+    }
+    monitor->setSymbolizer(m_symbolizer);
+    monitor->appendNote(QString("[Symbols from %1]\n").arg(QFileInfo(elfPath).fileName()));
+}
+
+void SerialMonitorWidget::showBootTiming()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Boot timing");
+    dialog.resize(640, 360);
+
+    QVBoxLayout* layout = new QVBoxLayout(&dialog);
+
+    QPlainTextEdit* report = new QPlainTextEdit(&dialog);
+    report->setReadOnly(true);
+    report->setFont(QFont("Monospace", 9));
+    report->setPlainText(bootTimingReport());
+    layout->addWidget(report);
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch();
+
+    QPushButton* clearButton = new QPushButton("Clear History", &dialog);
+    connect(clearButton, &QPushButton::clicked, &dialog, [this, report]() {
+        for (const auto& monitor : m_monitors) {
+            monitor->bootProfiler().clearHistory();
         }
-    } catch (const SerialError& e) {
-        if (e.type() != SerialError::Timeout) {
-            appendText(QString("[Disconnected: %1]\n")
-                           .arg(QString::fromStdString(e.what())));
-            stopReading();
-            updateConnectionStatus(false);
-
-            // Start reconnection attempts
-            if (!m_isFlashing) {
-                m_reconnectTimer->start();
-            }
+        report->setPlainText(bootTimingReport());
+    });
+    buttonLayout->addWidget(clearButton);
+
+    QPushButton* closeButton = new QPushButton("Close", &dialog);
+    connect(closeButton, &QPushButton::clicked, &dialog, &QDialog::accept);
+    buttonLayout->addWidget(closeButton);
+
+    layout->addLayout(buttonLayout);
+    dialog.exec();
+}
+
+QString SerialMonitorWidget::bootTimingReport() const
+{
+    std::vector<const BootProfiler::Boot*> boots;
+    QStringList perPort;
+
+    for (const auto& monitor : m_monitors) {
+        const auto& history = monitor->bootProfiler().history();
+        for (const BootProfiler::Boot& boot : history) {
+            boots.push_back(&boot);
+        }
+        if (!history.empty()) {
+            perPort << QString("%1: %2 boots, last: %3")
+                           .arg(monitor->tag())
+                           .arg(history.size())
+                           .arg(history.back().summary(monitor->bootProfiler().milestones()));
+        }
+    }
+
+    if (boots.empty()) {
+        return "No boots recorded yet.\n\n"
+               "Boots are timed from each reset the flasher issues, or from the ROM "
+               "banner, to the milestones set in BootProfiler/milestones.";
+    }
+
+    const std::vector<BootProfiler::Milestone> milestones =
+        m_monitors.front()->bootProfiler().milestones();
+
+    QString text = QString("%1 boots on %2 ports (ms)\n\n").arg(boots.size()).arg(perPort.size());
+    text += QString("%1%2%3%4%5%6%7%8\n")
+                .arg("", -16).arg("n", 6).arg("missed", 8).arg("min", 8)
+                .arg("median", 8).arg("p90", 8).arg("max", 8).arg("mean", 8);
+
+    for (const BootProfiler::Stats& stats : BootProfiler::statistics(boots, milestones)) {
+        text += QString("%1%2%3").arg(stats.name.left(15), -16).arg(stats.count, 6).arg(stats.missed, 8);
+        if (stats.count > 0) {
+            text += QString("%1%2%3%4%5")
+                        .arg(std::lround(stats.minMs), 8).arg(std::lround(stats.medianMs), 8)
+                        .arg(std::lround(stats.p90Ms), 8).arg(std::lround(stats.maxMs), 8)
+                        .arg(std::lround(stats.meanMs), 8);
         }
+        text += '\n';
     }
+
+    text += "\n" + perPort.join('\n');
+    return text;
 }
 
-void SerialMonitorWidget::onReconnectTimer()
+void SerialMonitorWidget::drainIncomingData()
 {
-    if (m_isFlashing || !m_currentPort) {
-        m_reconnectTimer->stop();
-        return;
+    // Anything stamped before this point is taken below, give or take the
+    // moment between a read being stamped and it reaching its ring
+    const int64_t drainStart = SerialReader::now();
+
+    for (const auto& monitor : m_monitors) {
+        monitor->drain();
     }
 
-    if (m_connection && m_connection->isConnected()) {
-        m_reconnectTimer->stop();
+    releaseMergedLines(drainStart - MERGE_DELAY_NS);
+    updateLogCounts();
+}
+
+void SerialMonitorWidget::releaseMergedLines(int64_t beforeNs)
+{
+    if (m_mergeQueue.empty()) {
         return;
     }
 
-    appendText("[Attempting to reconnect...]\n");
-    connectToPort();
+    std::sort(m_mergeQueue.begin(), m_mergeQueue.end(),
+              [](const MergedLine& a, const MergedLine& b) {
+                  return a.timestampNs != b.timestampNs ? a.timestampNs < b.timestampNs
+                                                        : a.sequence < b.sequence;
+              });
+
+    auto ready = std::partition_point(m_mergeQueue.begin(), m_mergeQueue.end(),
+                                      [beforeNs](const MergedLine& line) {
+                                          return line.timestampNs < beforeNs;
+                                      });
+
+    // One line at a time so each one is stamped with its own arrival
+    for (auto it = m_mergeQueue.begin(); it != ready; ++it) {
+        m_mergedTimestampNs = it->timestampNs;
+        m_mergedView->appendText(it->text);
+    }
+    m_mergeQueue.erase(m_mergeQueue.begin(), ready);
+}
+
+PortMonitor* SerialMonitorWidget::addPort(const SerialPort& port)
+{
+    auto monitor = std::make_unique<PortMonitor>(port, m_reader, m_tabs);
+    PortMonitor* added = monitor.get();
+
+    // Tag each line with where it came from before it joins the others
+    const QString tag = added->tag();
+    added->setLineHandler([this, tag](int64_t timestampNs, const QString& line) {
+        m_mergeQueue.push_back(MergedLine{
+            timestampNs, m_mergeSequence++, QString("[%1] %2\n").arg(tag, line)});
+    });
+    connect(added, &PortMonitor::connectionChanged, this, &SerialMonitorWidget::updateConnectionStatus);
+    connect(added, &PortMonitor::verdictChanged, this, [this, added]() {
+        updateTabTitle(added);
+    });
+    connect(added, &PortMonitor::nextJobRequested, this, [this, added]() {
+        emit nextJobRequested(added->port());
+    });
+    added->setTriggerEngine(m_triggerEngine);
+    added->setBaudRate(QSettings().value("SerialMonitor/baudRate", 115200).toInt());
+
+    m_monitors.push_back(std::move(monitor));
+    m_tabs->addTab(added->view(), port.displayName());
+
+    added->connectToPort();
+    return added;
+}
+
+void SerialMonitorWidget::removePort(PortMonitor* monitor)
+{
+    if (m_primary == monitor) {
+        m_primary = nullptr;
+    }
+
+    // Deleting the monitor deletes its view, which takes its tab with it
+    auto it = std::find_if(m_monitors.begin(), m_monitors.end(),
+                           [monitor](const auto& entry) { return entry.get() == monitor; });
+    if (it != m_monitors.end()) {
+        m_monitors.erase(it);
+    }
+}
+
+PortMonitor* SerialMonitorWidget::findPort(const SerialPort& port) const
+{
+    // By device, so a board that came back on another node is still found
+    for (const auto& monitor : m_monitors) {
+        if (monitor->port().isSameDevice(port)) {
+            return monitor.get();
+        }
+    }
+    return nullptr;
+}
+
+PortMonitor* SerialMonitorWidget::currentPort() const
+{
+    QWidget* view = m_tabs->currentWidget();
+    for (const auto& monitor : m_monitors) {
+        if (monitor->view() == view) {
+            return monitor.get();
+        }
+    }
+    return nullptr;
+}
+
+LogView* SerialMonitorWidget::currentView() const
+{
+    PortMonitor* monitor = currentPort();
+    return monitor ? monitor->view() : m_mergedView;
 }
 
-void SerialMonitorWidget::appendText(const QString& text)
+ScrollbackStore& SerialMonitorWidget::currentScrollback()
 {
-    m_pendingText += text;
+    PortMonitor* monitor = currentPort();
+    return monitor ? monitor->scrollback() : m_mergedScrollback;
 }
 
-void SerialMonitorWidget::updateConnectionStatus(bool connected)
+void SerialMonitorWidget::updateConnectionStatus()
 {
+    // The merged tab is live while any port is
+    bool connected = false;
+    if (PortMonitor* monitor = currentPort()) {
+        connected = monitor->isConnected();
+    } else {
+        connected = std::any_of(m_monitors.begin(), m_monitors.end(),
+                                [](const auto& monitor) { return monitor->isConnected(); });
+    }
+
     if (connected) {
         m_statusIndicator->setStyleSheet(
             "background-color: #27ae60; border-radius: 4px;"
@@ -256,20 +692,121 @@ void SerialMonitorWidget::updateConnectionStatus(bool connected)
     }
 }
 
-void SerialMonitorWidget::startReading()
+void SerialMonitorWidget::updateTabTitle(PortMonitor* monitor)
+{
+    int index = m_tabs->indexOf(monitor->view());
+    if (index < 0) {
+        return;
+    }
+
+    QString title = monitor->port().displayName();
+    switch (monitor->verdict()) {
+    case PortMonitor::Verdict::Pass:
+        title += " \u2714"; // Check mark
+        break;
+    case PortMonitor::Verdict::Fail:
+        title += " \u2718"; // Ballot X
+        break;
+    case PortMonitor::Verdict::Running:
+        break;
+    }
+    m_tabs->setTabText(index, title);
+}
+
+void SerialMonitorWidget::onBaudRateChanged(int index)
 {
-    if (!m_isReading) {
-        m_isReading = true;
-        m_readTimer->start();
+    PortMonitor* monitor = currentPort();
+    if (!monitor || index < 0) {
+        return;
     }
+
+    const int rate = m_baudRateCombo->itemData(index).toInt();
+    monitor->setBaudRate(rate);
+
+    // Ports opened later start at the last rate picked
+    QSettings().setValue("SerialMonitor/baudRate", rate);
 }
 
-void SerialMonitorWidget::stopReading()
+void SerialMonitorWidget::updateBaudRateCombo()
 {
-    m_isReading = false;
-    m_readTimer->stop();
+    PortMonitor* monitor = currentPort();
 
-    if (m_connection) {
-        m_connection->close();
+    m_baudRateCombo->blockSignals(true);
+    if (monitor) {
+        m_baudRateCombo->setCurrentIndex(m_baudRateCombo->findData(monitor->baudRate()));
     }
+    m_baudRateCombo->blockSignals(false);
+    m_baudRateCombo->setEnabled(monitor != nullptr);
+}
+
+void SerialMonitorWidget::onViewFilterChanged()
+{
+    const uint8_t levels = static_cast<uint8_t>(m_viewLevelCombo->currentData().toUInt());
+    const QString tag = m_tagCombo->currentIndex() > 0 ? m_tagCombo->currentText() : QString();
+    currentView()->setFilter(levels, tag);
+    updateLogCounts();
+}
+
+void SerialMonitorWidget::updateViewFilter()
+{
+    const LogView* view = currentView();
+
+    m_viewLevelCombo->setCurrentIndex(std::max(0, m_viewLevelCombo->findData(view->levelFilter())));
+
+    // Listed again from the new view's tags by updateLogCounts()
+    m_tagCombo->clear();
+    m_tagCombo->addItem("All tags");
+    if (!view->tagFilter().isEmpty()) {
+        m_tagCombo->addItem(view->tagFilter());
+        m_tagCombo->setCurrentIndex(1);
+    }
+    m_listedTags = 0;
+    m_countsLabel->clear();
+    updateLogCounts();
+}
+
+void SerialMonitorWidget::updateLogCounts()
+{
+    const LogView* view = currentView();
+    const LogStats& stats = view->stats();
+
+    // Cleared since the list was made
+    if (stats.tagCount() < m_listedTags) {
+        updateViewFilter();
+        return;
+    }
+
+    // Ids only ever grow, so only new tags need adding; kept sorted by name
+    for (; m_listedTags < stats.tagCount(); ++m_listedTags) {
+        const QString& name = stats.tagName(m_listedTags);
+        if (m_tagCombo->findText(name) >= 0) {
+            continue;
+        }
+        int position = 1;
+        while (position < m_tagCombo->count() && m_tagCombo->itemText(position) < name) {
+            ++position;
+        }
+        m_tagCombo->insertItem(position, name);
+    }
+
+    const int tag = view->tagFilter().isEmpty() ? LogStats::NO_TAG : stats.tagId(view->tagFilter());
+    const QString counts = LogStats::describe(tag == LogStats::NO_TAG ? stats.totals() : stats.tagCounts(tag));
+    if (m_countsLabel->text() != counts) {
+        m_countsLabel->setText(counts);
+    }
+}
+
+void SerialMonitorWidget::updateCaptureButton()
+{
+    // Captures are raw bytes from one device, so there's none for "All"
+    PortMonitor* monitor = currentPort();
+    bool capturing = monitor && monitor->capture().isRunning();
+
+    m_captureButton->blockSignals(true);
+    m_captureButton->setChecked(capturing);
+    m_captureButton->blockSignals(false);
+    m_captureButton->setEnabled(monitor != nullptr);
+    m_captureButton->setToolTip(capturing
+        ? QString("Capturing to %1").arg(monitor->capture().currentFile())
+        : QString("Capture raw output to disk"));
 }
@@ -6,20 +6,33 @@
 #define SERIALMONITORWIDGET_H
 
 #include "models/SerialPort.h"
-#include "serial/SerialConnection.h"
+#include "serial/SerialPortManager.h"
+#include "serial/SerialReader.h"
+#include "services/FlashingService.h"
+#include "services/ScrollbackStore.h"
+#include "ui/LogView.h"
+#include "ui/PortMonitor.h"
 
 #include <QWidget>
-#include <QTextEdit>
 #include <QPushButton>
+#include <QToolButton>
+#include <QMenu>
 #include <QLabel>
-#include <QThread>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QListWidget>
+#include <QTabWidget>
 #include <QTimer>
 #include <memory>
-#include <atomic>
-#include <optional>
+#include <vector>
 
 /**
  * Serial monitor panel for viewing device output
+ *
+ * Follows the port selected for flashing and any number of extra ports
+ * the user adds. Each port has its own tab; the "All" tab merges every
+ * port's lines in arrival order, tagged with the port they came from.
  */
 class SerialMonitorWidget : public QWidget {
     Q_OBJECT
@@ -28,46 +41,132 @@ public:
     explicit SerialMonitorWidget(QWidget* parent = nullptr);
     ~SerialMonitorWidget();
 
+    /**
+     * Source of the ports offered by the add-port menu
+     */
+    void setPortManager(SerialPortManager* portManager);
+
+    /**
+     * Service the flasher's port is handed to while it is flashed
+     */
+    void setFlashingService(FlashingService* flashingService);
+
+signals:
+    /**
+     * A trigger asked for the next job on this port
+     */
+    void nextJobRequested(const SerialPort& port);
+
 public slots:
     void setPort(const SerialPort& port);
     void onFlashingStarted();
     void onFlashingFinished();
 
+    /**
+     * Symbolize crashes on port with the ELF of what was just flashed
+     */
+    void onFirmwareFlashed(const SerialPort& port, const QString& elfPath);
+
 private slots:
     void clearOutput();
-    void connectToPort();
-    void disconnectFromPort();
-    void processIncomingData();
-    void onReconnectTimer();
+    void onCaptureToggled(bool enabled);
+    void onBaudRateChanged(int index);
+    void onViewFilterChanged();
+    void showSearch();
+    void runSearch();
+    void onSearchResultActivated(QListWidgetItem* item);
+    void populateAddPortMenu();
+    void onCurrentTabChanged(int index);
+    void onTabCloseRequested(int index);
+    void onPortAdded(const SerialPort& port);
+    void onDeviceRebooted(const SerialPort& port, qint64 timestampNs);
+    void showBootTiming();
+    void drainIncomingData();
 
 private:
     void setupUi();
-    void appendText(const QString& text);
-    void updateConnectionStatus(bool connected);
-    void startReading();
-    void stopReading();
+    PortMonitor* addPort(const SerialPort& port);
+    void removePort(PortMonitor* monitor);
+    PortMonitor* findPort(const SerialPort& port) const;
+    PortMonitor* currentPort() const;
+    LogView* currentView() const;
+    ScrollbackStore& currentScrollback();
+    void updateConnectionStatus();
+    void updateCaptureButton();
+    void updateBaudRateCombo();
+    void updateViewFilter();
+    void updateLogCounts();
+    void updateTabTitle(PortMonitor* monitor);
+    void releaseMergedLines(int64_t beforeNs);
+    QString bootTimingReport() const;
 
     // UI components
     QLabel* m_titleLabel = nullptr;
     QLabel* m_statusIndicator = nullptr;
+    QToolButton* m_addPortButton = nullptr;
+    QMenu* m_addPortMenu = nullptr;
     QPushButton* m_clearButton = nullptr;
-    QTextEdit* m_outputText = nullptr;
-
-    // Serial connection
-    std::unique_ptr<SerialConnection> m_connection;
-    std::optional<SerialPort> m_currentPort;
-    QThread* m_readThread = nullptr;
-    QTimer* m_readTimer = nullptr;
-    QTimer* m_reconnectTimer = nullptr;
-    std::atomic<bool> m_isReading{false};
-    std::atomic<bool> m_isFlashing{false};
-    bool m_wasConnectedBeforeFlash = false;
-
-    // Buffer for batching updates
-    QString m_pendingText;
-    QTimer* m_updateTimer = nullptr;
-    static constexpr int MAX_OUTPUT_SIZE = 50000;
-    static constexpr int TRIM_TO_SIZE = 40000;
+    QPushButton* m_captureButton = nullptr;
+    QPushButton* m_searchButton = nullptr;
+    QPushButton* m_bootTimingButton = nullptr;
+    QComboBox* m_baudRateCombo = nullptr;
+    QTabWidget* m_tabs = nullptr;
+
+    // Filter and line counts of the current tab's view
+    QLabel* m_countsLabel = nullptr;
+    QComboBox* m_viewLevelCombo = nullptr;
+    QComboBox* m_tagCombo = nullptr;
+    int m_listedTags = 0;
+
+    // Search over the full scrollback of the current tab
+    QWidget* m_searchBar = nullptr;
+    QLineEdit* m_searchEdit = nullptr;
+    QComboBox* m_levelFilter = nullptr;
+    QCheckBox* m_regexCheck = nullptr;
+    QCheckBox* m_caseCheck = nullptr;
+    QLabel* m_searchStatus = nullptr;
+    QListWidget* m_searchResults = nullptr;
+
+    // Every port's lines in arrival order
+    LogView* m_mergedView = nullptr;
+    ScrollbackStore m_mergedScrollback;
+
+    /**
+     * A completed line waiting for the merge
+     */
+    struct MergedLine {
+        int64_t timestampNs;
+        uint64_t sequence;      // Keeps a port's own lines in order on ties
+        QString text;
+    };
+    std::vector<MergedLine> m_mergeQueue;
+    uint64_t m_mergeSequence = 0;
+    int64_t m_mergedTimestampNs = 0;
+
+    // Lines stamped just before a drain can land in a ring just after it;
+    // holding everything this long lets late ones still sort into place
+    static constexpr int64_t MERGE_DELAY_NS = 50LL * 1000 * 1000;
+
+    // One reader thread serves every port; declared before the monitors
+    // so it outlives them
+    SerialReader m_reader;
+    std::vector<std::unique_ptr<PortMonitor>> m_monitors;
+
+    // Triggers are compiled once and shared by every port
+    std::shared_ptr<const TriggerEngine> m_triggerEngine;
+
+    // Boards flashed with the same build share its symbol index
+    std::shared_ptr<ElfSymbolizer> m_symbolizer;
+
+    // The port selected in the flasher; the one that gets flashed
+    PortMonitor* m_primary = nullptr;
+
+    SerialPortManager* m_portManager = nullptr;
+    FlashingService* m_flashingService = nullptr;
+
+    // Moves reader output to the views once per frame
+    QTimer* m_drainTimer = nullptr;
+    static constexpr int FRAME_INTERVAL_MS = 16;
 };
 
 #endif // SERIALMONITORWIDGET_H